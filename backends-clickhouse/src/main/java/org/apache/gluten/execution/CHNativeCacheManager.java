@@ -32,6 +32,13 @@ public class CHNativeCacheManager {
 
   private static native CacheResult nativeGetCacheStatus(String jobId);
 
+  /** Cancels the tasks of a cache job that have not started yet. Returns false if unknown. */
+  public static boolean cancelCache(String jobId) {
+    return nativeCancelCache(jobId);
+  }
+
+  private static native boolean nativeCancelCache(String jobId);
+
   public static native String nativeCacheFiles(byte[] files);
 
   // only for ut
@@ -22,7 +22,8 @@ public class CacheResult implements Serializable {
   public enum Status {
     RUNNING(0),
     SUCCESS(1),
-    ERROR(2);
+    ERROR(2),
+    CANCELLED(3);
 
     private final int value;
 
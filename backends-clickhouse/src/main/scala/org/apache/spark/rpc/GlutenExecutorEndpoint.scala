@@ -65,6 +65,11 @@ class GlutenExecutorEndpoint(val executorId: String, val conf: SparkConf)
           resource_id => CHBroadcastBuildSideCache.invalidateBroadcastHashtable(resource_id))
       }
 
+    case GlutenCacheLoadCancel(jobId) =>
+      if (!CHNativeCacheManager.cancelCache(jobId)) {
+        logWarning(s"Cache job $jobId not found on executor $executorId, nothing to cancel.")
+      }
+
     case e =>
       logError(s"Received unexpected message. $e")
   }
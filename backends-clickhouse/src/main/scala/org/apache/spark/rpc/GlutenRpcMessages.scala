@@ -44,6 +44,8 @@ object GlutenRpcMessages {
 
   case class GlutenCacheLoadStatus(jobId: String)
 
+  case class GlutenCacheLoadCancel(jobId: String) extends GlutenRpcMessage
+
   case class CacheJobInfo(status: Boolean, jobId: String, reason: String = "")
     extends GlutenRpcMessage
 
@@ -21,7 +21,7 @@ import org.apache.gluten.execution.CacheResult
 import org.apache.gluten.execution.CacheResult.Status
 
 import org.apache.spark.rpc.GlutenDriverEndpoint
-import org.apache.spark.rpc.GlutenRpcMessages.{CacheJobInfo, GlutenCacheLoadStatus}
+import org.apache.spark.rpc.GlutenRpcMessages._
 import org.apache.spark.sql.Row
 import org.apache.spark.util.ThreadUtils
 
@@ -56,33 +56,47 @@ object GlutenCacheBase {
 
   def waitAllJobFinish(
       jobs: ArrayBuffer[(String, CacheJobInfo)],
-      ask: (String, String) => Future[CacheResult]): (Boolean, String) = {
+      ask: (String, String) => Future[CacheResult],
+      cancel: (String, String) => Unit = (_, _) => ()): (Boolean, String) = {
     val res = collectJobTriggerResult(jobs)
     var status = res._1
     val messages = res._2
-    jobs.foreach(
-      job => {
-        if (status) {
-          var complete = false
-          while (!complete) {
-            Thread.sleep(5000)
-            val future_result = ask(job._1, job._2.jobId)
-            val result = ThreadUtils.awaitResult(future_result, Duration.Inf)
-            result.getStatus match {
-              case Status.ERROR =>
-                status = false
-                messages.append(
-                  s"executor : ${job._1}, failed with message: ${result.getMessage};"
-                )
-                complete = true
-              case Status.SUCCESS =>
-                complete = true
-              case _ =>
-              // still running
+    try {
+      jobs.foreach(
+        job => {
+          if (status) {
+            var complete = false
+            while (!complete) {
+              Thread.sleep(5000)
+              val future_result = ask(job._1, job._2.jobId)
+              val result = ThreadUtils.awaitResult(future_result, Duration.Inf)
+              result.getStatus match {
+                case Status.ERROR =>
+                  status = false
+                  messages.append(
+                    s"executor : ${job._1}, failed with message: ${result.getMessage};"
+                  )
+                  complete = true
+                case Status.CANCELLED =>
+                  status = false
+                  messages.append(
+                    s"executor : ${job._1}, cancelled with message: ${result.getMessage};"
+                  )
+                  complete = true
+                case Status.SUCCESS =>
+                  complete = true
+                case _ =>
+                // still running
+              }
             }
           }
-        }
-      })
+        })
+    } catch {
+      case e: InterruptedException =>
+        // the caller gave up, don't leave the warmup running on the executors
+        jobs.filter(_._2.status).foreach(job => cancel(job._1, job._2.jobId))
+        throw e
+    }
     (status, messages.mkString(";"))
   }
 
@@ -121,7 +135,14 @@ object GlutenCacheBase {
               .ask[CacheResult](GlutenCacheLoadStatus(jobId))
           }
         }
-      val res = waitAllJobFinish(resultList, fetchStatus)
+      val cancelJob: (String, String) => Unit =
+        (executorId: String, jobId: String) => {
+          val data = GlutenDriverEndpoint.executorDataMap.get(toExecutorId(executorId))
+          if (data != null) {
+            data.executorEndpointRef.send(GlutenCacheLoadCancel(jobId))
+          }
+        }
+      val res = waitAllJobFinish(resultList, fetchStatus, cancelJob)
       Seq(Row(res._1, res._2))
     }
   }
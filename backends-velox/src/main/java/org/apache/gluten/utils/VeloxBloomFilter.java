@@ -17,9 +17,11 @@
 package org.apache.gluten.utils;
 
 import org.apache.gluten.backendsapi.BackendsApiManager;
+import org.apache.gluten.columnarbatch.ColumnarBatches;
 import org.apache.gluten.runtime.Runtimes;
 
 import org.apache.commons.io.IOUtils;
+import org.apache.spark.sql.vectorized.ColumnarBatch;
 import org.apache.spark.util.sketch.BloomFilter;
 import org.apache.spark.util.sketch.IncompatibleMergeException;
 
@@ -99,6 +101,23 @@ public class VeloxBloomFilter extends BloomFilter {
     return true;
   }
 
+  public void putLongs(long[] items) {
+    jni.insertLongs(handle, items);
+  }
+
+  /** Puts the non-null values of an integral column of a native batch, in one JNI call. */
+  public void putColumn(ColumnarBatch batch, int columnIndex) {
+    jni.insertColumn(
+        handle,
+        ColumnarBatches.getNativeHandle(BackendsApiManager.getBackendName(), batch),
+        columnIndex);
+  }
+
+  /** Merges serialized Velox bloom-filters of the same size into this one, in one JNI call. */
+  public void mergeAllSerialized(byte[][] serializedFilters) {
+    jni.mergeAllSerialized(handle, serializedFilters);
+  }
+
   @Override
   public boolean putBinary(byte[] item) {
     throw new UnsupportedOperationException("Not yet implemented");
@@ -145,6 +164,17 @@ public class VeloxBloomFilter extends BloomFilter {
     return jni.mightContainLong(handle, item);
   }
 
+  /**
+   * Probes an integral column of a native batch, returns one bit per row (row i is bit i % 64 of
+   * word i / 64) which is set if the row might be contained. Null rows are never contained.
+   */
+  public long[] mightContainColumn(ColumnarBatch batch, int columnIndex) {
+    return jni.mightContainColumn(
+        handle,
+        ColumnarBatches.getNativeHandle(BackendsApiManager.getBackendName(), batch),
+        columnIndex);
+  }
+
   @Override
   public boolean mightContainBinary(byte[] item) {
     throw new UnsupportedOperationException("Not yet implemented");
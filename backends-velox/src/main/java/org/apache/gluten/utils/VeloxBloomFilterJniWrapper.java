@@ -46,4 +46,17 @@ public class VeloxBloomFilterJniWrapper implements RuntimeAware {
   public native void mergeFrom(long handle, long other);
 
   public native byte[] serialize(long handle);
+
+  public native void insertLongs(long handle, long[] items);
+
+  /** Inserts the non-null values of an integral column of the native batch. */
+  public native void insertColumn(long handle, long batchHandle, int columnIndex);
+
+  /**
+   * Probes an integral column of the native batch, returns one bit per row which is set if the row
+   * might be contained.
+   */
+  public native long[] mightContainColumn(long handle, long batchHandle, int columnIndex);
+
+  public native void mergeAllSerialized(long handle, byte[][] serializedFilters);
 }
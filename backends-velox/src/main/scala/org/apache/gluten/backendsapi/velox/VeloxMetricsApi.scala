@@ -309,6 +309,10 @@ class VeloxMetricsApi extends MetricsApi with Logging {
       "decompressTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "time to decompress"),
       "deserializeTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "time to deserialize"),
       "shuffleWallTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "shuffle wall time"),
+      "writeBatchTimeP99" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "p99 time to write a batch per task"),
+      "writeBatchTimeMax" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "max time to write a batch per task"),
       // For hash shuffle writer, the peak bytes represents the maximum split buffer size.
       // For sort shuffle writer, the peak bytes represents the maximum
       // row buffer + sort buffer size.
@@ -20,6 +20,7 @@ import org.apache.gluten.GlutenConfig
 import org.apache.gluten.backendsapi.BackendsApiManager
 import org.apache.gluten.columnarbatch.ColumnarBatches
 import org.apache.gluten.memory.memtarget.{MemoryTarget, Spiller, Spillers}
+import org.apache.gluten.metrics.RegistryMetrics
 import org.apache.gluten.runtime.Runtimes
 import org.apache.gluten.vectorized._
 
@@ -214,6 +215,12 @@ class ColumnarShuffleWriter[K, V](
     dep.metrics("dataSize").add(splitResult.getRawPartitionLengths.sum)
     dep.metrics("compressTime").add(splitResult.getTotalCompressTime)
     dep.metrics("peakBytes").add(splitResult.getPeakBytes)
+    // Per task latency distribution of the batches, the SQL metric shows its spread across tasks.
+    Option(RegistryMetrics.fetch(runtime).histogram("shuffle.write.batch_nanos")).foreach {
+      histogram =>
+        dep.metrics("writeBatchTimeP99").add(histogram.percentile(99))
+        dep.metrics("writeBatchTimeMax").add(histogram.max())
+    }
     writeMetrics.incBytesWritten(splitResult.getTotalBytesWritten)
     writeMetrics.incWriteTime(splitResult.getTotalWriteTime + splitResult.getTotalSpillTime)
     taskContext.taskMetrics().incMemoryBytesSpilled(splitResult.getBytesToEvict)
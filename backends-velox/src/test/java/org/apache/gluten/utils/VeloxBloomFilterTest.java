@@ -16,8 +16,13 @@
  */
 package org.apache.gluten.utils;
 
+import org.apache.gluten.columnarbatch.ColumnarBatches;
+import org.apache.gluten.memory.arrow.alloc.ArrowBufferAllocators;
 import org.apache.gluten.test.VeloxBackendTestBase;
+import org.apache.gluten.vectorized.ArrowWritableColumnVector;
 
+import org.apache.spark.sql.types.StructType;
+import org.apache.spark.sql.vectorized.ColumnarBatch;
 import org.apache.spark.task.TaskResources$;
 import org.apache.spark.util.sketch.BloomFilter;
 import org.apache.spark.util.sketch.IncompatibleMergeException;
@@ -154,6 +159,129 @@ public class VeloxBloomFilterTest extends VeloxBackendTestBase {
         });
   }
 
+  @Test
+  public void testBulkInsertAndMerge() {
+    TaskResources$.MODULE$.runUnsafe(
+        () -> {
+          final VeloxBloomFilter filter1 = VeloxBloomFilter.empty(10000);
+          final long[] items1 = new long[1000];
+          for (int i = 0; i < items1.length; i++) {
+            items1[i] = i;
+          }
+          filter1.putLongs(items1);
+
+          final VeloxBloomFilter filter2 = VeloxBloomFilter.empty(10000);
+          final long[] items2 = new long[1000];
+          for (int i = 0; i < items2.length; i++) {
+            items2[i] = 1000 + i;
+          }
+          filter2.putLongs(items2);
+
+          final VeloxBloomFilter merged = VeloxBloomFilter.empty(10000);
+          merged.mergeAllSerialized(new byte[][] {filter1.serialize(), filter2.serialize()});
+          for (int i = 0; i < 2000; i++) {
+            Assert.assertTrue(merged.mightContainLong(i));
+          }
+
+          // Check false positives.
+          checkFalsePositives(merged, 2000);
+          return null;
+        });
+  }
+
+  @Test
+  public void testColumnInsertAndProbe() {
+    TaskResources$.MODULE$.runUnsafe(
+        () -> {
+          // Not a multiple of 64, the last word of the selection bitmap is partial.
+          final int numRows = 150;
+          final ColumnarBatch batch = newIntegralBatch(numRows);
+          try {
+            for (int column = 0; column < 4; column++) {
+              // Every width is widened to long like the items of Spark's bloom filters.
+              final VeloxBloomFilter filter = VeloxBloomFilter.empty(10000);
+              filter.putColumn(batch, column);
+              for (int i = 0; i < numRows; i++) {
+                if (isNull(i)) {
+                  // The slots of the null rows hold values inserted nowhere else.
+                  Assert.assertFalse(filter.mightContainLong(nullSlotValue(i)));
+                } else {
+                  Assert.assertTrue(filter.mightContainLong(value(i)));
+                }
+              }
+
+              final long[] selection = filter.mightContainColumn(batch, column);
+              Assert.assertEquals((numRows + 63) / 64, selection.length);
+              for (int i = 0; i < numRows; i++) {
+                Assert.assertEquals(
+                    "row " + i + " of column " + column, !isNull(i), isSelected(selection, i));
+              }
+              for (int i = numRows; i < selection.length * 64; i++) {
+                Assert.assertFalse(isSelected(selection, i));
+              }
+
+              // Probe a filter holding every other value, row i is bit i % 64 of word i / 64.
+              final VeloxBloomFilter half = VeloxBloomFilter.empty(10000);
+              for (int i = 0; i < numRows; i += 2) {
+                half.putLong(value(i));
+              }
+              final long[] halfSelection = half.mightContainColumn(batch, column);
+              for (int i = 0; i < numRows; i++) {
+                Assert.assertEquals(
+                    "row " + i + " of column " + column,
+                    !isNull(i) && half.mightContainLong(value(i)),
+                    isSelected(halfSelection, i));
+              }
+            }
+          } finally {
+            batch.close();
+          }
+          return null;
+        });
+  }
+
+  private static boolean isNull(int row) {
+    return row % 7 == 3;
+  }
+
+  /** Values of the non-null rows, negative ones included, they fit in every integral width. */
+  private static long value(int row) {
+    return row - 75;
+  }
+
+  private static long nullSlotValue(int row) {
+    return 100 + row % 20;
+  }
+
+  private static boolean isSelected(long[] selection, int row) {
+    return (selection[row / 64] & (1L << (row % 64))) != 0;
+  }
+
+  /** A native batch of tinyint, smallint, int and bigint columns which all hold the same values. */
+  private static ColumnarBatch newIntegralBatch(int numRows) {
+    final ArrowWritableColumnVector[] columns =
+        ArrowWritableColumnVector.allocateColumns(
+            numRows, StructType.fromDDL("a tinyint, b smallint, c int, d bigint"));
+    for (int i = 0; i < numRows; i++) {
+      final long value = isNull(i) ? nullSlotValue(i) : value(i);
+      columns[0].putByte(i, (byte) value);
+      columns[1].putShort(i, (short) value);
+      columns[2].putInt(i, (int) value);
+      columns[3].putLong(i, value);
+      if (isNull(i)) {
+        for (ArrowWritableColumnVector column : columns) {
+          column.putNull(i);
+        }
+      }
+    }
+    for (ArrowWritableColumnVector column : columns) {
+      column.setValueCount(numRows);
+    }
+    final ColumnarBatch batch = new ColumnarBatch(columns);
+    batch.setNumRows(numRows);
+    return ColumnarBatches.offload(ArrowBufferAllocators.contextInstance(), batch);
+  }
+
   private static void checkFalsePositives(BloomFilter filter, int start) {
     final int attemptStart = start;
     final int attemptCount = 5000000;
@@ -27,6 +27,7 @@
 #include <Common/assert_cast.h>
 
 
+#include <AggregateFunctions/SplitBlockBloomFilter.h>
 #include <IO/ReadHelpers.h>
 #include <Interpreters/BloomFilter.h>
 
@@ -41,11 +42,44 @@ using namespace DB;
 
 struct AggregateFunctionGroupBloomFilterData
 {
+    /// The serialized state stores the hash count right after the size. A classic filter always uses at least one hash,
+    /// so a zero hash count marks a split block filter and states written before it existed are still readable.
+    static constexpr UInt64 SPLIT_BLOCK_HASHES = 0;
+
     bool initted = false;
+    bool split_block = false;
     // small default value because BloomFilter has no default ctor
     BloomFilter bloom_filter = BloomFilter(100, 2, 0);
+    SplitBlockBloomFilter split_block_filter;
     static const char * name() { return "groupBloomFilter"; }
 
+    void init(size_t filter_size, size_t filter_hashes, size_t seed, bool split_block_)
+    {
+        split_block = split_block_;
+        if (split_block)
+            split_block_filter = SplitBlockBloomFilter(filter_size, seed);
+        else
+            bloom_filter = BloomFilter(BloomFilterParameters(filter_size, filter_hashes, seed));
+        initted = true;
+    }
+
+    template <typename T>
+    void add(T x)
+    {
+        if (split_block)
+            split_block_filter.add(static_cast<UInt64>(x));
+        else
+            bloom_filter.add(reinterpret_cast<const char *>(&x), sizeof(T));
+    }
+
+    template <typename T>
+    bool find(T x)
+    {
+        if (split_block)
+            return split_block_filter.find(static_cast<UInt64>(x));
+        return bloom_filter.find(reinterpret_cast<const char *>(&x), sizeof(T));
+    }
+
     void read(DB::ReadBuffer & in)
     {
         UInt64 filter_size, filter_hashes, seed = 0;
@@ -56,12 +90,17 @@ struct AggregateFunctionGroupBloomFilterData
         {
             initted = false;
         }
+        else if (filter_hashes == SPLIT_BLOCK_HASHES)
+        {
+            init(filter_size, filter_hashes, seed, true);
+            auto & v = split_block_filter.getFilter();
+            in.readStrict(reinterpret_cast<char *>(v.data()), v.size() * sizeof(v[0]));
+        }
         else
         {
-            bloom_filter = BloomFilter(BloomFilterParameters(filter_size, filter_hashes, seed));
+            init(filter_size, filter_hashes, seed, false);
             auto & v = bloom_filter.getFilter();
             in.readStrict(reinterpret_cast<char *>(v.data()), v.size() * sizeof(v[0]));
-            initted = true;
         }
     }
 
@@ -69,6 +108,15 @@ struct AggregateFunctionGroupBloomFilterData
     {
         if likely (initted)
         {
+            if (split_block)
+            {
+                writeVarUInt(split_block_filter.getSizeInBytes(), out);
+                writeVarUInt(SPLIT_BLOCK_HASHES, out);
+                writeVarUInt(split_block_filter.getSeed(), out);
+                const auto & v = split_block_filter.getFilter();
+                out.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(v[0]));
+                return;
+            }
             writeVarUInt(bloom_filter.getSize(), out);
             writeVarUInt(bloom_filter.getHashes(), out);
             writeVarUInt(bloom_filter.getSeed(), out);
@@ -93,11 +141,17 @@ class AggregateFunctionGroupBloomFilter final : public IAggregateFunctionDataHel
 {
 public:
     explicit AggregateFunctionGroupBloomFilter(
-        const DataTypes & argument_types_, const Array & parameters_, size_t filter_size_, size_t filter_hashes_, size_t seed_)
+        const DataTypes & argument_types_,
+        const Array & parameters_,
+        size_t filter_size_,
+        size_t filter_hashes_,
+        size_t seed_,
+        bool split_block_)
         : IAggregateFunctionDataHelper<Data, AggregateFunctionGroupBloomFilter<T, Data>>(argument_types_, parameters_, createResultType())
         , filter_size(filter_size_)
         , filter_hashes(filter_hashes_)
         , seed(seed_)
+        , split_block(split_block_)
     {
     }
 
@@ -120,12 +174,11 @@ public:
         if unlikely (!this->data(place).initted)
         {
             checkFilterSize(filter_size);
-            this->data(place).bloom_filter = BloomFilter(BloomFilterParameters(filter_size, filter_hashes, seed));
-            this->data(place).initted = true;
+            this->data(place).init(filter_size, filter_hashes, seed, split_block);
         }
 
         T x = assert_cast<const ColumnVector<T> &>(*columns[0]).getData()[row_num];
-        this->data(place).bloom_filter.add(reinterpret_cast<const char *>(&x), sizeof(T));
+        this->data(place).add(x);
     }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs, Arena *) const override
@@ -135,16 +188,29 @@ public:
         {
             return;
         }
-        const auto & bloom_other = this->data(rhs).bloom_filter;
+        const auto & other = this->data(rhs);
+        auto & self = this->data(place);
+        if (other.split_block)
+        {
+            if (!self.initted)
+                self.init(other.split_block_filter.getSizeInBytes(), 0, other.split_block_filter.getSeed(), true);
+            else if (!self.split_block)
+                throw Exception(ErrorCodes::BAD_ARGUMENTS, "Cannot merge a split block bloom filter into a classic one");
+            self.split_block_filter.merge(other.split_block_filter);
+            return;
+        }
+
+        const auto & bloom_other = other.bloom_filter;
         const auto & filter_other = bloom_other.getFilter();
-        if (!this->data(place).initted)
+        if (!self.initted)
         {
             // We use filter_other's size/hashes/seed to avoid passing these parameters around to construct AggregateFunctionGroupBloomFilter.
             checkFilterSize(bloom_other.getSize());
-            this->data(place).bloom_filter = BloomFilter(BloomFilterParameters(bloom_other.getSize(), bloom_other.getHashes(), bloom_other.getSeed()));
-            this->data(place).initted = true;
+            self.init(bloom_other.getSize(), bloom_other.getHashes(), bloom_other.getSeed(), false);
         }
-        auto & filter_self = this->data(place).bloom_filter.getFilter();
+        else if (self.split_block)
+            throw Exception(ErrorCodes::BAD_ARGUMENTS, "Cannot merge a classic bloom filter into a split block one");
+        auto & filter_self = self.bloom_filter.getFilter();
         for (size_t i = 0; i < filter_other.size(); ++i)
         {
             if (filter_other[i])
@@ -173,6 +239,7 @@ private:
     size_t filter_size;
     size_t filter_hashes;
     size_t seed;
+    bool split_block;
 };
 
 }
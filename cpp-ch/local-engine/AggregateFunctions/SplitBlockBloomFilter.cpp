@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SplitBlockBloomFilter.h"
+
+#include <algorithm>
+#include <Common/Exception.h>
+#include <Common/TargetSpecific.h>
+
+#if USE_MULTITARGET_CODE
+#include <immintrin.h>
+#endif
+
+namespace DB::ErrorCodes
+{
+extern const int BAD_ARGUMENTS;
+}
+
+namespace local_engine
+{
+namespace
+{
+/// Number of keys whose blocks are prefetched before they are probed. Large filters do not fit in cache, so
+/// overlapping the misses of a batch is worth more than the probe itself.
+constexpr size_t PROBE_BATCH_SIZE = 64;
+
+void findManyScalar(const SplitBlockBloomFilter & filter, const UInt64 * keys, size_t size, UInt8 * out)
+{
+    for (size_t i = 0; i < size; ++i)
+        out[i] = filter.find(keys[i]);
+}
+}
+
+DECLARE_AVX2_SPECIFIC_CODE(
+
+    inline __m256i blockMask(UInt64 hash) {
+        const __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(SplitBlockBloomFilter::SALT));
+        const __m256i lane_key = _mm256_set1_epi32(static_cast<Int32>(static_cast<UInt32>(hash)));
+        const __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(lane_key, salt), 27);
+        return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+    }
+
+    inline void findMany(const UInt32 * words, size_t num_blocks, UInt64 seed, const UInt64 * keys, size_t size, UInt8 * out) {
+        UInt64 hashes[PROBE_BATCH_SIZE];
+        for (size_t begin = 0; begin < size; begin += PROBE_BATCH_SIZE)
+        {
+            const size_t batch = std::min(PROBE_BATCH_SIZE, size - begin);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                hashes[i] = SplitBlockBloomFilter::hashKey(keys[begin + i], seed);
+                __builtin_prefetch(
+                    words + SplitBlockBloomFilter::blockIndex(hashes[i], num_blocks) * SplitBlockBloomFilter::WORDS_PER_BLOCK);
+            }
+            for (size_t i = 0; i < batch; ++i)
+            {
+                const UInt32 * block
+                    = words + SplitBlockBloomFilter::blockIndex(hashes[i], num_blocks) * SplitBlockBloomFilter::WORDS_PER_BLOCK;
+                const __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+                /// testc returns 1 when every bit of the mask is also set in the block.
+                out[begin + i] = static_cast<UInt8>(_mm256_testc_si256(bits, blockMask(hashes[i])));
+            }
+        }
+    }
+
+)
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(size_t size_in_bytes, UInt64 seed_)
+    : num_blocks(std::max<size_t>(1, (size_in_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK))
+    , seed(seed_)
+    , words(num_blocks * WORDS_PER_BLOCK, 0)
+{
+}
+
+void SplitBlockBloomFilter::findMany(const UInt64 * keys, size_t size, UInt8 * out) const
+{
+#if USE_MULTITARGET_CODE
+    if (DB::isArchSupported(DB::TargetArch::AVX2))
+    {
+        TargetSpecific::AVX2::findMany(words.data(), num_blocks, seed, keys, size, out);
+        return;
+    }
+#endif
+    findManyScalar(*this, keys, size, out);
+}
+
+void SplitBlockBloomFilter::merge(const SplitBlockBloomFilter & other)
+{
+    if (num_blocks != other.num_blocks || seed != other.seed)
+        throw DB::Exception(
+            DB::ErrorCodes::BAD_ARGUMENTS,
+            "Cannot merge split block bloom filters of different shapes: {} blocks with seed {} and {} blocks with seed {}",
+            num_blocks,
+            seed,
+            other.num_blocks,
+            other.seed);
+    for (size_t i = 0; i < words.size(); ++i)
+        words[i] |= other.words[i];
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+#include <base/types.h>
+#include <Common/HashTable/Hash.h>
+
+namespace local_engine
+{
+/// Split block bloom filter, the layout used by parquet (SBBF) and by Velox runtime filters.
+/// The filter is an array of 256 bit blocks, each made of 8 UInt32 lanes. A key picks one block with the high 32 bits
+/// of its hash and sets exactly one bit per lane, derived from the low 32 bits multiplied by a per lane salt. Every
+/// probe therefore touches a single cache line, and all 8 lanes are checked by one AVX2 mask test.
+/// Only integer keys are supported, they are hashed with intHash64.
+class SplitBlockBloomFilter
+{
+public:
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+    static constexpr size_t BYTES_PER_BLOCK = WORDS_PER_BLOCK * sizeof(UInt32);
+    static constexpr UInt32 SALT[WORDS_PER_BLOCK]
+        = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    SplitBlockBloomFilter() = default;
+    /// size_in_bytes is rounded up to whole blocks.
+    SplitBlockBloomFilter(size_t size_in_bytes, UInt64 seed_);
+
+    static UInt64 hashKey(UInt64 key, UInt64 seed) { return intHash64(key ^ seed); }
+
+    static size_t blockIndex(UInt64 hash, size_t num_blocks) { return ((hash >> 32) * num_blocks) >> 32; }
+
+    void add(UInt64 key)
+    {
+        const UInt64 hash = hashKey(key, seed);
+        UInt32 * block = words.data() + blockIndex(hash, num_blocks) * WORDS_PER_BLOCK;
+        const auto lane_key = static_cast<UInt32>(hash);
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+            block[i] |= 1U << ((lane_key * SALT[i]) >> 27);
+    }
+
+    bool find(UInt64 key) const
+    {
+        const UInt64 hash = hashKey(key, seed);
+        const UInt32 * block = words.data() + blockIndex(hash, num_blocks) * WORDS_PER_BLOCK;
+        const auto lane_key = static_cast<UInt32>(hash);
+        UInt32 missing = 0;
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+        {
+            const UInt32 mask = 1U << ((lane_key * SALT[i]) >> 27);
+            missing |= ~block[i] & mask;
+        }
+        return missing == 0;
+    }
+
+    /// Probes size keys and writes 1 or 0 into out for each of them. Uses AVX2 when the CPU supports it and
+    /// prefetches the blocks of a batch of keys before probing them.
+    void findMany(const UInt64 * keys, size_t size, UInt8 * out) const;
+
+    /// ORs another filter of the same size and seed into this one.
+    void merge(const SplitBlockBloomFilter & other);
+
+    size_t getSizeInBytes() const { return num_blocks * BYTES_PER_BLOCK; }
+    UInt64 getSeed() const { return seed; }
+    std::vector<UInt32> & getFilter() { return words; }
+    const std::vector<UInt32> & getFilter() const { return words; }
+
+private:
+    size_t num_blocks = 0;
+    UInt64 seed = 0;
+    std::vector<UInt32> words;
+};
+
+}
@@ -59,6 +59,7 @@
 #include <Storages/Cache/CacheManager.h>
 #include <Storages/MergeTree/StorageMergeTreeFactory.h>
 #include <Storages/Output/WriteBufferBuilder.h>
+#include <Storages/Parquet/ParquetMetadataCache.h>
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -987,6 +988,9 @@ void BackendInitializerUtil::initBackend(const SparkConfigs::ConfigMap & spark_c
 
     // Init the table metadata cache map
     StorageMergeTreeFactory::init_cache_map();
+#if USE_PARQUET
+    ParquetMetadataCache::instance().initialize(ParquetConfig::loadFromContext(QueryContext::globalContext()).metadata_cache_max_bytes);
+#endif
 
     JobScheduler::initialize(QueryContext::globalContext());
     CacheManager::initialize(QueryContext::globalMutableContext());
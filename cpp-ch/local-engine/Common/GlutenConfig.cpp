@@ -61,6 +61,14 @@ MemoryConfig MemoryConfig::loadFromContext(const DB::ContextPtr & context)
     return config;
 }
 
+SortShuffleConfig SortShuffleConfig::loadFromContext(const DB::ContextPtr & context)
+{
+    SortShuffleConfig config;
+    config.sort_shuffle_evict_threads = context->getConfigRef().getUInt64(SORT_SHUFFLE_EVICT_THREADS, 1);
+    config.sort_shuffle_evict_window_bytes = context->getConfigRef().getUInt64(SORT_SHUFFLE_EVICT_WINDOW_BYTES, 64_MiB);
+    return config;
+}
+
 GraceMergingAggregateConfig GraceMergingAggregateConfig::loadFromContext(const DB::ContextPtr & context)
 {
     GraceMergingAggregateConfig config;
@@ -74,6 +82,10 @@ GraceMergingAggregateConfig GraceMergingAggregateConfig::loadFromContext(const D
     config.max_allowed_memory_usage_ratio_for_aggregate_merging
         = context->getConfigRef().getDouble(MAX_ALLOWED_MEMORY_USAGE_RATIO_FOR_AGGREGATE_MERGING, 0.9);
     config.enable_spill_test = context->getConfigRef().getBool(ENABLE_SPILL_TEST, false);
+    config.enable_async_spill = context->getConfigRef().getBool(ENABLE_ASYNC_SPILL, false);
+    config.enable_spill_prefetch = context->getConfigRef().getBool(ENABLE_SPILL_PREFETCH, false);
+    config.max_spill_prefetch_bytes = context->getConfigRef().getUInt64(MAX_SPILL_PREFETCH_BYTES, 64_MiB);
+    config.enable_adaptive_buckets = context->getConfigRef().getBool(ENABLE_ADAPTIVE_BUCKETS, false);
     return config;
 }
 
@@ -87,6 +99,9 @@ StreamingAggregateConfig StreamingAggregateConfig::loadFromContext(const DB::Con
     config.high_cardinality_threshold_for_streaming_aggregating
         = context->getConfigRef().getDouble(HIGH_CARDINALITY_THRESHOLD_FOR_STREAMING_AGGREGATING, 0.8);
     config.enable_streaming_aggregating = context->getConfigRef().getBool(ENABLE_STREAMING_AGGREGATING, true);
+    config.enable_partial_aggregation_bypass = context->getConfigRef().getBool(ENABLE_PARTIAL_AGGREGATION_BYPASS, false);
+    config.partial_aggregation_bypass_min_rows = context->getConfigRef().getUInt64(PARTIAL_AGGREGATION_BYPASS_MIN_ROWS, 100000);
+    config.partial_aggregation_bypass_min_ratio = context->getConfigRef().getDouble(PARTIAL_AGGREGATION_BYPASS_MIN_RATIO, 0.9);
     return config;
 }
 
@@ -96,6 +111,13 @@ JoinConfig JoinConfig::loadFromContext(const DB::ContextPtr & context)
     config.prefer_multi_join_on_clauses = context->getConfigRef().getBool(PREFER_MULTI_JOIN_ON_CLAUSES, true);
     config.multi_join_on_clauses_build_side_rows_limit
         = context->getConfigRef().getUInt64(MULTI_JOIN_ON_CLAUSES_BUILD_SIDE_ROWS_LIMIT, 10000000);
+    config.broadcast_build_max_bytes_in_memory = context->getConfigRef().getUInt64(BROADCAST_BUILD_MAX_BYTES_IN_MEMORY, 0);
+    config.broadcast_build_spill_buckets = std::max<size_t>(1, context->getConfigRef().getUInt64(BROADCAST_BUILD_SPILL_BUCKETS, 16));
+    config.broadcast_build_max_bytes_per_executor = context->getConfigRef().getUInt64(BROADCAST_BUILD_MAX_BYTES_PER_EXECUTOR, 0);
+    config.broadcast_build_threads = context->getConfigRef().getUInt64(BROADCAST_BUILD_THREADS, 4);
+    config.bloom_filter_split_block = context->getConfigRef().getBool(BLOOM_FILTER_SPLIT_BLOCK, false);
+    config.enable_runtime_join_filter = context->getConfigRef().getBool(ENABLE_RUNTIME_JOIN_FILTER, false);
+    config.runtime_join_bloom_filter_max_rows = context->getConfigRef().getUInt64(RUNTIME_JOIN_BLOOM_FILTER_MAX_ROWS, 1000000);
     return config;
 }
 
@@ -104,6 +126,17 @@ ExecutorConfig ExecutorConfig::loadFromContext(const DB::ContextPtr & context)
     ExecutorConfig config;
     config.dump_pipeline = context->getConfigRef().getBool(DUMP_PIPELINE, false);
     config.use_local_format = context->getConfigRef().getBool(USE_LOCAL_FORMAT, false);
+    config.file_source_open_ahead_files = context->getConfigRef().getUInt64(FILE_SOURCE_OPEN_AHEAD_FILES, 0);
+    config.max_partition_writers = context->getConfigRef().getUInt64(MAX_PARTITION_WRITERS, 0);
+    config.max_partition_writer_pending_bytes = context->getConfigRef().getUInt64(MAX_PARTITION_WRITER_PENDING_BYTES, 64_MiB);
+    config.bzip2_max_decompression_threads = context->getConfigRef().getUInt64(BZIP2_MAX_DECOMPRESSION_THREADS, 0);
+    return config;
+}
+
+ParquetConfig ParquetConfig::loadFromContext(const DB::ContextPtr & context)
+{
+    ParquetConfig config;
+    config.metadata_cache_max_bytes = context->getConfigRef().getUInt64(METADATA_CACHE_MAX_BYTES, 0);
     return config;
 }
 
@@ -128,18 +161,22 @@ MergeTreeConfig MergeTreeConfig::loadFromContext(const DB::ContextPtr & context)
     MergeTreeConfig config;
     config.table_part_metadata_cache_max_count = context->getConfigRef().getUInt64(TABLE_PART_METADATA_CACHE_MAX_COUNT, 5000);
     config.table_metadata_cache_max_count = context->getConfigRef().getUInt64(TABLE_METADATA_CACHE_MAX_COUNT, 500);
+    config.table_part_loading_threads = context->getConfigRef().getUInt64(TABLE_PART_LOADING_THREADS, 16);
     return config;
 }
 GlutenJobSchedulerConfig GlutenJobSchedulerConfig::loadFromContext(const DB::ContextPtr & context)
 {
     GlutenJobSchedulerConfig config;
     config.job_scheduler_max_threads = context->getConfigRef().getUInt64(JOB_SCHEDULER_MAX_THREADS, 10);
+    config.job_scheduler_max_tasks_per_job = context->getConfigRef().getUInt64(JOB_SCHEDULER_MAX_TASKS_PER_JOB, 0);
+    config.job_scheduler_max_bytes_per_second = context->getConfigRef().getUInt64(JOB_SCHEDULER_MAX_BYTES_PER_SECOND, 0);
     return config;
 }
 MergeTreeCacheConfig MergeTreeCacheConfig::loadFromContext(const DB::ContextPtr & context)
 {
     MergeTreeCacheConfig config;
     config.enable_data_prefetch = context->getConfigRef().getBool(ENABLE_DATA_PREFETCH, config.enable_data_prefetch);
+    config.data_prefetch_threads = context->getConfigRef().getUInt64(DATA_PREFETCH_THREADS, config.data_prefetch_threads);
     return config;
 }
 
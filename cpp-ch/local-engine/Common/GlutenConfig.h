@@ -52,6 +52,22 @@ struct MemoryConfig
     static MemoryConfig loadFromContext(const DB::ContextPtr & context);
 };
 
+struct SortShuffleConfig
+{
+    /// Number of threads used to serialize and compress the partitions of the sort based shuffle writer when
+    /// evicting. 1 means evicting in the writer thread.
+    inline static const String SORT_SHUFFLE_EVICT_THREADS = "sort_shuffle_evict_threads";
+
+    /// Max accumulated bytes of the partitions being serialized by the evict threads at the same time, which bounds the
+    /// compressed data held in memory before it's written. A single partition larger than it is still serialized as a whole.
+    inline static const String SORT_SHUFFLE_EVICT_WINDOW_BYTES = "sort_shuffle_evict_window_bytes";
+
+    size_t sort_shuffle_evict_threads = 1;
+    size_t sort_shuffle_evict_window_bytes = 64_MiB;
+
+    static SortShuffleConfig loadFromContext(const DB::ContextPtr & context);
+};
+
 struct GraceMergingAggregateConfig
 {
     inline static const String MAX_GRACE_AGGREGATE_MERGING_BUCKETS = "max_grace_aggregate_merging_buckets";
@@ -63,6 +79,15 @@ struct GraceMergingAggregateConfig
     inline static const String MAX_ALLOWED_MEMORY_USAGE_RATIO_FOR_AGGREGATE_MERGING
         = "max_allowed_memory_usage_ratio_for_aggregate_merging";
     inline static const String ENABLE_SPILL_TEST = "enable_grace_aggregate_spill_test";
+    /// Write spilled buckets into disk in background threads.
+    inline static const String ENABLE_ASYNC_SPILL = "enable_grace_aggregate_async_spill";
+    /// Read ahead the spilled data of the next bucket while the current bucket is being merged. At most
+    /// max_grace_aggregate_spill_prefetch_bytes are kept in memory.
+    inline static const String ENABLE_SPILL_PREFETCH = "enable_grace_aggregate_spill_prefetch";
+    inline static const String MAX_SPILL_PREFETCH_BYTES = "max_grace_aggregate_spill_prefetch_bytes";
+    /// Estimate the number of distinct keys of the input, and extend the buckets to the estimated number directly
+    /// on memory overflow, instead of doubling them and rehashing the data variants several times.
+    inline static const String ENABLE_ADAPTIVE_BUCKETS = "enable_grace_aggregate_adaptive_buckets";
 
     size_t max_grace_aggregate_merging_buckets = 32;
     bool throw_on_overflow_grace_aggregate_merging_buckets = false;
@@ -70,6 +95,10 @@ struct GraceMergingAggregateConfig
     size_t max_pending_flush_blocks_per_grace_aggregate_merging_bucket = 1_MiB;
     double max_allowed_memory_usage_ratio_for_aggregate_merging = 0.9;
     bool enable_spill_test = false;
+    bool enable_async_spill = false;
+    bool enable_spill_prefetch = false;
+    size_t max_spill_prefetch_bytes = 64_MiB;
+    bool enable_adaptive_buckets = false;
 
     static GraceMergingAggregateConfig loadFromContext(const DB::ContextPtr & context);
 };
@@ -81,11 +110,20 @@ struct StreamingAggregateConfig
     inline static const String HIGH_CARDINALITY_THRESHOLD_FOR_STREAMING_AGGREGATING
         = "high_cardinality_threshold_for_streaming_aggregating";
     inline static const String ENABLE_STREAMING_AGGREGATING = "enable_streaming_aggregating";
+    /// Like spark's adaptive partial aggregation skipping. Once at least partial_aggregation_bypass_min_rows rows are
+    /// aggregated and the keys number is over partial_aggregation_bypass_min_ratio of the rows, the partial aggregation
+    /// is reducing few rows. Then the input rows are converted into intermediate states directly without hashing.
+    inline static const String ENABLE_PARTIAL_AGGREGATION_BYPASS = "enable_partial_aggregation_bypass";
+    inline static const String PARTIAL_AGGREGATION_BYPASS_MIN_ROWS = "partial_aggregation_bypass_min_rows";
+    inline static const String PARTIAL_AGGREGATION_BYPASS_MIN_RATIO = "partial_aggregation_bypass_min_ratio";
 
     size_t aggregated_keys_before_streaming_aggregating_evict = 1024;
     double max_memory_usage_ratio_for_streaming_aggregating = 0.9;
     double high_cardinality_threshold_for_streaming_aggregating = 0.8;
     bool enable_streaming_aggregating = true;
+    bool enable_partial_aggregation_bypass = false;
+    size_t partial_aggregation_bypass_min_rows = 100000;
+    double partial_aggregation_bypass_min_ratio = 0.9;
 
     static StreamingAggregateConfig loadFromContext(const DB::ContextPtr & context);
 };
@@ -98,9 +136,39 @@ struct JoinConfig
     /// Only hash join supports multi join on clauses, the right table cannot be too large. If the row number of right
     /// table is larger then this limit, this transform will not work.
     inline static const String MULTI_JOIN_ON_CLAUSES_BUILD_SIDE_ROWS_LIMIT = "multi_join_on_clauses_build_side_row_limit";
+    /// If the broadcast build side is larger than this limit, it is spilled into local disk instead of being built
+    /// into one in-memory hash table. It is partitioned by the join keys into buckets once, which all the tasks join
+    /// one bucket at a time. 0 means never spill.
+    inline static const String BROADCAST_BUILD_MAX_BYTES_IN_MEMORY = "broadcast_build_max_bytes_in_memory";
+    /// Number of buckets a spilled broadcast build side is partitioned into. Each task holds the hash table of one
+    /// bucket at a time.
+    inline static const String BROADCAST_BUILD_SPILL_BUCKETS = "broadcast_build_spill_buckets";
+    /// Limit of the memory held by all broadcast hash tables of one executor. A build side which would exceed it is
+    /// spilled like one exceeding broadcast_build_max_bytes_in_memory. 0 means no limit.
+    inline static const String BROADCAST_BUILD_MAX_BYTES_PER_EXECUTOR = "broadcast_build_max_bytes_per_executor";
+    /// Number of threads used to prepare the broadcast build side blocks before inserting them into the hash table.
+    inline static const String BROADCAST_BUILD_THREADS = "broadcast_build_threads";
+    /// Build the runtime filters of bloom_filter_agg as split block bloom filters. They are probed with one cache line
+    /// access and one SIMD test per row instead of one random access per hash function, at the cost of a slightly
+    /// higher false positive rate for the same size. Only the backend itself reads the serialized filter.
+    inline static const String BLOOM_FILTER_SPLIT_BLOCK = "bloom_filter_split_block";
+    /// For inner and left semi broadcast joins, filter the probe side by the min/max of the build side keys before the
+    /// join. The filter is pushed down into the scans, which skip granules, row groups and rows out of the range.
+    /// Disabled by default, computing the filters adds a pass over the build side of every broadcast join.
+    inline static const String ENABLE_RUNTIME_JOIN_FILTER = "enable_runtime_join_filter";
+    /// If the build side has at most this many rows, a bloom filter of its integer keys is added to the runtime join
+    /// filter. 0 disables the bloom filter.
+    inline static const String RUNTIME_JOIN_BLOOM_FILTER_MAX_ROWS = "runtime_join_bloom_filter_max_rows";
 
     bool prefer_multi_join_on_clauses = true;
     size_t multi_join_on_clauses_build_side_rows_limit = 10000000;
+    size_t broadcast_build_max_bytes_in_memory = 0;
+    size_t broadcast_build_spill_buckets = 16;
+    size_t broadcast_build_max_bytes_per_executor = 0;
+    size_t broadcast_build_threads = 4;
+    bool bloom_filter_split_block = false;
+    bool enable_runtime_join_filter = false;
+    size_t runtime_join_bloom_filter_max_rows = 1000000;
 
     static JoinConfig loadFromContext(const DB::ContextPtr & context);
 };
@@ -109,13 +177,39 @@ struct ExecutorConfig
 {
     inline static const String DUMP_PIPELINE = "dump_pipeline";
     inline static const String USE_LOCAL_FORMAT = "use_local_format";
+    /// How many of the next files of a split are opened in the background while the current one is being read,
+    /// 0 disables it. Opening covers the read buffer and the footer, the rows are still decoded by the pipeline.
+    inline static const String FILE_SOURCE_OPEN_AHEAD_FILES = "file_source_open_ahead_files";
+    /// Max writers a dynamic partitioned write keeps open at the same time, 0 means unlimited. Rows of the partitions
+    /// beyond the limit are grouped by partition and written one partition after another at the end of the task.
+    inline static const String MAX_PARTITION_WRITERS = "max_partition_writers";
+    /// Max bytes of the grouped rows kept in memory until the end of the task, 0 means unlimited. Beyond it the rows
+    /// are spilled to disk as runs sorted by partition, which are merged when the grouped partitions are written.
+    inline static const String MAX_PARTITION_WRITER_PENDING_BYTES = "max_partition_writer_pending_bytes";
+    /// Max bzip2 blocks of a split decoded at the same time, 0 or 1 decodes them one by one in the reading thread.
+    inline static const String BZIP2_MAX_DECOMPRESSION_THREADS = "bzip2_max_decompression_threads";
 
     bool dump_pipeline = false;
     bool use_local_format = false;
+    size_t file_source_open_ahead_files = 0;
+    size_t max_partition_writers = 0;
+    size_t max_partition_writer_pending_bytes = 64_MiB;
+    size_t bzip2_max_decompression_threads = 0;
 
     static ExecutorConfig loadFromContext(const DB::ContextPtr & context);
 };
 
+struct ParquetConfig
+{
+    /// Max bytes of the executor wide cache of parquet footers, 0 disables the cache. Only the files with known size
+    /// and modification time are cached.
+    inline static const String METADATA_CACHE_MAX_BYTES = "parquet.metadata_cache_max_bytes";
+
+    size_t metadata_cache_max_bytes = 0;
+
+    static ParquetConfig loadFromContext(const DB::ContextPtr & context);
+};
+
 struct S3Config
 {
     inline static const String S3_LOCAL_CACHE_ENABLE = "s3.local_cache.enabled";
@@ -135,9 +229,12 @@ struct MergeTreeConfig
 {
     inline static const String TABLE_PART_METADATA_CACHE_MAX_COUNT = "table_part_metadata_cache_max_count";
     inline static const String TABLE_METADATA_CACHE_MAX_COUNT = "table_metadata_cache_max_count";
+    /// Max number of parts of one table whose metadata is fetched and loaded concurrently. 1 loads them one by one.
+    inline static const String TABLE_PART_LOADING_THREADS = "table_part_loading_threads";
 
     size_t table_part_metadata_cache_max_count = 5000;
     size_t table_metadata_cache_max_count = 500;
+    size_t table_part_loading_threads = 16;
 
     static MergeTreeConfig loadFromContext(const DB::ContextPtr & context);
 };
@@ -145,8 +242,16 @@ struct MergeTreeConfig
 struct GlutenJobSchedulerConfig
 {
     inline static const String JOB_SCHEDULER_MAX_THREADS = "job_scheduler_max_threads";
+    /// Max number of tasks of one job running at the same time, so that one large job leaves threads to the others.
+    /// 0 means a job may use all the threads.
+    inline static const String JOB_SCHEDULER_MAX_TASKS_PER_JOB = "job_scheduler_max_tasks_per_job";
+    /// Max remote read bandwidth of one cache job in bytes per second, so that warming caches does not take the
+    /// network from running queries. 0 means unlimited.
+    inline static const String JOB_SCHEDULER_MAX_BYTES_PER_SECOND = "job_scheduler_max_bytes_per_second";
 
     size_t job_scheduler_max_threads = 10;
+    size_t job_scheduler_max_tasks_per_job = 0;
+    size_t job_scheduler_max_bytes_per_second = 0;
 
     static GlutenJobSchedulerConfig loadFromContext(const DB::ContextPtr & context);
 };
@@ -154,8 +259,11 @@ struct GlutenJobSchedulerConfig
 struct MergeTreeCacheConfig
 {
     inline static const String ENABLE_DATA_PREFETCH = "enable_data_prefetch";
+    /// Max number of column files of one part fetched at the same time by the data prefetch.
+    inline static const String DATA_PREFETCH_THREADS = "data_prefetch_threads";
 
     bool enable_data_prefetch = true;
+    size_t data_prefetch_threads = 16;
 
     static MergeTreeCacheConfig loadFromContext(const DB::ContextPtr & context);
 };
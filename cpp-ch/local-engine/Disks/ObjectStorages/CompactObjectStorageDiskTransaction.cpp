@@ -58,6 +58,29 @@ void TemporaryWriteBufferWrapper::nextImpl()
     BufferBase::set(data_buffer->buffer().begin(), data_buffer->buffer().size(), data_buffer->offset());
 }
 
+StreamingWriteBufferWrapper::StreamingWriteBufferWrapper(const String & file_name_, DB::WriteBuffer & out_, size_t buf_size)
+    : WriteBufferFromFileBase(buf_size, nullptr, 0), file_name(file_name_), out(out_)
+{
+}
+
+void StreamingWriteBufferWrapper::nextImpl()
+{
+    if (offset())
+        out.write(working_buffer.begin(), offset());
+}
+
+void StreamingWriteBufferWrapper::finalizeImpl()
+{
+    next();
+}
+
+CompactObjectStorageDiskTransaction::~CompactObjectStorageDiskTransaction()
+{
+    /// The part was not committed, drop the partially uploaded data file.
+    if (data_write_buffer)
+        data_write_buffer->cancel();
+}
+
 void CompactObjectStorageDiskTransaction::commit()
 {
     auto metadata_tx = disk.getMetadataStorage()->createTransaction();
@@ -65,18 +88,19 @@ void CompactObjectStorageDiskTransaction::commit()
     std::filesystem::path meta_path = std::filesystem::path(prefix_path) / PART_META_FILE_NAME;
 
     auto object_storage = disk.getObjectStorage();
-    auto data_key = object_storage->generateObjectKeyForPath(data_path, std::nullopt);
+    if (!data_key)
+        data_key = object_storage->generateObjectKeyForPath(data_path, std::nullopt);
     auto meta_key = object_storage->generateObjectKeyForPath(meta_path, std::nullopt);
 
     disk.createDirectories(prefix_path);
-    auto data_write_buffer = object_storage->writeObject(DB::StoredObject(data_key.serialize(), data_path), DB::WriteMode::Rewrite);
+    if (!data_write_buffer)
+        data_write_buffer = object_storage->writeObject(DB::StoredObject(data_key->serialize(), data_path), DB::WriteMode::Rewrite);
     auto meta_write_buffer = object_storage->writeObject(DB::StoredObject(meta_key.serialize(), meta_path), DB::WriteMode::Rewrite);
     String buffer;
     buffer.resize(1024 * 1024);
 
-    auto merge_files = [&](std::ranges::input_range auto && list, DB::WriteBuffer & out, const DB::ObjectStorageKey & key , const String &local_path)
+    auto merge_files = [&](std::ranges::input_range auto && list, DB::WriteBuffer & out, const DB::ObjectStorageKey & key , const String &local_path, size_t offset)
     {
-        size_t offset = 0;
         std::ranges::for_each(
             list,
             [&](auto & item)
@@ -102,18 +126,31 @@ void CompactObjectStorageDiskTransaction::commit()
         out.finalize();
     };
 
-    merge_files(files | std::ranges::views::filter([](auto file) { return !isMetaDataFile(file.first); }), *data_write_buffer, data_key, data_path);
-    merge_files(files | std::ranges::views::filter([](auto file) { return isMetaDataFile(file.first); }), *meta_write_buffer, meta_key, meta_path);
+    /// The streamed file is already at the beginning of the data object, the buffered ones follow it.
+    size_t streamed_size = 0;
+    if (!streamed_file.empty())
+    {
+        streamed_size = data_write_buffer->count();
+        DB::DiskObjectStorageMetadata metadata(object_storage->getCommonKeyPrefix(), streamed_file);
+        metadata.addObject(*data_key, 0, streamed_size);
+        metadata_tx->writeStringToFile(streamed_file, metadata.serializeToString());
+    }
+
+    merge_files(files | std::ranges::views::filter([](auto file) { return !isMetaDataFile(file.first); }), *data_write_buffer, *data_key, data_path, streamed_size);
+    merge_files(files | std::ranges::views::filter([](auto file) { return isMetaDataFile(file.first); }), *meta_write_buffer, meta_key, meta_path, 0);
 
     metadata_tx->commit();
     files.clear();
+    data_write_buffer.reset();
+    data_key.reset();
+    streamed_file.clear();
 }
 
 std::unique_ptr<DB::WriteBufferFromFileBase> CompactObjectStorageDiskTransaction::writeFile(
     const std::string & path,
     size_t buf_size,
     DB::WriteMode mode,
-    const DB::WriteSettings &,
+    const DB::WriteSettings & settings,
     bool)
 {
     if (mode != DB::WriteMode::Rewrite)
@@ -128,13 +165,26 @@ std::unique_ptr<DB::WriteBufferFromFileBase> CompactObjectStorageDiskTransaction
             "Don't support write file in different dirs, path {}, prefix path: {}",
             path,
             prefix_path);
-    auto tmp = std::make_shared<DB::TemporaryDataBuffer>(tmp_data.get());
-    files.emplace_back(path, tmp);
     auto tx = disk.getMetadataStorage()->createTransaction();
     tx->createDirectoryRecursive(std::filesystem::path(path).parent_path());
     tx->createEmptyMetadataFile(path);
     tx->commit();
 
+    /// A compact part has a single data file. Stream it (or the first column of a wide part) to the object store
+    /// right away instead of spooling it to the temporary data first.
+    if (!isMetaDataFile(path) && !data_write_buffer)
+    {
+        std::filesystem::path data_path = std::filesystem::path(prefix_path) / PART_DATA_FILE_NAME;
+        auto object_storage = disk.getObjectStorage();
+        data_key = object_storage->generateObjectKeyForPath(data_path, std::nullopt);
+        data_write_buffer = object_storage->writeObject(
+            DB::StoredObject(data_key->serialize(), data_path), DB::WriteMode::Rewrite, std::nullopt, DBMS_DEFAULT_BUFFER_SIZE, settings);
+        streamed_file = path;
+        return std::make_unique<StreamingWriteBufferWrapper>(path, *data_write_buffer, buf_size);
+    }
+
+    auto tmp = std::make_shared<DB::TemporaryDataBuffer>(tmp_data.get());
+    files.emplace_back(path, tmp);
     return std::make_unique<TemporaryWriteBufferWrapper>(path, tmp);
 }
 }
\ No newline at end of file
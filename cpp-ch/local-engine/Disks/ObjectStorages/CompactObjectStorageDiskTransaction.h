@@ -59,6 +59,27 @@ private:
     std::shared_ptr<DB::TemporaryDataBuffer> data_buffer;
 };
 
+/// Forwards one data file of the part directly into the object of the compacted data file, so that its upload
+/// (multipart for S3) runs while the part is still being written. Other files are appended after it on commit.
+class StreamingWriteBufferWrapper : public DB::WriteBufferFromFileBase
+{
+public:
+    StreamingWriteBufferWrapper(const String & file_name_, DB::WriteBuffer & out_, size_t buf_size);
+
+    void sync() override { next(); }
+
+    std::string getFileName() const override { return file_name; }
+
+protected:
+    void finalizeImpl() override;
+
+private:
+    void nextImpl() override;
+
+    String file_name;
+    DB::WriteBuffer & out;
+};
+
 class CompactObjectStorageDiskTransaction: public DB::IDiskTransaction {
     public:
     static inline const String PART_DATA_FILE_NAME = "part_data.gluten";
@@ -69,6 +90,8 @@ class CompactObjectStorageDiskTransaction: public DB::IDiskTransaction {
     {
     }
 
+    ~CompactObjectStorageDiskTransaction() override;
+
     void commit() override;
 
     void undo() override
@@ -199,6 +222,10 @@ private:
     DB::TemporaryDataOnDiskScopePtr tmp_data;
     std::vector<std::pair<String, std::shared_ptr<DB::TemporaryDataBuffer>>> files;
     String prefix_path = "";
+    /// Object of the compacted data file, opened by the first data file which is streamed into it.
+    std::unique_ptr<DB::WriteBufferFromFileBase> data_write_buffer;
+    std::optional<DB::ObjectStorageKey> data_key;
+    String streamed_file;
 };
 }
 
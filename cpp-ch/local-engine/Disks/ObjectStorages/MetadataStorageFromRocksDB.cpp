@@ -22,6 +22,8 @@
 #include <Interpreters/Context.h>
 #include <Storages/MergeTree/MetaDataHelper.h>
 #include <rocksdb/db.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
 #include <Common/QueryContext.h>
 
 namespace local_engine
@@ -58,6 +60,18 @@ MetadataStorageFromRocksDB::MetadataStorageFromRocksDB(
 {
     rocksdb::Options options;
     options.create_if_missing = true;
+    /// Most lookups are existence checks of part files and directories, a good part of them for keys which are not
+    /// there yet. Whole key bloom filters, in the SST files and in the memtable, answer those without reading data
+    /// blocks. Keys are paths of any depth, so there is no fixed prefix to build prefix filters on, scans are bounded
+    /// by iterate_upper_bound instead.
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
+    table_options.whole_key_filtering = true;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+    options.memtable_whole_key_filtering = true;
+    options.memtable_prefix_bloom_size_ratio = 0.1;
     throwRockDBErrorNotOk(rocksdb::DB::Open(options, rocksdb_dir, &rocksdb));
     metadata_clean_task = QueryContext::globalContext()->getSchedulePool().createTask(
         "MetadataStorageFromRocksDB", [this] { cleanOutdatedMetadataThreadFunc(); });
@@ -179,6 +193,21 @@ std::string MetadataStorageFromRocksDB::readFileToString(const std::string & pat
     return getData(getRocksDB(), path);
 }
 
+std::vector<std::optional<std::string>> MetadataStorageFromRocksDB::tryReadFilesToString(const std::vector<std::string> & paths) const
+{
+    return tryGetData(getRocksDB(), paths);
+}
+
+std::vector<bool> MetadataStorageFromRocksDB::existsDirectories(const std::vector<std::string> & paths) const
+{
+    auto data = tryGetData(getRocksDB(), paths);
+    std::vector<bool> result;
+    result.reserve(data.size());
+    for (const auto & value : data)
+        result.push_back(value && *value == RocksDBCreateDirectoryOperation::DIR_DATA);
+    return result;
+}
+
 void MetadataStorageFromRocksDB::shutdown()
 {
     metadata_clean_task->deactivate();
@@ -208,7 +237,7 @@ void MetadataStorageFromRocksDB::cleanOutdatedMetadataThreadFunc()
             getRocksDB().Delete({}, files.back());
         }
     };
-    auto * it = getRocksDB().NewIterator({});
+    std::unique_ptr<rocksdb::Iterator> it(getRocksDB().NewIterator({}));
     String prev_key;
     String prev_data;
     for (it->SeekToFirst(); it->Valid(); it->Next())
@@ -254,6 +283,7 @@ rocksdb::DB & MetadataStorageFromRocksDB::getRocksDB() const
 
 void MetadataStorageFromRocksDBTransaction::commit()
 {
+    addOperation(std::make_unique<RocksDBWriteBatchOperation>(metadata_storage.getRocksDB(), batch));
     commitImpl(metadata_storage.getMetadataMutex());
 }
 
@@ -280,37 +310,37 @@ void MetadataStorageFromRocksDBTransaction::createMetadataFile(const std::string
 
     auto data = metadata->serializeToString();
     if (!data.empty())
-        addOperation(std::make_unique<RocksDBWriteFileOperation>(path, metadata_storage.getRocksDB(), data));
+        addOperation(std::make_unique<RocksDBWriteFileOperation>(path, batch, data));
 }
 
 void MetadataStorageFromRocksDBTransaction::writeStringToFile(const std::string & path, const std::string & data)
 {
-    addOperation(std::make_unique<RocksDBWriteFileOperation>(path, metadata_storage.getRocksDB(), data));
+    addOperation(std::make_unique<RocksDBWriteFileOperation>(path, batch, data));
 }
 
 void MetadataStorageFromRocksDBTransaction::createDirectory(const std::string & path)
 {
-    addOperation(std::make_unique<RocksDBCreateDirectoryOperation>(path, metadata_storage.getRocksDB()));
+    addOperation(std::make_unique<RocksDBCreateDirectoryOperation>(path, metadata_storage.getRocksDB(), batch));
 }
 
 void MetadataStorageFromRocksDBTransaction::createDirectoryRecursive(const std::string & path)
 {
-    addOperation(std::make_unique<RocksDBCreateDirectoryRecursiveOperation>(path, metadata_storage.getRocksDB()));
+    addOperation(std::make_unique<RocksDBCreateDirectoryRecursiveOperation>(path, metadata_storage.getRocksDB(), batch));
 }
 
 void MetadataStorageFromRocksDBTransaction::removeDirectory(const std::string & path)
 {
-    addOperation(std::make_unique<RocksDBRemoveDirectoryOperation>(path, metadata_storage.getRocksDB()));
+    addOperation(std::make_unique<RocksDBRemoveDirectoryOperation>(path, metadata_storage.getRocksDB(), batch));
 }
 
 void MetadataStorageFromRocksDBTransaction::removeRecursive(const std::string & path)
 {
-    addOperation(std::make_unique<RocksDBRemoveRecursiveOperation>(path, metadata_storage.getRocksDB()));
+    addOperation(std::make_unique<RocksDBRemoveRecursiveOperation>(path, metadata_storage.getRocksDB(), batch));
 }
 
 void MetadataStorageFromRocksDBTransaction::unlinkFile(const std::string & path)
 {
-    addOperation(std::make_unique<RocksDBUnlinkFileOperation>(path, metadata_storage.getRocksDB()));
+    addOperation(std::make_unique<RocksDBUnlinkFileOperation>(path, metadata_storage.getRocksDB(), batch));
 }
 }
 #endif
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <Disks/ObjectStorages/IMetadataStorage.h>
 #include <Disks/ObjectStorages/MetadataOperationsHolder.h>
 #include <rocksdb/db.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
 #include <shared_mutex>
 
 namespace local_engine
@@ -55,6 +56,10 @@ public:
     DB::DiskObjectStorageMetadataPtr readMetadataUnlocked(const std::string & path, std::unique_lock<DB::SharedMutex> & lock) const;
     DB::DiskObjectStorageMetadataPtr readMetadataUnlocked(const std::string & path, std::shared_lock<DB::SharedMutex> & lock) const;
     std::string readFileToString(const std::string & path) const override;
+    /// Reads many metadata files with one MultiGet, a missing file gives std::nullopt.
+    std::vector<std::optional<std::string>> tryReadFilesToString(const std::vector<std::string> & paths) const;
+    /// Existence of many directories, e.g. the parts of a table, with one MultiGet.
+    std::vector<bool> existsDirectories(const std::vector<std::string> & paths) const;
     void shutdown() override;
     void cleanOutdatedMetadataThreadFunc();
 
@@ -76,7 +81,10 @@ private:
 class MetadataStorageFromRocksDBTransaction final : public DB::IMetadataTransaction, private DB::MetadataOperationsHolder
 {
 public:
-    MetadataStorageFromRocksDBTransaction(const MetadataStorageFromRocksDB & metadata_storage_) : metadata_storage(metadata_storage_) { }
+    MetadataStorageFromRocksDBTransaction(const MetadataStorageFromRocksDB & metadata_storage_)
+        : metadata_storage(metadata_storage_), batch(rocksdb::BytewiseComparator(), 0, /* overwrite_key */ true)
+    {
+    }
 
     void commit() override;
     const DB::IMetadataStorage & getStorageForNonTransactionalReads() const override;
@@ -93,6 +101,8 @@ public:
 
 private:
     const MetadataStorageFromRocksDB & metadata_storage;
+    /// All the writes of the transaction, applied to the db at once on commit.
+    rocksdb::WriteBatchWithIndex batch;
 };
 }
 #endif
@@ -14,6 +14,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+
 #include <config.h>
 #if USE_ROCKSDB
 #include "MetadataStorageFromRocksDBTransactionOperations.h"
@@ -31,6 +32,59 @@ extern const int INVALID_STATE;
 namespace local_engine
 {
 
+namespace
+{
+/// The smallest key greater than every key starting with prefix, empty if there is none.
+String prefixUpperBound(const String & prefix)
+{
+    String bound = prefix;
+    while (!bound.empty())
+    {
+        if (static_cast<unsigned char>(bound.back()) != 0xff)
+        {
+            ++bound.back();
+            return bound;
+        }
+        bound.pop_back();
+    }
+    return bound;
+}
+
+/// Calls f for every key starting with prefix. The scan stops at the upper bound of the prefix, so it never touches
+/// blocks past it. With a batch, its pending writes are visible as well.
+template <typename F>
+void forEachKeyWithPrefix(rocksdb::DB & db, rocksdb::WriteBatchWithIndex * batch, const String & prefix, F && f)
+{
+    const String upper_bound = prefixUpperBound(prefix);
+    rocksdb::Slice upper_bound_slice(upper_bound);
+    rocksdb::ReadOptions read_options;
+    if (!upper_bound.empty())
+        read_options.iterate_upper_bound = &upper_bound_slice;
+
+    std::unique_ptr<rocksdb::Iterator> it(db.NewIterator(read_options));
+    if (batch)
+        it.reset(batch->NewIteratorWithBase(it.release()));
+    for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next())
+        f(it->key(), it->value());
+    throwRockDBErrorNotOk(it->status());
+}
+
+bool tryGetData(rocksdb::DB & db, rocksdb::WriteBatchWithIndex & batch, const std::string & path, std::string * value)
+{
+    auto status = batch.GetFromBatchAndDB(&db, {}, path, value);
+    if (status.IsNotFound())
+        return false;
+    throwRockDBErrorNotOk(status);
+    return true;
+}
+
+bool exist(rocksdb::DB & db, rocksdb::WriteBatchWithIndex & batch, const std::string & path)
+{
+    std::string data;
+    return tryGetData(db, batch, path, &data);
+}
+}
+
 void throwRockDBErrorNotOk(const rocksdb::Status & status)
 {
     if (!status.ok())
@@ -39,8 +93,13 @@ void throwRockDBErrorNotOk(const rocksdb::Status & status)
 
 bool exist(rocksdb::DB & db, const std::string & path)
 {
-    std::string data;
-    return tryGetData(db, path, &data);
+    /// Pinned value, the data is not copied out of the block cache.
+    rocksdb::PinnableSlice data;
+    auto status = db.Get({}, db.DefaultColumnFamily(), path, &data);
+    if (status.IsNotFound())
+        return false;
+    throwRockDBErrorNotOk(status);
+    return true;
 }
 
 bool tryGetData(rocksdb::DB & db, const std::string & path, std::string * value)
@@ -62,122 +121,138 @@ String getData(rocksdb::DB & db, const std::string & path)
 std::vector<String> listKeys(rocksdb::DB & db, const std::string & path)
 {
     std::vector<String> result;
-    auto *it = db.NewIterator({});
-    for (it->Seek(path); it->Valid() && it->key().starts_with(path); it->Next())
+    forEachKeyWithPrefix(
+        db,
+        nullptr,
+        path,
+        [&](const rocksdb::Slice & key, const rocksdb::Slice &)
+        {
+            if (key != path)
+                result.push_back(key.ToString());
+        });
+    return result;
+}
+
+std::vector<std::optional<String>> tryGetData(rocksdb::DB & db, const std::vector<std::string> & paths)
+{
+    std::vector<rocksdb::Slice> keys(paths.begin(), paths.end());
+    std::vector<rocksdb::PinnableSlice> values(paths.size());
+    std::vector<rocksdb::Status> statuses(paths.size());
+    db.MultiGet({}, db.DefaultColumnFamily(), keys.size(), keys.data(), values.data(), statuses.data());
+
+    std::vector<std::optional<String>> result;
+    result.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
     {
-        if (it->key() == path)
+        if (statuses[i].IsNotFound())
+        {
+            result.emplace_back();
             continue;
-        result.push_back(it->key().ToString());
+        }
+        throwRockDBErrorNotOk(statuses[i]);
+        result.emplace_back(values[i].ToString());
     }
     return result;
 }
 
 void RocksDBWriteFileOperation::execute(std::unique_lock<DB::SharedMutex> &)
 {
-    auto status = db.Get({}, path, &prev_data);
-    if (status.IsNotFound())
-        existed = false;
-    else
-        throwRockDBErrorNotOk(status);
-    db.Put({}, path, data);
+    throwRockDBErrorNotOk(batch.Put(path, data));
 }
 
 void RocksDBWriteFileOperation::undo(std::unique_lock<DB::SharedMutex> &)
 {
-    if (existed)
-        throwRockDBErrorNotOk(db.Put({}, path, prev_data));
-    else
-        throwRockDBErrorNotOk(db.Delete({}, path));
 }
 
 void RocksDBCreateDirectoryOperation::execute(std::unique_lock<DB::SharedMutex> &)
 {
-    existed = exist(db, path);
-    if (existed)
+    if (exist(db, batch, path))
         return;
-    throwRockDBErrorNotOk(db.Put({}, path, DIR_DATA));
+    throwRockDBErrorNotOk(batch.Put(path, DIR_DATA));
 }
 
 void RocksDBCreateDirectoryOperation::undo(std::unique_lock<DB::SharedMutex> &)
 {
-    if (existed) return;
-    throwRockDBErrorNotOk(db.Delete({}, path));
 }
 
 void RocksDBCreateDirectoryRecursiveOperation::execute(std::unique_lock<DB::SharedMutex> & )
 {
     namespace fs = std::filesystem;
     fs::path p(path);
-    while (!exist(db, p.string()))
+    std::vector<std::string> paths_to_create;
+    while (!exist(db, batch, p.string()))
     {
-        paths_created.push_back(p);
+        paths_to_create.push_back(p);
         if (!p.has_parent_path())
             break;
         p = p.parent_path();
     }
-    for (const auto & path_to_create : paths_created | std::views::reverse)
-        throwRockDBErrorNotOk(db.Put({}, path_to_create, RocksDBCreateDirectoryOperation::DIR_DATA));
+    for (const auto & path_to_create : paths_to_create | std::views::reverse)
+        throwRockDBErrorNotOk(batch.Put(path_to_create, RocksDBCreateDirectoryOperation::DIR_DATA));
 }
 
 void RocksDBCreateDirectoryRecursiveOperation::undo(std::unique_lock<DB::SharedMutex> & )
 {
-    for (const auto & path_created : paths_created)
-        throwRockDBErrorNotOk(db.Delete({}, path_created));
 }
 
 void RocksDBRemoveDirectoryOperation::execute(std::unique_lock<DB::SharedMutex> &)
 {
-    auto *it = db.NewIterator({});
+    bool existed = false;
     bool empty_dir = true;
-    for (it->Seek(path); it->Valid() && it->key().starts_with(path); it->Next())
-    {
-        if (it->key() != path && it->key().starts_with(path))
+    forEachKeyWithPrefix(
+        db,
+        &batch,
+        path,
+        [&](const rocksdb::Slice & key, const rocksdb::Slice &)
         {
-            empty_dir = false;
-            break;
-        }
-        if (it->key() == path)
-            existed = true;
-    }
+            if (key == path)
+                existed = true;
+            else
+                empty_dir = false;
+        });
     if (!empty_dir)
     {
         throw DB::Exception(DB::ErrorCodes::INVALID_STATE, "Directory {} is not empty", path);
     }
     if (existed)
-        throwRockDBErrorNotOk(db.Delete({}, path));
+        throwRockDBErrorNotOk(batch.Delete(path));
 }
 
 void RocksDBRemoveDirectoryOperation::undo(std::unique_lock<DB::SharedMutex> &)
 {
-    if (existed)
-        throwRockDBErrorNotOk(db.Put({}, path, RocksDBCreateDirectoryOperation::DIR_DATA));
 }
 
 void RocksDBRemoveRecursiveOperation::execute(std::unique_lock<DB::SharedMutex> &)
 {
-    auto *it = db.NewIterator({});
-    for (it->Seek(path); it->Valid() && it->key().starts_with(path); it->Next())
-    {
-        files.emplace(it->key().ToString(), it->value().ToString());
-        throwRockDBErrorNotOk(db.Delete({}, it->key()));
-    }
+    /// Collect first, the batch must not change while one of its iterators is open.
+    std::vector<String> keys;
+    forEachKeyWithPrefix(db, &batch, path, [&](const rocksdb::Slice & key, const rocksdb::Slice &) { keys.push_back(key.ToString()); });
+    for (const auto & key : keys)
+        throwRockDBErrorNotOk(batch.Delete(key));
 }
 
 void RocksDBRemoveRecursiveOperation::undo(std::unique_lock<DB::SharedMutex> &)
 {
-    for (const auto & [key, value] : files)
-        throwRockDBErrorNotOk(db.Put({}, key, value));
 }
 
 void RocksDBUnlinkFileOperation::execute(std::unique_lock<DB::SharedMutex> &)
 {
-    prev_data = getData(db, path);
-    throwRockDBErrorNotOk(db.Delete({}, path));
+    if (!exist(db, batch, path))
+        throw DB::Exception(DB::ErrorCodes::INVALID_STATE, "File {} does not exist", path);
+    throwRockDBErrorNotOk(batch.Delete(path));
 }
 
 void RocksDBUnlinkFileOperation::undo(std::unique_lock<DB::SharedMutex> &)
 {
-    throwRockDBErrorNotOk(db.Put({}, path, prev_data));
+}
+
+void RocksDBWriteBatchOperation::execute(std::unique_lock<DB::SharedMutex> &)
+{
+    throwRockDBErrorNotOk(db.Write({}, batch.GetWriteBatch()));
+}
+
+void RocksDBWriteBatchOperation::undo(std::unique_lock<DB::SharedMutex> &)
+{
 }
 }
-#endif
\ No newline at end of file
+#endif
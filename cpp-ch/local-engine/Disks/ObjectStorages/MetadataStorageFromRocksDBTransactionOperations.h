@@ -20,6 +20,7 @@
 #include <Disks/ObjectStorages/IMetadataOperation.h>
 #include <Disks/ObjectStorages/IMetadataStorage.h>
 #include <rocksdb/db.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
 
 namespace local_engine
 {
@@ -28,11 +29,16 @@ bool exist(rocksdb::DB & db, const std::string & path);
 bool tryGetData(rocksdb::DB & db, const std::string & path, std::string* value);
 String getData(rocksdb::DB & db, const std::string & path);
 std::vector<String> listKeys(rocksdb::DB & db, const std::string & path);
+/// Reads many keys with one MultiGet, a missing key gives std::nullopt.
+std::vector<std::optional<String>> tryGetData(rocksdb::DB & db, const std::vector<std::string> & paths);
 
+/// The operations of a transaction read through the transaction's write batch, so they see the writes of the
+/// operations before them, and only write into that batch. RocksDBWriteBatchOperation is added last and applies the
+/// whole batch atomically, so nothing reaches the db before every operation succeeded and undo has nothing to revert.
 struct RocksDBWriteFileOperation final : public DB::IMetadataOperation
 {
-    RocksDBWriteFileOperation(const std::string& path_, rocksdb::DB& db_, const std::string& data_) : path(path_),
-        db(db_), data(data_)
+    RocksDBWriteFileOperation(const std::string & path_, rocksdb::WriteBatchWithIndex & batch_, const std::string & data_)
+        : path(path_), batch(batch_), data(data_)
     {
     }
 
@@ -42,15 +48,14 @@ struct RocksDBWriteFileOperation final : public DB::IMetadataOperation
 
 private:
     std::string path;
-    rocksdb::DB & db;
+    rocksdb::WriteBatchWithIndex & batch;
     std::string data;
-    bool existed = false;
-    std::string prev_data;
 };
 
 struct RocksDBCreateDirectoryOperation final : public DB::IMetadataOperation
 {
-    RocksDBCreateDirectoryOperation(const std::string & path_, rocksdb::DB & db_) : path(path_), db(db_)
+    RocksDBCreateDirectoryOperation(const std::string & path_, rocksdb::DB & db_, rocksdb::WriteBatchWithIndex & batch_)
+        : path(path_), db(db_), batch(batch_)
     {
     }
 
@@ -61,14 +66,14 @@ struct RocksDBCreateDirectoryOperation final : public DB::IMetadataOperation
     const static inline String DIR_DATA = "__DIR__";
 private:
     std::string path;
-    bool existed = false;
     rocksdb::DB & db;
-
+    rocksdb::WriteBatchWithIndex & batch;
 };
 
 struct RocksDBCreateDirectoryRecursiveOperation final : public DB::IMetadataOperation
 {
-    RocksDBCreateDirectoryRecursiveOperation(const std::string & path_, rocksdb::DB & db_) : path(path_), db(db_)
+    RocksDBCreateDirectoryRecursiveOperation(const std::string & path_, rocksdb::DB & db_, rocksdb::WriteBatchWithIndex & batch_)
+        : path(path_), db(db_), batch(batch_)
     {
     };
 
@@ -78,13 +83,14 @@ struct RocksDBCreateDirectoryRecursiveOperation final : public DB::IMetadataOper
 
 private:
     std::string path;
-    std::vector<std::string> paths_created;
     rocksdb::DB & db;
+    rocksdb::WriteBatchWithIndex & batch;
 };
 
 struct RocksDBRemoveDirectoryOperation final : public DB::IMetadataOperation
 {
-    RocksDBRemoveDirectoryOperation(const std::string & path_, rocksdb::DB & db_): path(path_), db(db_)
+    RocksDBRemoveDirectoryOperation(const std::string & path_, rocksdb::DB & db_, rocksdb::WriteBatchWithIndex & batch_)
+        : path(path_), db(db_), batch(batch_)
     {
     }
 
@@ -94,13 +100,14 @@ struct RocksDBRemoveDirectoryOperation final : public DB::IMetadataOperation
 
 private:
     std::string path;
-    bool existed = false;
     rocksdb::DB & db;
+    rocksdb::WriteBatchWithIndex & batch;
 };
 
 struct RocksDBRemoveRecursiveOperation final : public DB::IMetadataOperation
 {
-    RocksDBRemoveRecursiveOperation(const std::string & path_, rocksdb::DB & db_) : path(path_), db(db_)
+    RocksDBRemoveRecursiveOperation(const std::string & path_, rocksdb::DB & db_, rocksdb::WriteBatchWithIndex & batch_)
+        : path(path_), db(db_), batch(batch_)
     {
     }
 
@@ -111,12 +118,13 @@ struct RocksDBRemoveRecursiveOperation final : public DB::IMetadataOperation
 private:
     std::string path;
     rocksdb::DB & db;
-    std::unordered_map<String, String> files;
+    rocksdb::WriteBatchWithIndex & batch;
 };
 
 struct RocksDBUnlinkFileOperation final : public DB::IMetadataOperation
 {
-    RocksDBUnlinkFileOperation(const std::string & path_, rocksdb::DB & db_) : path(path_), db(db_)
+    RocksDBUnlinkFileOperation(const std::string & path_, rocksdb::DB & db_, rocksdb::WriteBatchWithIndex & batch_)
+        : path(path_), db(db_), batch(batch_)
     {
     }
 
@@ -127,10 +135,21 @@ struct RocksDBUnlinkFileOperation final : public DB::IMetadataOperation
 private:
     std::string path;
     rocksdb::DB & db;
-    std::string prev_data;
+    rocksdb::WriteBatchWithIndex & batch;
 };
 
+struct RocksDBWriteBatchOperation final : public DB::IMetadataOperation
+{
+    RocksDBWriteBatchOperation(rocksdb::DB & db_, rocksdb::WriteBatchWithIndex & batch_) : db(db_), batch(batch_) { }
+
+    void execute(std::unique_lock<DB::SharedMutex> & metadata_lock) override;
+
+    void undo(std::unique_lock<DB::SharedMutex> & metadata_lock) override;
+
+private:
+    rocksdb::DB & db;
+    rocksdb::WriteBatchWithIndex & batch;
+};
 
 }
 #endif
-
@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <type_traits>
@@ -136,12 +137,22 @@ private:
         else
             container_of_int = &typeid_cast<const ColumnType &>(*column_ptr).getData();
 
-        for (size_t i = 0; i < input_rows_count; ++i)
+        auto & bloom_filter_data = *reinterpret_cast<AggregateFunctionGroupBloomFilterData *>(bloom_filter_state);
+        if (second_arg_const)
+        {
+            const UInt8 found = bloom_filter_data.find((*container_of_int)[0]);
+            std::fill(vec_to.begin(), vec_to.begin() + input_rows_count, found);
+        }
+        else if (bloom_filter_data.split_block)
+        {
+            // Int64 keys are hashed by their bit pattern, the same way add() does.
+            bloom_filter_data.split_block_filter.findMany(
+                reinterpret_cast<const UInt64 *>(container_of_int->data()), input_rows_count, vec_to.data());
+        }
+        else
         {
-            const T v = second_arg_const ? (*container_of_int)[0] : (*container_of_int)[i];
-            AggregateFunctionGroupBloomFilterData & bloom_filter_data_0
-                = *reinterpret_cast<AggregateFunctionGroupBloomFilterData *>(bloom_filter_state);
-            vec_to[i] = bloom_filter_data_0.bloom_filter.find(reinterpret_cast<const char *>(&v), sizeof(T));
+            for (size_t i = 0; i < input_rows_count; ++i)
+                vec_to[i] = bloom_filter_data.find((*container_of_int)[i]);
         }
     }
 
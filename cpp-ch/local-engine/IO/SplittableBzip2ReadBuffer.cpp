@@ -18,12 +18,21 @@
 #include "SplittableBzip2ReadBuffer.h"
 
 #if USE_BZIP2
+#include <IO/ReadBufferFromMemory.h>
 #include <IO/SeekableReadBuffer.h>
 #include <IO/VarInt.h>
 #include <base/find_symbols.h>
+#include <Common/ThreadPool.h>
+#include <Common/getNumberOfPhysicalCPUCores.h>
 #include <Common/logger_useful.h>
 #include <iostream>
 
+namespace CurrentMetrics
+{
+extern const Metric LocalThread;
+extern const Metric LocalThreadActive;
+extern const Metric LocalThreadScheduled;
+}
 
 namespace DB
 {
@@ -34,6 +43,18 @@ extern const int LOGICAL_ERROR;
 extern const int POSITION_OUT_OF_BOUND;
 }
 
+ThreadPool & SplittableBzip2ReadBuffer::getDecodeThreadPool()
+{
+    static ThreadPool pool(
+        CurrentMetrics::LocalThread,
+        CurrentMetrics::LocalThreadActive,
+        CurrentMetrics::LocalThreadScheduled,
+        std::max<size_t>(getNumberOfPhysicalCPUCores(), 1),
+        0,
+        0);
+    return pool;
+}
+
 std::vector<Int32> & SplittableBzip2ReadBuffer::Data::initTT(Int32 length)
 {
     if (tt.size() < static_cast<size_t>(length))
@@ -161,7 +182,9 @@ SplittableBzip2ReadBuffer::SplittableBzip2ReadBuffer(
     bool last_block_need_special_process_,
     size_t buf_size,
     char * existing_memory,
-    size_t alignment)
+    size_t alignment,
+    ThreadPoolCallbackRunnerUnsafe<void> schedule_,
+    size_t max_parallel_blocks_)
     : CompressedReadBufferWrapper(std::move(in_), buf_size, existing_memory, alignment)
     , first_block_need_special_process(first_block_need_special_process_)
     , last_block_need_special_process(last_block_need_special_process_)
@@ -181,6 +204,8 @@ SplittableBzip2ReadBuffer::SplittableBzip2ReadBuffer(
     , bsBuff(0)
     , bsLive(0)
     , last(0)
+    , schedule(std::move(schedule_))
+    , max_parallel_blocks(schedule ? max_parallel_blocks_ : 0)
 {
     auto * seekable = dynamic_cast<SeekableReadBuffer*>(in.get());
     skipResult = skipToNextMarker(BLOCK_DELIMITER, DELIMITER_BIT_LENGTH);
@@ -189,13 +214,222 @@ SplittableBzip2ReadBuffer::SplittableBzip2ReadBuffer(
         /// Update adjusted_start
         adjusted_start = seekable->getPosition();
     }
-    changeStateToProcessABlock();
+
+    if (max_parallel_blocks > 1)
+    {
+        /// The first block starts with the bits left in bsBuff after the delimiter.
+        currentState = STATE::END_OF_FILE;
+        scan_finished = !skipResult;
+        if (skipResult && bsLive)
+        {
+            next_block_head.bytes.push_back(static_cast<char>(bsBuff & 0xff));
+            next_block_head.start_bit = static_cast<UInt8>(8 - bsLive);
+            scan_window = bsBuff & 0xff;
+        }
+    }
+    else
+        changeStateToProcessABlock();
+
     LOG_DEBUG(
         getLogger("SplittableBzip2ReadBuffer"),
-        "adjusted_start:{} first_block_need_special_process:{} last_block_need_special_process:{}",
+        "adjusted_start:{} first_block_need_special_process:{} last_block_need_special_process:{} max_parallel_blocks:{}",
         *adjusted_start,
         first_block_need_special_process,
-        last_block_need_special_process);
+        last_block_need_special_process,
+        max_parallel_blocks);
+}
+
+SplittableBzip2ReadBuffer::SplittableBzip2ReadBuffer(std::unique_ptr<ReadBuffer> in_, UInt8 start_bit, SingleBlockTag)
+    : CompressedReadBufferWrapper(std::move(in_), 0, nullptr, 0)
+    , first_block_need_special_process(false)
+    , last_block_need_special_process(false)
+    , is_first_block(true)
+    , blockSize100k(9)
+    , currentState(STATE::NO_PROCESS_STATE)
+    , skipResult(true)
+    , currentChar(0)
+    , storedBlockCRC(0)
+    , blockRandomised(false)
+    , data(nullptr)
+    , computedBlockCRC(0)
+    , storedCombinedCRC(0)
+    , computedCombinedCRC(0)
+    , origPtr(0)
+    , nInUse(0)
+    , bsBuff(0)
+    , bsLive(0)
+    , last(0)
+{
+    if (start_bit)
+        bsR(start_bit);
+    changeStateToProcessABlock();
+}
+
+SplittableBzip2ReadBuffer::DecodedBlock SplittableBzip2ReadBuffer::decodeBlock(const CompressedBlock & block)
+{
+    SplittableBzip2ReadBuffer decoder(
+        std::make_unique<ReadBufferFromMemory>(block.bytes.data(), block.bytes.size()), block.start_bit, SingleBlockTag{});
+
+    DecodedBlock decoded;
+    decoded.data.reserve(decoder.last + 1);
+    for (Int32 b = decoder.read0(); b >= 0; b = decoder.read0())
+        decoded.data.push_back(static_cast<char>(b));
+
+    try
+    {
+        const Int64 marker = decoder.bsR(DELIMITER_BIT_LENGTH);
+        decoded.ends_at_delimiter = marker == BLOCK_DELIMITER || marker == EOS_DELIMITER;
+    }
+    catch (const Exception &)
+    {
+        decoded.ends_at_delimiter = false;
+    }
+    return decoded;
+}
+
+std::optional<SplittableBzip2ReadBuffer::CompressedBlock> SplittableBzip2ReadBuffer::scanNextBlock()
+{
+    if (scan_finished)
+        return {};
+
+    static constexpr UInt64 delimiter_mask = (1ULL << DELIMITER_BIT_LENGTH) - 1;
+    CompressedBlock block = std::move(next_block_head);
+    next_block_head = {};
+    size_t block_bits = block.bytes.size() * 8 - block.start_bit;
+    while (!in->eof())
+    {
+        for (Position pos = in->position(); pos < in->buffer().end(); ++pos)
+        {
+            const UInt8 byte = static_cast<UInt8>(*pos);
+            block.bytes.push_back(static_cast<char>(byte));
+            scan_window = (scan_window << 8) | byte;
+            block_bits += 8;
+
+            /// shift is the number of bits of this byte after the end of the candidate delimiter. The stream and the
+            /// pattern are MSB first, so the earliest candidate is the one with the largest shift.
+            for (Int32 shift = 7; shift >= 0; --shift)
+            {
+                if (block_bits < static_cast<size_t>(DELIMITER_BIT_LENGTH + shift))
+                    continue;
+                if (static_cast<Int64>((scan_window >> shift) & delimiter_mask) != BLOCK_DELIMITER)
+                    continue;
+
+                in->position() = pos + 1;
+                if (shift)
+                {
+                    next_block_head.bytes.push_back(static_cast<char>(byte));
+                    next_block_head.start_bit = static_cast<UInt8>(8 - shift);
+                }
+                return block;
+            }
+        }
+        in->position() = in->buffer().end();
+    }
+
+    scan_finished = true;
+    block.last = true;
+    if (block_bits == 0)
+        return {};
+    return block;
+}
+
+void SplittableBzip2ReadBuffer::scheduleBlocks()
+{
+    while (decoding_blocks.size() < max_parallel_blocks)
+    {
+        auto block = scanNextBlock();
+        if (!block)
+            break;
+
+        auto task = std::make_shared<BlockTask>();
+        task->compressed = std::move(*block);
+        /// The task only touches its own BlockTask, so a destroyed buffer does not have to wait for it.
+        auto future = schedule([task] { task->decoded = decodeBlock(task->compressed); }, {});
+        decoding_blocks.emplace_back(std::move(task), std::move(future));
+    }
+}
+
+bool SplittableBzip2ReadBuffer::nextDecodedBlock()
+{
+    scheduleBlocks();
+    if (decoding_blocks.empty())
+        return false;
+
+    auto [task, future] = std::move(decoding_blocks.front());
+    decoding_blocks.pop_front();
+    /// Keep the pool busy while this block is consumed.
+    scheduleBlocks();
+
+    try
+    {
+        future.get();
+        if (!task->decoded.ends_at_delimiter && !task->compressed.last)
+            throw Exception(ErrorCodes::LOGICAL_ERROR, "Bzip2 block does not end at a block delimiter");
+        decoded_block = std::move(task->decoded.data);
+    }
+    catch (...)
+    {
+        decoded_block = decodeWithFollowingBlocks(std::move(task->compressed), std::current_exception()).data;
+    }
+    decoded_pos = 0;
+    return true;
+}
+
+SplittableBzip2ReadBuffer::DecodedBlock SplittableBzip2ReadBuffer::decodeWithFollowingBlocks(CompressedBlock block, std::exception_ptr error)
+{
+    while (!block.last && block.bytes.size() < MAX_COMPRESSED_BLOCK_SIZE)
+    {
+        CompressedBlock next;
+        if (!decoding_blocks.empty())
+        {
+            /// Its decoded result is useless now, the task owns its data and may finish on its own.
+            next = decoding_blocks.front().first->compressed;
+            decoding_blocks.pop_front();
+        }
+        else if (auto scanned = scanNextBlock())
+            next = std::move(*scanned);
+        else
+            break;
+
+        /// Both blocks hold the byte shared at the delimiter end, keep one copy of it.
+        block.bytes.append(next.bytes, next.start_bit ? 1 : 0);
+        block.last = next.last;
+        try
+        {
+            auto decoded = decodeBlock(block);
+            if (decoded.ends_at_delimiter || block.last)
+                return decoded;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+    std::rethrow_exception(error);
+}
+
+Int32 SplittableBzip2ReadBuffer::readParallel(char * dest, size_t dest_size, size_t offs, size_t len)
+{
+    if (offs + len > dest_size)
+        throw Exception(ErrorCodes::POSITION_OUT_OF_BOUND, "offs({}) + len({}) > dest_size({}).", offs, len, dest_size);
+
+    /// Same contract as the sequential read(): END_OF_BLOCK once after each block, END_OF_STREAM after the last one.
+    if (decoded_pos == decoded_block.size())
+    {
+        if (decoded_block_active)
+        {
+            decoded_block_active = false;
+            return BZip2Constants::END_OF_BLOCK;
+        }
+        if (!nextDecodedBlock())
+            return BZip2Constants::END_OF_STREAM;
+        decoded_block_active = true;
+    }
+
+    const size_t n = std::min(len, decoded_block.size() - decoded_pos);
+    memcpy(dest + offs, decoded_block.data() + decoded_pos, n);
+    decoded_pos += n;
+    return static_cast<Int32>(n);
 }
 
 Int32 SplittableBzip2ReadBuffer::read(char * dest, size_t dest_size, size_t offs, size_t len)
@@ -239,7 +473,8 @@ bool SplittableBzip2ReadBuffer::nextImpl()
     Int32 result;
     do
     {
-        result = read(dest, dest_size, offset, dest_size - offset);
+        result = max_parallel_blocks > 1 ? readParallel(dest, dest_size, offset, dest_size - offset)
+                                         : read(dest, dest_size, offset, dest_size - offset);
         if (result > 0)
             offset += result;
         else if (first_block_need_special_process && result == BZip2Constants::END_OF_BLOCK && is_first_block)
@@ -20,9 +20,12 @@
 #include "config.h"
 
 #if USE_BZIP2
+#include <deque>
+#include <future>
 #include <vector>
 #include <IO/CompressedReadBufferWrapper.h>
 #include <base/StringRef.h>
+#include <Common/threadPoolCallbackRunner.h>
 #include <iostream>
 
 namespace DB
@@ -75,6 +78,39 @@ public:
     static constexpr Int32 DELIMITER_BIT_LENGTH = 48;
 
 private:
+    /// A bzip2 block cut out of the input at the block delimiters, decoded on its own in parallel mode.
+    struct CompressedBlock
+    {
+        /// Input bytes from the byte holding the first bit of the block to the end of the next block delimiter.
+        String bytes;
+        /// Number of leading bits of bytes[0] which belong to the previous block.
+        UInt8 start_bit = 0;
+        /// No block delimiter was found after the block, it runs to the end of the input.
+        bool last = false;
+    };
+
+    struct DecodedBlock
+    {
+        String data;
+        /// The decoder stopped right before a block or stream delimiter, which is where a well cut block ends.
+        bool ends_at_delimiter = false;
+    };
+
+    struct BlockTask
+    {
+        CompressedBlock compressed;
+        DecodedBlock decoded;
+    };
+    using BlockTaskPtr = std::shared_ptr<BlockTask>;
+
+    /// The delimiter pattern may also occur inside compressed data. A block cut at such a position is glued to the
+    /// following ones until it decodes, but never grows past this size.
+    static constexpr size_t MAX_COMPRESSED_BLOCK_SIZE = 2 * 9 * BZip2Constants::BASE_BLOCK_SIZE;
+
+    struct SingleBlockTag
+    {
+    };
+
     struct Data
     {
         bool inUse[256] = {false};
@@ -245,6 +281,20 @@ private:
     /// It is only valid when input stream is seekable and block header could be found in input stream.
     std::optional<size_t> adjusted_start;
 
+    /// Parallel mode: the input is cut into blocks at the block delimiters, up to max_parallel_blocks of them are
+    /// decoded concurrently by schedule, and the decoded blocks are returned by read() in input order.
+    ThreadPoolCallbackRunnerUnsafe<void> schedule;
+    size_t max_parallel_blocks = 0;
+    std::deque<std::pair<BlockTaskPtr, std::future<void>>> decoding_blocks;
+    /// Head of the next block, i.e. the tail bits of the byte holding the end of the last found delimiter.
+    CompressedBlock next_block_head;
+    /// Last 8 bytes scanned, to match the delimiter at any bit offset.
+    UInt64 scan_window = 0;
+    bool scan_finished = false;
+    String decoded_block;
+    size_t decoded_pos = 0;
+    bool decoded_block_active = false;
+
     static void hbCreateDecodeTables(
         Int32 * __restrict limit,
         Int32 * __restrict base,
@@ -261,7 +311,9 @@ public:
         bool last_block_need_special_process_ = false,
         size_t buf_size = DBMS_DEFAULT_BUFFER_SIZE,
         char * existing_memory = nullptr,
-        size_t alignment = 0);
+        size_t alignment = 0,
+        ThreadPoolCallbackRunnerUnsafe<void> schedule_ = {},
+        size_t max_parallel_blocks_ = 0);
 
     ~SplittableBzip2ReadBuffer() override = default;
 
@@ -271,7 +323,21 @@ public:
 
     static bool skipToNextMarker(Int64 marker, Int32 markerBitLength, ReadBuffer & in_, Int64 & bsBuff_, Int64 & bsLive_);
 
+    /// Pool running the block decoding of the parallel mode. Decoding is CPU bound, so the pool is bounded by the
+    /// physical cores and kept apart from the IO pool, whose threads are sized to wait on reads.
+    static ThreadPool & getDecodeThreadPool();
+
 private:
+    /// Decoder of the single block starting start_bit bits into in_, used by the parallel mode.
+    SplittableBzip2ReadBuffer(std::unique_ptr<ReadBuffer> in_, UInt8 start_bit, SingleBlockTag);
+
+    static DecodedBlock decodeBlock(const CompressedBlock & block);
+    std::optional<CompressedBlock> scanNextBlock();
+    void scheduleBlocks();
+    bool nextDecodedBlock();
+    DecodedBlock decodeWithFollowingBlocks(CompressedBlock block, std::exception_ptr error);
+    Int32 readParallel(char * dest, size_t dest_size, size_t offs, size_t len);
+
     Int32 read(char * dest, size_t dest_size, size_t offs, size_t len);
     Int32 read0();
     static Int32 readAByte(ReadBuffer & in_);
@@ -16,8 +16,12 @@
  */
 #include "BroadCastJoinBuilder.h"
 
+#include <atomic>
 #include <Compression/CompressedReadBuffer.h>
+#include <DataTypes/DataTypeLowCardinality.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <Interpreters/TableJoin.h>
+#include <Join/BucketedBroadcastJoin.h>
 #include <Join/StorageJoinFromReadBuffer.h>
 #include <Parser/RelParsers/JoinRelParser.h>
 #include <Parser/TypeParser.h>
@@ -25,11 +29,23 @@
 #include <Shuffle/ShuffleReader.h>
 #include <jni/SharedPointerWrapper.h>
 #include <jni/jni_common.h>
+#include <base/scope_guard.h>
 #include <Poco/StringTokenizer.h>
 #include <Common/CHUtil.h>
+#include <Common/GlutenConfig.h>
 #include <Common/JNIUtils.h>
+#include <Common/QueryContext.h>
+#include <Common/ThreadPool.h>
+#include <Common/formatReadable.h>
 #include <Common/logger_useful.h>
 
+namespace CurrentMetrics
+{
+extern const Metric LocalThread;
+extern const Metric LocalThreadActive;
+extern const Metric LocalThreadScheduled;
+}
+
 namespace DB
 {
 namespace ErrorCodes
@@ -44,6 +60,7 @@ namespace BroadCastJoinBuilder
 {
 static jclass Java_CHBroadcastBuildSideCache = nullptr;
 static jmethodID Java_get = nullptr;
+static std::atomic<size_t> executor_memory_usage = 0;
 jlong callJavaGet(const std::string & id)
 {
     GET_JNIENV(env)
@@ -90,7 +107,37 @@ void cleanBuildHashTable(const std::string & hash_table_id, jlong instance)
     /// Record memory usage in Total Memory Tracker
     ThreadFromGlobalPoolNoTracingContextPropagation thread(clean_join);
     thread.join();
-    LOG_DEBUG(&Poco::Logger::get("BroadCastJoinBuilder"), "Broadcast hash table {} is cleaned", hash_table_id);
+    LOG_DEBUG(
+        &Poco::Logger::get("BroadCastJoinBuilder"),
+        "Broadcast hash table {} is cleaned, executor broadcast memory usage: {}",
+        hash_table_id,
+        ReadableSize(memoryUsage()));
+}
+
+void reserveMemory(size_t bytes)
+{
+    executor_memory_usage += bytes;
+}
+
+bool tryReserveMemory(size_t bytes, size_t limit)
+{
+    size_t usage = executor_memory_usage.load();
+    do
+    {
+        if (limit && usage + bytes > limit)
+            return false;
+    } while (!executor_memory_usage.compare_exchange_weak(usage, usage + bytes));
+    return true;
+}
+
+void releaseMemory(size_t bytes)
+{
+    executor_memory_usage -= bytes;
+}
+
+size_t memoryUsage()
+{
+    return executor_memory_usage.load();
 }
 
 std::shared_ptr<StorageJoinFromReadBuffer> getJoin(const std::string & key)
@@ -139,35 +186,139 @@ std::shared_ptr<StorageJoinFromReadBuffer> buildJoin(
     header = resetBuildTableBlockName(header);
 
     Blocks data;
+    std::vector<DB::TemporaryBlockStreamHolder> spilled_buckets;
+    JoinKeyFilters key_filters;
+    /// Bytes of the blocks kept in memory, reserved in the executor level broadcast memory while they are deserialized
+    /// so that concurrent builds see each other. Released if the build spills or fails, handed over to the storage
+    /// otherwise.
+    size_t reserved_bytes = 0;
+    SCOPE_EXIT({ releaseMemory(reserved_bytes); });
     auto collect_data = [&]
     {
         bool only_one_column = header.getNamesAndTypesList().empty();
         if (only_one_column)
             header = BlockUtil::buildRowCountBlock(0).getColumnsWithTypeAndName();
 
-        NativeReader block_stream(input);
-        ProfileInfo info;
-        while (Block block = block_stream.read())
+        /// Only the joins BucketedBroadcastJoin supports are spilled, the other build sides are always kept in memory. The
+        /// parser checks the same predicate, a spilled build side is never loaded into memory as a whole.
+        const auto global_context = QueryContext::globalContext();
+        const auto join_config = JoinConfig::loadFromContext(global_context);
+        const size_t max_bytes_in_memory = join_config.broadcast_build_max_bytes_in_memory;
+        const size_t max_bytes_per_executor = join_config.broadcast_build_max_bytes_per_executor;
+        const bool allow_spill = (max_bytes_in_memory || max_bytes_per_executor) && !only_one_column && !key_names.empty()
+            && !has_mixed_join_condition && !key.starts_with("BuiltBNLJBroadcastTable-")
+            && BucketedBroadcastJoin::isSupported(DB::TableJoin(DB::SizeLimits(), true, kind, strictness, key_names));
+        /// Reserves the bytes of the next block kept in memory, fails if the build side should be spilled instead.
+        auto try_reserve = [&](size_t bytes)
         {
+            if (allow_spill && max_bytes_in_memory && reserved_bytes + bytes > max_bytes_in_memory)
+                return false;
+            if (!tryReserveMemory(bytes, allow_spill ? max_bytes_per_executor : 0))
+                return false;
+            reserved_bytes += bytes;
+            return true;
+        };
+        auto convert_block = [&](const DB::Block & block)
+        {
+            if (only_one_column)
+                return block;
             DB::ColumnsWithTypeAndName columns;
             for (size_t i = 0; i < block.columns(); ++i)
-            {
-                const auto & column = block.getByPosition(i);
-                if (only_one_column)
-                {
-                    auto virtual_block = BlockUtil::buildRowCountBlock(column.column->size()).getColumnsWithTypeAndName();
-                    header = virtual_block;
-                    columns.emplace_back(virtual_block.back());
-                    break;
-                }
+                columns.emplace_back(BlockUtil::convertColumnAsNecessary(block.getByPosition(i), header.getByPosition(i)));
+            return DB::Block(columns);
+        };
+        DB::DataTypes key_types;
+        auto spill_block = [&](const DB::Block & block)
+        {
+            auto blocks = BucketedBroadcastJoin::scatterByKeys(convert_block(block), key_names, key_types, spilled_buckets.size());
+            for (size_t i = 0; i < blocks.size(); ++i)
+                if (blocks[i].rows())
+                    spilled_buckets[i]->write(blocks[i]);
+        };
 
-                columns.emplace_back(BlockUtil::convertColumnAsNecessary(column, header.getByPosition(i)));
+        /// Blocks are deserialized sequentially, the conversions into the build side header run in parallel later.
+        Blocks raw_blocks;
+        NativeReader block_stream(input);
+        while (Block block = block_stream.read())
+        {
+            if (only_one_column)
+            {
+                auto virtual_block = BlockUtil::buildRowCountBlock(block.rows()).getColumnsWithTypeAndName();
+                header = virtual_block;
+                block = DB::Block({virtual_block.back()});
+            }
+            if (!spilled_buckets.empty())
+            {
+                spill_block(block);
+                continue;
+            }
+            const size_t bytes = block.allocatedBytes();
+            raw_blocks.emplace_back(std::move(block));
+            if (!try_reserve(bytes))
+            {
+                LOG_INFO(
+                    &Poco::Logger::get("BroadCastJoinBuilder"),
+                    "Broadcast table {} with {} in memory exceeds the limit, spill it into disk. executor broadcast memory usage: {}",
+                    key,
+                    ReadableSize(reserved_bytes + bytes),
+                    ReadableSize(memoryUsage()));
+                for (const auto & key_name : key_names)
+                    key_types.emplace_back(DB::removeNullable(DB::recursiveRemoveLowCardinality(header.getByName(key_name).type)));
+                for (size_t i = 0; i < join_config.broadcast_build_spill_buckets; ++i)
+                    spilled_buckets.emplace_back(header, global_context->getTempDataOnDisk().get());
+                for (auto & raw_block : raw_blocks)
+                    spill_block(raw_block);
+                raw_blocks.clear();
+                releaseMemory(reserved_bytes);
+                reserved_bytes = 0;
             }
+        }
+        if (!spilled_buckets.empty())
+        {
+            for (auto & bucket : spilled_buckets)
+                bucket.finishWriting();
+            return;
+        }
+
+        /// Only the joins which drop the unmatched probe rows could filter the probe side by the build side keys.
+        auto build_key_filters = [&]
+        {
+            const bool drops_unmatched_probe_rows
+                = isInner(kind) || (kind == DB::JoinKind::Left && strictness == DB::JoinStrictness::Semi && !is_existence_join);
+            if (!join_config.enable_runtime_join_filter || !drops_unmatched_probe_rows || only_one_column)
+                return;
+            for (const auto & key_name : key_names)
+                if (auto filter = JoinKeyFilter::build(data, key_name, join_config.runtime_join_bloom_filter_max_rows))
+                    key_filters.emplace(key_name, std::move(*filter));
+        };
 
-            DB::Block final_block(columns);
-            info.update(final_block);
-            data.emplace_back(std::move(final_block));
+        data.resize(raw_blocks.size());
+        const size_t threads = std::min(join_config.broadcast_build_threads, raw_blocks.size());
+        if (threads <= 1 || only_one_column)
+        {
+            for (size_t i = 0; i < raw_blocks.size(); ++i)
+                data[i] = convert_block(raw_blocks[i]);
+            build_key_filters();
+            return;
+        }
+        FreeThreadPool thread_pool(
+            CurrentMetrics::LocalThread,
+            CurrentMetrics::LocalThreadActive,
+            CurrentMetrics::LocalThreadScheduled,
+            threads,
+            threads,
+            raw_blocks.size());
+        for (size_t i = 0; i < raw_blocks.size(); ++i)
+        {
+            thread_pool.scheduleOrThrow(
+                [&, i]
+                {
+                    data[i] = convert_block(raw_blocks[i]);
+                    raw_blocks[i] = {};
+                });
         }
+        thread_pool.wait();
+        build_key_filters();
     };
     /// Record memory usage in Total Memory Tracker
     ThreadFromGlobalPoolNoTracingContextPropagation thread(collect_data);
@@ -175,7 +326,7 @@ std::shared_ptr<StorageJoinFromReadBuffer> buildJoin(
 
     ColumnsDescription columns_description(header.getNamesAndTypesList());
 
-    return make_shared<StorageJoinFromReadBuffer>(
+    auto storage = make_shared<StorageJoinFromReadBuffer>(
         data,
         row_count,
         key_names,
@@ -188,7 +339,13 @@ std::shared_ptr<StorageJoinFromReadBuffer> buildJoin(
         key,
         true,
         is_null_aware_anti_join,
-        has_null_key_values);
+        has_null_key_values,
+        std::move(spilled_buckets),
+        std::move(key_filters),
+        reserved_bytes);
+    /// The storage replaced the reservation with the bytes of its hash table.
+    reserved_bytes = 0;
+    return storage;
 }
 
 void init(JNIEnv * env)
@@ -44,6 +44,14 @@ std::shared_ptr<StorageJoinFromReadBuffer> buildJoin(
 void cleanBuildHashTable(const std::string & hash_table_id, jlong instance);
 std::shared_ptr<StorageJoinFromReadBuffer> getJoin(const std::string & hash_table_id);
 
+/// Broadcast hash tables are shared by all tasks of the executor, so their memory is not attributed to any task.
+/// It is accounted here from build until the last reference to the table is released.
+void reserveMemory(size_t bytes);
+/// Reserves the bytes only if the usage stays within the limit, 0 means no limit.
+bool tryReserveMemory(size_t bytes, size_t limit);
+void releaseMemory(size_t bytes);
+size_t memoryUsage();
+
 
 void init(JNIEnv *);
 void destroy(JNIEnv *);
@@ -0,0 +1,251 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BucketedBroadcastJoin.h"
+
+#include <algorithm>
+#include <deque>
+#include <DataTypes/DataTypeLowCardinality.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Interpreters/HashJoin/HashJoin.h>
+#include <Interpreters/TableJoin.h>
+#include <Interpreters/castColumn.h>
+#include <Join/StorageJoinFromReadBuffer.h>
+#include <Common/WeakHash.h>
+#include <Common/logger_useful.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+extern const int LOGICAL_ERROR;
+}
+}
+
+namespace local_engine
+{
+namespace
+{
+/// Joins the probe rows of one bucket written into disk with the hash table of the build bucket.
+class DelayedProbeBlocks : public DB::IBlocksStream
+{
+public:
+    DelayedProbeBlocks(DB::TemporaryBlockStreamReaderHolder reader_, std::shared_ptr<DB::HashJoin> join_)
+        : reader(std::move(reader_)), join(std::move(join_))
+    {
+    }
+
+protected:
+    DB::Block nextImpl() override
+    {
+        DB::ExtraBlockPtr not_processed;
+        DB::Block block;
+        {
+            std::lock_guard lock(mutex);
+            if (!not_processed_blocks.empty())
+            {
+                not_processed = std::move(not_processed_blocks.front());
+                not_processed_blocks.pop_front();
+                block = std::move(not_processed->block);
+                not_processed.reset();
+            }
+            else
+            {
+                block = reader->read();
+                if (!block.rows())
+                    return {};
+            }
+        }
+        join->joinBlock(block, not_processed);
+        if (not_processed)
+        {
+            std::lock_guard lock(mutex);
+            not_processed_blocks.emplace_back(std::move(not_processed));
+        }
+        return block;
+    }
+
+private:
+    std::mutex mutex;
+    DB::TemporaryBlockStreamReaderHolder reader;
+    std::shared_ptr<DB::HashJoin> join;
+    /// Rest of the probe blocks whose joined rows exceeded the max block size.
+    std::deque<DB::ExtraBlockPtr> not_processed_blocks;
+};
+}
+
+BucketedBroadcastJoin::BucketedBroadcastJoin(
+    std::shared_ptr<DB::TableJoin> table_join_,
+    std::shared_ptr<StorageJoinFromReadBuffer> storage_join_,
+    DB::TemporaryDataOnDiskScopePtr tmp_data_)
+    : table_join(std::move(table_join_)), storage_join(std::move(storage_join_)), tmp_data(std::move(tmp_data_))
+{
+    if (!storage_join->isSpilled())
+        throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "BucketedBroadcastJoin requires a spilled broadcast table");
+    if (!isSupported(*table_join))
+        throw DB::Exception(
+            DB::ErrorCodes::LOGICAL_ERROR,
+            "Join {} {} is not supported by BucketedBroadcastJoin",
+            DB::toString(table_join->kind()),
+            DB::toString(table_join->strictness()));
+
+    /// The build side was partitioned by its keys in the order of the broadcast table, the probe side must hash the
+    /// matching keys in the same order.
+    const auto & clause = table_join->getOnlyClause();
+    const auto & right_sample_block = storage_join->getRightSampleBlock();
+    for (const auto & build_key : storage_join->getKeyNames())
+    {
+        auto it = std::ranges::find(clause.key_names_right, build_key);
+        if (it == clause.key_names_right.end())
+            throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Key {} of the spilled broadcast table is not a join key", build_key);
+        probe_key_names.emplace_back(clause.key_names_left[it - clause.key_names_right.begin()]);
+        key_types.emplace_back(DB::removeNullable(DB::recursiveRemoveLowCardinality(right_sample_block.getByName(build_key).type)));
+    }
+
+    empty_join = std::make_shared<DB::HashJoin>(table_join, right_sample_block);
+    probe_buckets.resize(storage_join->getSpilledBuckets());
+    for (auto & bucket : probe_buckets)
+        bucket = std::make_unique<ProbeBucket>();
+}
+
+bool BucketedBroadcastJoin::isSupported(const DB::TableJoin & table_join)
+{
+    const auto kind = table_join.kind();
+    return (DB::isInner(kind) || DB::isLeft(kind)) && table_join.strictness() != DB::JoinStrictness::Asof && table_join.oneDisjunct()
+        && !table_join.getOnlyClause().key_names_right.empty();
+}
+
+DB::Blocks BucketedBroadcastJoin::scatterByKeys(
+    const DB::Block & block, const DB::Names & key_names, const DB::DataTypes & key_types, size_t num_buckets)
+{
+    const size_t rows = block.rows();
+    DB::WeakHash32 hash(rows);
+    for (size_t i = 0; i < key_names.size(); ++i)
+    {
+        const auto & key = block.getByName(key_names[i]);
+        const auto key_type = DB::isNullableOrLowCardinalityNullable(key.type) ? DB::makeNullable(key_types[i]) : key_types[i];
+        hash.update(DB::castColumn(key, key_type)->convertToFullIfNeeded()->getWeakHash32());
+    }
+
+    DB::IColumn::Selector selector(rows);
+    const auto & hash_data = hash.getData();
+    for (size_t row = 0; row < rows; ++row)
+        selector[row] = hash_data[row] % num_buckets;
+
+    DB::Blocks buckets(num_buckets, block.cloneEmpty());
+    for (size_t i = 0; i < block.columns(); ++i)
+    {
+        auto columns = block.getByPosition(i).column->convertToFullIfNeeded()->scatter(num_buckets, selector);
+        for (size_t bucket = 0; bucket < num_buckets; ++bucket)
+            buckets[bucket].getByPosition(i).column = std::move(columns[bucket]);
+    }
+    return buckets;
+}
+
+bool BucketedBroadcastJoin::addBlockToJoin(const DB::Block & block, bool /*check_limits*/)
+{
+    if (block.rows())
+        throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "BucketedBroadcastJoin doesn't accept right blocks");
+    return true;
+}
+
+void BucketedBroadcastJoin::checkTypesOfKeys(const DB::Block & block) const
+{
+    empty_join->checkTypesOfKeys(block);
+}
+
+void BucketedBroadcastJoin::joinBlock(DB::Block & block, std::shared_ptr<DB::ExtraBlock> & not_processed)
+{
+    if (!block.rows())
+    {
+        empty_join->joinBlock(block, not_processed);
+        return;
+    }
+
+    std::call_once(
+        first_bucket_loaded,
+        [&]
+        {
+            auto join = storage_join->buildSpilledBucketJoin(0, table_join);
+            std::lock_guard lock(current_join_mutex);
+            current_join = std::move(join);
+        });
+
+    auto blocks = scatterByKeys(block, probe_key_names, key_types, probe_buckets.size());
+    for (size_t i = 1; i < blocks.size(); ++i)
+    {
+        if (!blocks[i].rows())
+            continue;
+        auto & bucket = *probe_buckets[i];
+        std::lock_guard lock(bucket.mutex);
+        if (!bucket.stream)
+            bucket.stream.emplace(blocks[i].cloneEmpty(), tmp_data.get());
+        (*bucket.stream)->write(blocks[i]);
+    }
+    /// The rows not processed because of the max block size all belong to bucket 0, they are scattered into it again.
+    block = std::move(blocks[0]);
+    getCurrentJoin()->joinBlock(block, not_processed);
+}
+
+DB::IBlocksStreamPtr BucketedBroadcastJoin::getDelayedBlocks()
+{
+    size_t bucket;
+    {
+        std::lock_guard lock(current_join_mutex);
+        /// Release the hash table of the previous bucket before the next one is built.
+        current_join.reset();
+        do
+            ++current_bucket;
+        while (current_bucket < probe_buckets.size() && !probe_buckets[current_bucket]->stream);
+        bucket = current_bucket;
+    }
+    if (bucket >= probe_buckets.size())
+        return nullptr;
+
+    auto & stream = *probe_buckets[bucket]->stream;
+    stream.finishWriting();
+    auto join = storage_join->buildSpilledBucketJoin(bucket, table_join);
+    LOG_DEBUG(
+        getLogger("BucketedBroadcastJoin"),
+        "Joining bucket {} of {}, build side rows: {}",
+        bucket,
+        probe_buckets.size(),
+        join->getTotalRowCount());
+    {
+        std::lock_guard lock(current_join_mutex);
+        current_join = join;
+    }
+    return std::make_shared<DelayedProbeBlocks>(stream.getReadStream(), join);
+}
+
+std::shared_ptr<DB::HashJoin> BucketedBroadcastJoin::getCurrentJoin() const
+{
+    std::lock_guard lock(current_join_mutex);
+    return current_join;
+}
+
+size_t BucketedBroadcastJoin::getTotalRowCount() const
+{
+    auto join = getCurrentJoin();
+    return join ? join->getTotalRowCount() : 0;
+}
+
+size_t BucketedBroadcastJoin::getTotalByteCount() const
+{
+    auto join = getCurrentJoin();
+    return join ? join->getTotalByteCount() : 0;
+}
+}
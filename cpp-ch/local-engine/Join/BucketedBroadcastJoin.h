@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <mutex>
+#include <Interpreters/IJoin.h>
+#include <Interpreters/TemporaryDataOnDisk.h>
+
+namespace DB
+{
+class HashJoin;
+}
+
+namespace local_engine
+{
+class StorageJoinFromReadBuffer;
+
+/// Joins the probe side of one task with a broadcast build side which was spilled into disk. The build side is
+/// partitioned by the hash of its keys once, when it's spilled, and its buckets are shared by all the tasks of the
+/// executor. Each task partitions its probe rows the same way: the rows of bucket 0 are joined as they come, the others
+/// are written into temporary files of the task and joined after the probe side is finished, one bucket at a time with
+/// an in-memory hash table of the build bucket.
+class BucketedBroadcastJoin : public DB::IJoin
+{
+public:
+    BucketedBroadcastJoin(
+        std::shared_ptr<DB::TableJoin> table_join_,
+        std::shared_ptr<StorageJoinFromReadBuffer> storage_join_,
+        DB::TemporaryDataOnDiskScopePtr tmp_data_);
+
+    /// Only the joins driven by the probe rows could be split into buckets. A join which emits the unmatched build rows
+    /// would emit them in every task.
+    static bool isSupported(const DB::TableJoin & table_join);
+
+    /// Splits the rows of the block by the hash of the key columns. The keys are hashed as key_types, so that the build
+    /// and probe sides put the same keys into the same bucket even if only one of them is nullable.
+    static DB::Blocks
+    scatterByKeys(const DB::Block & block, const DB::Names & key_names, const DB::DataTypes & key_types, size_t num_buckets);
+
+    std::string getName() const override { return "BucketedBroadcastJoin"; }
+    const DB::TableJoin & getTableJoin() const override { return *table_join; }
+
+    /// The build side is the spilled broadcast table, no right input is expected.
+    bool addBlockToJoin(const DB::Block & block, bool check_limits) override;
+    void checkTypesOfKeys(const DB::Block & block) const override;
+    void joinBlock(DB::Block & block, std::shared_ptr<DB::ExtraBlock> & not_processed) override;
+
+    size_t getTotalRowCount() const override;
+    size_t getTotalByteCount() const override;
+    bool alwaysReturnsEmptySet() const override { return false; }
+
+    DB::IBlocksStreamPtr
+    getNonJoinedBlocks(const DB::Block & /*left_sample_block*/, const DB::Block & /*result_sample_block*/, UInt64 /*max_block_size*/)
+        const override
+    {
+        return nullptr;
+    }
+
+    bool hasDelayedBlocks() const override { return true; }
+    DB::IBlocksStreamPtr getDelayedBlocks() override;
+
+private:
+    struct ProbeBucket
+    {
+        std::mutex mutex;
+        std::optional<DB::TemporaryBlockStreamHolder> stream;
+    };
+
+    std::shared_ptr<DB::TableJoin> table_join;
+    std::shared_ptr<StorageJoinFromReadBuffer> storage_join;
+    DB::TemporaryDataOnDiskScopePtr tmp_data;
+    /// The probe keys matching the build side keys the buckets are partitioned by, in the same order.
+    DB::Names probe_key_names;
+    DB::DataTypes key_types;
+    /// Only used to get the header of the joined blocks.
+    std::shared_ptr<DB::HashJoin> empty_join;
+    std::vector<std::unique_ptr<ProbeBucket>> probe_buckets;
+
+    std::once_flag first_bucket_loaded;
+    mutable std::mutex current_join_mutex;
+    size_t current_bucket = 0;
+    std::shared_ptr<DB::HashJoin> current_join;
+
+    std::shared_ptr<DB::HashJoin> getCurrentJoin() const;
+};
+}
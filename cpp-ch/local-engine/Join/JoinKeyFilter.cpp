@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "JoinKeyFilter.h"
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <IO/WriteBufferFromString.h>
+#include <Interpreters/castColumn.h>
+#include <Common/Arena.h>
+
+using namespace DB;
+
+namespace local_engine
+{
+namespace
+{
+bool supportsRange(const DataTypePtr & type)
+{
+    WhichDataType which(type);
+    /// Floats are excluded, NaN breaks the ordering.
+    return which.isNativeInt() || which.isNativeUInt() || which.isDecimal() || which.isDate() || which.isDate32() || which.isDateTime()
+        || which.isDateTime64() || which.isString();
+}
+
+bool supportsBloomFilter(const DataTypePtr & type)
+{
+    WhichDataType which(type);
+    return which.isNativeInt() || which.isNativeUInt();
+}
+
+String buildBloomFilter(const Blocks & blocks, const String & key_name, size_t rows)
+{
+    /// 16 bits per row, keeps the false positive rate of a split block filter below 1% even if all the keys are distinct.
+    Array parameters{Field(static_cast<UInt64>(rows * 2)), Field(static_cast<UInt64>(1)), Field(static_cast<UInt64>(0)), Field(static_cast<UInt64>(1))};
+    const auto argument_type = makeNullable(std::make_shared<DataTypeInt64>());
+    AggregateFunctionProperties properties;
+    auto agg_func = AggregateFunctionFactory::instance().get("groupBloomFilter", NullsAction::EMPTY, {argument_type}, parameters, properties);
+
+    Arena arena;
+    AggregateDataPtr place = arena.alignedAlloc(agg_func->sizeOfData(), agg_func->alignOfData());
+    agg_func->create(place);
+    try
+    {
+        for (const auto & block : blocks)
+        {
+            if (!block.rows())
+                continue;
+            const auto & key = block.getByName(key_name);
+            auto column = castColumn(key, argument_type);
+            const IColumn * columns[] = {column.get()};
+            agg_func->addBatchSinglePlace(0, column->size(), place, columns, &arena);
+        }
+        WriteBufferFromOwnString out;
+        agg_func->serialize(place, out);
+        agg_func->destroy(place);
+        return out.str();
+    }
+    catch (...)
+    {
+        agg_func->destroy(place);
+        throw;
+    }
+}
+}
+
+std::optional<JoinKeyFilter> JoinKeyFilter::build(const Blocks & blocks, const String & key_name, size_t bloom_filter_max_rows)
+{
+    if (blocks.empty())
+        return {};
+    const auto type = removeNullable(blocks.front().getByName(key_name).type);
+    if (!supportsRange(type))
+        return {};
+
+    JoinKeyFilter filter;
+    filter.type = type;
+    size_t rows = 0;
+    for (const auto & block : blocks)
+    {
+        if (!block.rows())
+            continue;
+        rows += block.rows();
+        Field block_min;
+        Field block_max;
+        /// Null values are ignored, they never match.
+        block.getByName(key_name).column->getExtremes(block_min, block_max);
+        if (block_min.isNull())
+            continue;
+        if (filter.min.isNull() || block_min < filter.min)
+            filter.min = block_min;
+        if (filter.max.isNull() || filter.max < block_max)
+            filter.max = block_max;
+    }
+    if (filter.min.isNull())
+        return {};
+
+    if (supportsBloomFilter(type) && rows <= bloom_filter_max_rows)
+        filter.bloom_filter = buildBloomFilter(blocks, key_name, rows);
+    return filter;
+}
+}
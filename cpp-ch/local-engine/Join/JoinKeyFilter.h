@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <optional>
+#include <unordered_map>
+#include <Core/Block.h>
+#include <Core/Field.h>
+
+namespace local_engine
+{
+
+/// Value range and bloom filter of one join key of a broadcast build side. A probe row whose key is out of the range
+/// or not in the bloom filter cannot find a match, so for joins which drop unmatched probe rows they are applied on
+/// the probe side before the join. Pushed into the scan they let MergeTree and parquet skip granules, row groups and
+/// pages, and filter the rows in PREWHERE before the other columns are read.
+struct JoinKeyFilter
+{
+    DB::DataTypePtr type;
+    DB::Field min;
+    DB::Field max;
+    /// Serialized groupBloomFilter state over Nullable(Int64), the first argument of bloomFilterContains. Only integer
+    /// keys have one.
+    String bloom_filter;
+
+    /// Returns nullopt if the key type is not supported or all the keys are null. The bloom filter is only built if the
+    /// build side has at most bloom_filter_max_rows rows.
+    static std::optional<JoinKeyFilter> build(const DB::Blocks & blocks, const String & key_name, size_t bloom_filter_max_rows);
+};
+
+/// Build side key name -> filter
+using JoinKeyFilters = std::unordered_map<String, JoinKeyFilter>;
+}
@@ -19,6 +19,7 @@
 #include <Interpreters/Context.h>
 #include <Interpreters/HashJoin/HashJoin.h>
 #include <Interpreters/TableJoin.h>
+#include <Join/BroadCastJoinBuilder.h>
 #include <Common/CHUtil.h>
 #include <Common/Exception.h>
 #include <Common/logger_useful.h>
@@ -73,8 +74,12 @@ StorageJoinFromReadBuffer::StorageJoinFromReadBuffer(
     const String & comment,
     const bool overwrite_,
     bool is_null_aware_anti_join_,
-    bool has_null_key_values_)
+    bool has_null_key_values_,
+    std::vector<DB::TemporaryBlockStreamHolder> spilled_buckets_,
+    JoinKeyFilters key_filters_,
+    size_t reserved_bytes_)
     : key_names(key_names_), use_nulls(use_nulls_), row_count(row_count_), overwrite(overwrite_), is_null_aware_anti_join(is_null_aware_anti_join_), has_null_key_value(has_null_key_values_)
+    , spilled_buckets(std::move(spilled_buckets_)), key_filters(std::move(key_filters_))
 {
     is_empty_hash_table = row_count < 1;
     storage_metadata.setColumns(columns);
@@ -94,10 +99,39 @@ StorageJoinFromReadBuffer::StorageJoinFromReadBuffer(
 
     right_sample_block = rightSampleBlock(use_nulls, storage_metadata, table_join->kind());
     /// If there is mixed join conditions, need to build the hash join lazily, which rely on the real table join.
-    if (!has_mixed_join_condition)
+    /// A spilled build side is never loaded into memory as a whole, tasks join it bucket by bucket.
+    if (!spilled_buckets.empty())
+        LOG_INFO(
+            getLogger("StorageJoinFromReadBuffer"),
+            "Broadcast table {} is spilled into {} buckets, rows: {}",
+            comment,
+            spilled_buckets.size(),
+            row_count);
+    else if (!has_mixed_join_condition)
         buildJoin(data, right_sample_block, table_join);
     else
         collectAllInputs(data, right_sample_block);
+    /// Take over the bytes the builder reserved while deserializing. Nothing below throws, if anything above does the
+    /// builder still owns and releases them.
+    accounted_bytes = reserved_bytes_;
+    updateAccountedMemory();
+}
+
+StorageJoinFromReadBuffer::~StorageJoinFromReadBuffer()
+{
+    BroadCastJoinBuilder::releaseMemory(accounted_bytes);
+}
+
+void StorageJoinFromReadBuffer::updateAccountedMemory()
+{
+    size_t bytes = 0;
+    if (join)
+        bytes = join->getTotalByteCount();
+    for (const auto & block : input_blocks)
+        bytes += block.allocatedBytes();
+    BroadCastJoinBuilder::releaseMemory(accounted_bytes);
+    BroadCastJoinBuilder::reserveMemory(bytes);
+    accounted_bytes = bytes;
 }
 
 void StorageJoinFromReadBuffer::buildJoin(Blocks & data, const Block header, std::shared_ptr<DB::TableJoin> analyzed_join)
@@ -146,6 +180,7 @@ void StorageJoinFromReadBuffer::buildJoinLazily(DB::Block header, std::shared_pt
             join->addBlockToJoin(final_block, true);
             input_blocks.pop_front();
         }
+        updateAccountedMemory();
     };
 
     /// Record memory usage in Total Memory Tracker
@@ -153,6 +188,28 @@ void StorageJoinFromReadBuffer::buildJoinLazily(DB::Block header, std::shared_pt
     thread.join();
 }
 
+std::shared_ptr<DB::HashJoin> StorageJoinFromReadBuffer::buildSpilledBucketJoin(size_t bucket, std::shared_ptr<DB::TableJoin> analyzed_join)
+{
+    if (bucket >= spilled_buckets.size())
+        throw Exception(ErrorCodes::LOGICAL_ERROR, "Broadcast table {} has no spilled bucket {}", storage_metadata.comment, bucket);
+    std::optional<DB::TemporaryBlockStreamReaderHolder> reader;
+    {
+        std::unique_lock lock(join_mutex);
+        reader.emplace(spilled_buckets[bucket].getReadStream());
+    }
+    auto bucket_join = std::make_shared<HashJoin>(analyzed_join, right_sample_block, overwrite);
+    while (true)
+    {
+        auto block = (*reader)->read();
+        if (!block.rows())
+            break;
+        DB::ColumnsWithTypeAndName columns;
+        for (size_t i = 0; i < block.columns(); ++i)
+            columns.emplace_back(BlockUtil::convertColumnAsNecessary(block.getByPosition(i), right_sample_block.getByPosition(i)));
+        bucket_join->addBlockToJoin(DB::Block(columns), true);
+    }
+    return bucket_join;
+}
 
 /// The column names of 'rgiht_header' could be different from the ones in `input_blocks`, and we must
 /// use 'right_header' to build the HashJoin. Otherwise, it will cause exceptions with name mismatches.
@@ -167,6 +224,9 @@ DB::JoinPtr StorageJoinFromReadBuffer::getJoinLocked(std::shared_ptr<DB::TableJo
             ErrorCodes::INCOMPATIBLE_TYPE_OF_JOIN,
             "Table {} needs the same join_use_nulls setting as present in LEFT or FULL JOIN",
             storage_metadata.comment);
+    if (isSpilled())
+        throw Exception(
+            ErrorCodes::LOGICAL_ERROR, "Broadcast table {} is spilled, it can only be joined by BucketedBroadcastJoin", storage_metadata.comment);
     buildJoinLazily(getRightSampleBlock(), analyzed_join);
     HashJoinPtr join_clone = std::make_shared<HashJoin>(analyzed_join, right_sample_block);
     /// reuseJoinedData will set the flag `HashJoin::from_storage_join` which is required by `FilledStep`
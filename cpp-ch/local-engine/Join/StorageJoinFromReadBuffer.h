@@ -18,6 +18,8 @@
 #include <shared_mutex>
 #include <Core/Joins.h>
 #include <Interpreters/JoinUtils.h>
+#include <Interpreters/TemporaryDataOnDisk.h>
+#include <Join/JoinKeyFilter.h>
 #include <Storages/StorageInMemoryMetadata.h>
 
 namespace DB
@@ -32,7 +34,7 @@ class ReadBuffer;
 namespace local_engine
 {
 
-class StorageJoinFromReadBuffer
+class StorageJoinFromReadBuffer : public std::enable_shared_from_this<StorageJoinFromReadBuffer>
 {
 public:
     StorageJoinFromReadBuffer(
@@ -48,7 +50,11 @@ public:
         const String & comment,
         bool overwrite_,
         bool is_null_aware_anti_join_,
-        bool has_null_key_values_);
+        bool has_null_key_values_,
+        std::vector<DB::TemporaryBlockStreamHolder> spilled_buckets_ = {},
+        JoinKeyFilters key_filters_ = {},
+        size_t reserved_bytes_ = 0);
+    ~StorageJoinFromReadBuffer();
 
     bool has_null_key_value = false;
     bool is_empty_hash_table = false;
@@ -59,6 +65,19 @@ public:
     DB::JoinPtr getJoinLocked(std::shared_ptr<DB::TableJoin> analyzed_join, DB::ContextPtr context);
     const DB::Block & getRightSampleBlock() const { return right_sample_block; }
 
+    /// The build side was too large to be kept in memory and has been partitioned by the hash of its keys into
+    /// temporary files, see BucketedBroadcastJoin.
+    bool isSpilled() const { return !spilled_buckets.empty(); }
+    size_t getSpilledBuckets() const { return spilled_buckets.size(); }
+    /// Keys of the build side, in the order the spilled buckets are partitioned by.
+    const DB::Names & getKeyNames() const { return key_names; }
+    /// Build a hash table of one spilled bucket. It's owned by the caller and not accounted in the executor level
+    /// broadcast memory.
+    std::shared_ptr<DB::HashJoin> buildSpilledBucketJoin(size_t bucket, std::shared_ptr<DB::TableJoin> analyzed_join);
+
+    /// Filters of the build side keys, by the key names of the right sample block. Empty if they are not built.
+    const JoinKeyFilters & getKeyFilters() const { return key_filters; }
+
 private:
     DB::StorageInMemoryMetadata storage_metadata;
     DB::Names key_names;
@@ -68,9 +87,14 @@ private:
     DB::Block right_sample_block;
     std::shared_mutex join_mutex;
     std::list<DB::Block> input_blocks;
+    std::vector<DB::TemporaryBlockStreamHolder> spilled_buckets;
+    JoinKeyFilters key_filters;
     std::shared_ptr<DB::HashJoin> join = nullptr;
     bool is_null_aware_anti_join;
+    /// Bytes accounted in the executor level broadcast memory, released when the last reference is gone.
+    size_t accounted_bytes = 0;
 
+    void updateAccountedMemory();
     void readAllBlocksFromInput(DB::ReadBuffer & in);
     void buildJoin(DB::Blocks & data, const DB::Block header, std::shared_ptr<DB::TableJoin> analyzed_join);
     void collectAllInputs(DB::Blocks & data, const DB::Block header);
@@ -16,12 +16,16 @@
  */
 
 #include "GraceAggregatingTransform.h"
+#include <bit>
+#include <IO/SharedThreadPools.h>
 #include <Common/BitHelpers.h>
 #include <Common/CHUtil.h>
 #include <Common/CurrentThread.h>
 #include <Common/GlutenConfig.h>
 #include <Common/QueryContext.h>
+#include <Common/WeakHash.h>
 #include <Common/formatReadable.h>
+#include <base/scope_guard.h>
 
 namespace DB::ErrorCodes
 {
@@ -59,23 +63,41 @@ GraceAggregatingTransform::GraceAggregatingTransform(
     enable_spill_test = config.enable_spill_test;
     if (enable_spill_test)
         buckets.emplace(1, BufferFileStream());
+    enable_async_spill = config.enable_async_spill;
+    enable_spill_prefetch = config.enable_spill_prefetch;
+    max_spill_prefetch_bytes = config.max_spill_prefetch_bytes;
+    enable_adaptive_buckets = config.enable_adaptive_buckets;
+    if (enable_async_spill || enable_spill_prefetch)
+        spill_runner = DB::threadPoolCallbackRunnerUnsafe<void>(DB::getIOThreadPool().get(), "GraceAggSpill");
     current_data_variants = std::make_shared<DB::AggregatedDataVariants>();
 }
 
 GraceAggregatingTransform::~GraceAggregatingTransform()
 {
+    /// Background tasks refer to this transform, they must be finished before it's destroyed.
+    for (auto & [_, file_stream] : buckets)
+    {
+        if (file_stream.pending_flush.valid())
+            file_stream.pending_flush.wait();
+        if (file_stream.prefetch && file_stream.prefetch->task.valid())
+            file_stream.prefetch->task.wait();
+    }
     LOG_INFO(
         logger,
         "Metrics. total_input_blocks: {}, total_input_rows: {}, total_output_blocks: {}, total_output_rows: {}, total_spill_disk_bytes: "
-        "{}, total_spill_disk_time: {}, total_read_disk_time: {}, total_scatter_time: {}",
+        "{}, total_spill_disk_time: {}, total_read_disk_time: {}, total_scatter_time: {}, total_spill_wait_time: {}, "
+        "total_prefetch_read_time: {}, total_prefetch_wait_time: {}",
         total_input_blocks,
         total_input_rows,
         total_output_blocks,
         total_output_rows,
-        total_spill_disk_bytes,
-        total_spill_disk_time,
+        total_spill_disk_bytes.load(),
+        total_spill_disk_time.load(),
         total_read_disk_time,
-        total_scatter_time);
+        total_scatter_time,
+        total_spill_wait_time,
+        total_prefetch_read_time.load(),
+        total_prefetch_wait_time);
 }
 
 GraceAggregatingTransform::Status GraceAggregatingTransform::prepare()
@@ -146,6 +168,8 @@ void GraceAggregatingTransform::work()
     {
         assert(!input_finished);
         auto block = header.cloneWithColumns(input_chunk.detachColumns());
+        if (enable_adaptive_buckets)
+            updateKeysEstimator(block);
         mergeOneBlock(block, true);
         has_input = false;
     }
@@ -193,6 +217,13 @@ bool GraceAggregatingTransform::extendBuckets()
 
     auto current_size = getBucketsNum();
     auto next_size = current_size * 2;
+    /// Buckets number must be kept as power of two, so the rows in bucket i are scattered into buckets >= i.
+    if (enable_adaptive_buckets)
+    {
+        /// An estimation over the limit still extends the buckets as far as the limit allows.
+        auto estimated_size = estimateBucketsNum();
+        next_size = std::max(next_size, std::min(estimated_size, std::bit_floor(max_buckets)));
+    }
     /// We have a soft limit on the number of buckets. When throw_on_overflow_buckets = false, we just
     /// continue to run with the current number of buckets until the executor is killed by spark scheduler.
     if (next_size > max_buckets)
@@ -211,6 +242,40 @@ bool GraceAggregatingTransform::extendBuckets()
     return true;
 }
 
+void GraceAggregatingTransform::updateKeysEstimator(const DB::Block & block)
+{
+    if (!block.rows() || params->params.keys.empty())
+        return;
+    DB::WeakHash32 hash(block.rows());
+    for (const auto & key : params->params.keys)
+        hash.update(block.getByName(key).column->getWeakHash32());
+    for (const auto & value : hash.getData())
+        keys_estimator.insert(value);
+}
+
+size_t GraceAggregatingTransform::estimateBucketsNum()
+{
+    if (!current_data_variants || !current_data_variants->size())
+        return 0;
+    auto memory_soft_limit = DB::CurrentThread::getGroup()->memory_tracker.getSoftLimit();
+    if (!memory_soft_limit)
+        return 0;
+    auto max_mem_used = static_cast<double>(memory_soft_limit) * max_allowed_memory_usage_ratio;
+    auto key_memory_usage
+        = per_key_memory_usage > 0 ? per_key_memory_usage : currentThreadGroupMemoryUsage() * 1.0 / current_data_variants->size();
+    /// Converting the hash table into blocks takes about the same memory as the hash table, so a bucket could only use half
+    /// of the memory.
+    auto estimated_keys = keys_estimator.size();
+    auto buckets_num = static_cast<size_t>(estimated_keys * key_memory_usage * 2 / max_mem_used) + 1;
+    LOG_DEBUG(
+        logger,
+        "Estimated keys: {}, per key memory usage: {}, estimated buckets num: {}",
+        estimated_keys,
+        ReadableSize(key_memory_usage),
+        buckets_num);
+    return roundUpToPowerOfTwoOrZero(buckets_num);
+}
+
 void GraceAggregatingTransform::rehashDataVariants()
 {
     auto before_memoery_usage = currentThreadGroupMemoryUsage();
@@ -337,34 +402,157 @@ static size_t flushBlocksInfoDisk(std::optional<DB::TemporaryBlockStreamHolder>&
 
 size_t GraceAggregatingTransform::flushBucket(size_t bucket_index)
 {
-    Stopwatch watch;
     auto & file_stream = buckets[bucket_index];
-    size_t flush_bytes = 0;
-    if (!file_stream.original_blocks.empty())
+    waitBucketFlushed(file_stream);
+    if (file_stream.original_blocks.empty() && file_stream.intermediate_blocks.empty())
+        return 0;
+    if (!file_stream.original_blocks.empty() && !file_stream.original_file_stream)
+        file_stream.original_file_stream = DB::TemporaryBlockStreamHolder(header, tmp_data_disk.get());
+    if (!file_stream.intermediate_blocks.empty() && !file_stream.intermediate_file_stream)
     {
-        if (!file_stream.original_file_stream)
-            file_stream.original_file_stream = DB::TemporaryBlockStreamHolder(header, tmp_data_disk.get());
-        flush_bytes += flushBlocksInfoDisk(file_stream.original_file_stream, file_stream.original_blocks);
+        auto intermediate_header = params->aggregator.getHeader(false);
+        file_stream.intermediate_file_stream = DB::TemporaryBlockStreamHolder(intermediate_header, tmp_data_disk.get());
     }
-    if (!file_stream.intermediate_blocks.empty())
+
+    auto flush = [this, &file_stream](std::list<DB::Block> & original_blocks, std::list<DB::Block> & intermediate_blocks)
     {
-        if (!file_stream.intermediate_file_stream)
+        Stopwatch watch;
+        size_t flush_bytes = 0;
+        if (!original_blocks.empty())
+            flush_bytes += flushBlocksInfoDisk(file_stream.original_file_stream, original_blocks);
+        if (!intermediate_blocks.empty())
+            flush_bytes += flushBlocksInfoDisk(file_stream.intermediate_file_stream, intermediate_blocks);
+        total_spill_disk_bytes += flush_bytes;
+        total_spill_disk_time += watch.elapsedMilliseconds();
+        return flush_bytes;
+    };
+    if (!enable_async_spill)
+        return flush(file_stream.original_blocks, file_stream.intermediate_blocks);
+
+    /// The file streams of this bucket are not touched by the processor until the flush is waited.
+    auto original_blocks = std::make_shared<std::list<DB::Block>>(std::move(file_stream.original_blocks));
+    auto intermediate_blocks = std::make_shared<std::list<DB::Block>>(std::move(file_stream.intermediate_blocks));
+    file_stream.original_blocks.clear();
+    file_stream.intermediate_blocks.clear();
+    size_t flushing_bytes = 0;
+    for (const auto & block : *original_blocks)
+        flushing_bytes += block.allocatedBytes();
+    for (const auto & block : *intermediate_blocks)
+        flushing_bytes += block.allocatedBytes();
+    async_flushing_bytes += flushing_bytes;
+    file_stream.pending_flush = spill_runner(
+        [this, flush, original_blocks, intermediate_blocks, flushing_bytes]()
         {
-            auto intermediate_header = params->aggregator.getHeader(false);
-            file_stream.intermediate_file_stream = DB::TemporaryBlockStreamHolder(intermediate_header, tmp_data_disk.get());
+            SCOPE_EXIT({
+                original_blocks->clear();
+                intermediate_blocks->clear();
+                async_flushing_bytes -= flushing_bytes;
+            });
+            flush(*original_blocks, *intermediate_blocks);
+        },
+        {});
+    return 0;
+}
+
+void GraceAggregatingTransform::waitBucketFlushed(BufferFileStream & file_stream)
+{
+    if (!file_stream.pending_flush.valid())
+        return;
+    Stopwatch watch;
+    file_stream.pending_flush.get();
+    total_spill_wait_time += watch.elapsedMilliseconds();
+}
+
+void GraceAggregatingTransform::prefetchBucket(size_t bucket_index)
+{
+    if (!enable_spill_prefetch || bucket_index >= getBucketsNum())
+        return;
+    auto & file_stream = buckets[bucket_index];
+    if (file_stream.prefetch)
+        return;
+    waitBucketFlushed(file_stream);
+    if (!file_stream.intermediate_file_stream && !file_stream.original_file_stream)
+        return;
+
+    /// Take over the files written so far. Blocks flushed into this bucket later go into new files.
+    auto prefetch = std::make_shared<SpillPrefetch>();
+    prefetch->intermediate_file_stream = std::move(file_stream.intermediate_file_stream);
+    prefetch->original_file_stream = std::move(file_stream.original_file_stream);
+    file_stream.intermediate_file_stream.reset();
+    file_stream.original_file_stream.reset();
+    prefetch->task = spill_runner(
+        [this, prefetch]()
+        {
+            Stopwatch watch;
+            size_t prefetched_bytes = 0;
+            auto read_ahead = [&](std::optional<DB::TemporaryBlockStreamHolder> & stream,
+                                  std::optional<DB::TemporaryBlockStreamReaderHolder> & reader,
+                                  std::list<DB::Block> & blocks)
+            {
+                if (!stream)
+                    return;
+                stream->finishWriting();
+                reader.emplace(stream->getReadStream());
+                while (prefetched_bytes < max_spill_prefetch_bytes)
+                {
+                    auto block = (*reader)->read();
+                    if (!block.rows())
+                    {
+                        reader.reset();
+                        break;
+                    }
+                    prefetched_bytes += block.bytes();
+                    blocks.push_back(std::move(block));
+                }
+            };
+            read_ahead(prefetch->intermediate_file_stream, prefetch->intermediate_reader, prefetch->intermediate_blocks);
+            read_ahead(prefetch->original_file_stream, prefetch->original_reader, prefetch->original_blocks);
+            total_prefetch_read_time += watch.elapsedMilliseconds();
+        },
+        {});
+    file_stream.prefetch = std::move(prefetch);
+}
+
+void GraceAggregatingTransform::mergePrefetchedBucket(SpillPrefetch & prefetch, size_t & read_bytes, size_t & read_rows)
+{
+    Stopwatch watch;
+    prefetch.task.get();
+    total_prefetch_wait_time += watch.elapsedMilliseconds();
+
+    auto merge_blocks = [&](std::list<DB::Block> & blocks, std::optional<DB::TemporaryBlockStreamReaderHolder> & reader, bool is_original_block)
+    {
+        while (!blocks.empty())
+        {
+            auto block = std::move(blocks.front());
+            blocks.pop_front();
+            read_bytes += block.bytes();
+            read_rows += block.rows();
+            mergeOneBlock(block, is_original_block);
         }
-        flush_bytes += flushBlocksInfoDisk(file_stream.intermediate_file_stream, file_stream.intermediate_blocks);
-    }
-    total_spill_disk_bytes += flush_bytes;
-    total_spill_disk_time += watch.elapsedMilliseconds();
-    return flush_bytes;
+        /// The rest of the file which is over the prefetch limit.
+        while (reader)
+        {
+            auto block = (*reader)->read();
+            if (!block.rows())
+            {
+                reader.reset();
+                break;
+            }
+            read_bytes += block.bytes();
+            read_rows += block.rows();
+            mergeOneBlock(block, is_original_block);
+        }
+    };
+    merge_blocks(prefetch.intermediate_blocks, prefetch.intermediate_reader, false);
+    merge_blocks(prefetch.original_blocks, prefetch.original_reader, true);
 }
 
 std::unique_ptr<AggregateDataBlockConverter> GraceAggregatingTransform::prepareBucketOutputBlocks(size_t bucket_index)
 {
     auto & buffer_file_stream = buckets[bucket_index];
+    waitBucketFlushed(buffer_file_stream);
     if (!current_data_variants && !buffer_file_stream.intermediate_file_stream && buffer_file_stream.intermediate_blocks.empty()
-        && !buffer_file_stream.original_file_stream && buffer_file_stream.original_blocks.empty())
+        && !buffer_file_stream.original_file_stream && buffer_file_stream.original_blocks.empty() && !buffer_file_stream.prefetch)
     {
         return nullptr;
     }
@@ -375,6 +563,14 @@ std::unique_ptr<AggregateDataBlockConverter> GraceAggregatingTransform::prepareB
 
     checkAndSetupCurrentDataVariants();
 
+    if (buffer_file_stream.prefetch)
+    {
+        mergePrefetchedBucket(*buffer_file_stream.prefetch, read_bytes, read_rows);
+        buffer_file_stream.prefetch = nullptr;
+    }
+    /// Read the next bucket in background while this one is being merged and output.
+    prefetchBucket(bucket_index + 1);
+
     if (buffer_file_stream.intermediate_file_stream)
     {
         buffer_file_stream.intermediate_file_stream->finishWriting();
@@ -543,7 +739,11 @@ bool GraceAggregatingTransform::isMemoryOverflow()
         return false;
     auto max_mem_used = static_cast<size_t>(memory_soft_limit * max_allowed_memory_usage_ratio);
     auto current_result_rows = current_data_variants->size();
+    /// An async flush returns before the blocks are released, without this the overflow would be seen again right
+    /// after flushing and the buckets would be extended for nothing.
     auto current_mem_used = currentThreadGroupMemoryUsage();
+    const size_t flushing_bytes = async_flushing_bytes.load();
+    current_mem_used = current_mem_used > flushing_bytes ? current_mem_used - flushing_bytes : 0;
     if (per_key_memory_usage > 0)
     {
         if (current_mem_used + per_key_memory_usage * current_result_rows >= max_mem_used)
@@ -24,6 +24,8 @@
 #include <Processors/Transforms/AggregatingTransform.h>
 #include <Poco/Logger.h>
 #include <Common/AggregateUtil.h>
+#include <Common/HyperLogLogCounter.h>
+#include <Common/threadPoolCallbackRunner.h>
 
 
 namespace local_engine
@@ -50,6 +52,9 @@ public:
     void work() override;
     String getName() const override { return "GraceAggregatingTransform"; }
 
+    /// visible for UTs
+    size_t getBucketsNum() const { return buckets.size(); }
+
 private:
     bool no_pre_aggregated;
     bool final_output;
@@ -75,6 +80,32 @@ private:
     double max_allowed_memory_usage_ratio = 0.9;
     // configured by max_pending_flush_blocks_per_grace_merging_bucket
     size_t max_pending_flush_blocks_per_bucket = 0;
+    // Write spilled blocks in background threads.
+    bool enable_async_spill = false;
+    // Read ahead the spilled data of the next bucket while merging the current one.
+    bool enable_spill_prefetch = false;
+    size_t max_spill_prefetch_bytes = 0;
+    DB::ThreadPoolCallbackRunnerUnsafe<void> spill_runner;
+    /// Bytes of the blocks handed to background flushes and not released yet. They are about to be freed, so they
+    /// don't count for the memory overflow check.
+    std::atomic<size_t> async_flushing_bytes = 0;
+    // Extend the buckets by the estimated distinct keys number rather than doubling them.
+    bool enable_adaptive_buckets = false;
+    /// Estimate the distinct keys of the input blocks.
+    HyperLogLogCounter<12> keys_estimator;
+
+    /// The spilled files of a bucket which are being read in background.
+    struct SpillPrefetch
+    {
+        std::optional<DB::TemporaryBlockStreamHolder> intermediate_file_stream;
+        std::optional<DB::TemporaryBlockStreamHolder> original_file_stream;
+        /// Readers keep the position where the prefetch stopped, the rest is read on demand.
+        std::optional<DB::TemporaryBlockStreamReaderHolder> intermediate_reader;
+        std::optional<DB::TemporaryBlockStreamReaderHolder> original_reader;
+        std::list<DB::Block> intermediate_blocks;
+        std::list<DB::Block> original_blocks;
+        std::future<void> task;
+    };
 
     struct BufferFileStream
     {
@@ -87,17 +118,28 @@ private:
         /// Only be used when there is no pre-aggregated step
         std::optional<DB::TemporaryBlockStreamHolder> original_file_stream;
         size_t pending_bytes = 0;
+        /// The background flush of this bucket, there is at most one at a time.
+        std::future<void> pending_flush;
+        std::shared_ptr<SpillPrefetch> prefetch;
     };
     std::unordered_map<size_t, BufferFileStream> buckets;
 
-    size_t getBucketsNum() const { return buckets.size(); }
     bool extendBuckets();
+    void updateKeysEstimator(const DB::Block & block);
+    /// The buckets number with which the estimated keys fit in memory, 0 if it's unknown.
+    size_t estimateBucketsNum();
     void rehashDataVariants();
     DB::Blocks scatterBlock(const DB::Block & block);
     /// Add a block into a bucket, if the pending bytes reaches limit, flush it into disk.
     void addBlockIntoFileBucket(size_t bucket_index, const DB::Block & block, bool is_original_block);
     void flushBuckets();
+    /// Return the flushed bytes. When async spill is enabled, the blocks are written in background and 0 is returned.
     size_t flushBucket(size_t bucket_index);
+    void waitBucketFlushed(BufferFileStream & file_stream);
+    /// Start reading the spilled files of the bucket in background.
+    void prefetchBucket(size_t bucket_index);
+    /// Merge the data read by prefetchBucket and the rest of the prefetched files.
+    void mergePrefetchedBucket(SpillPrefetch & prefetch, size_t & read_bytes, size_t & read_rows);
     /// Load blocks from disk and merge them into a new hash table, make a new AggregateDataBlockConverter
     /// to generate output blocks.
     std::unique_ptr<AggregateDataBlockConverter> prepareBucketOutputBlocks(size_t bucket);
@@ -125,10 +167,15 @@ private:
     size_t total_input_rows = 0;
     size_t total_output_blocks = 0;
     size_t total_output_rows = 0;
-    size_t total_spill_disk_bytes = 0;
-    size_t total_spill_disk_time = 0;
+    std::atomic<size_t> total_spill_disk_bytes = 0;
+    std::atomic<size_t> total_spill_disk_time = 0;
     size_t total_read_disk_time = 0;
     size_t total_scatter_time = 0;
+    // Time the processor was blocked by background spill writes or prefetches. The overlap achieved is the spill
+    // (or prefetch) time minus the wait time.
+    size_t total_spill_wait_time = 0;
+    std::atomic<size_t> total_prefetch_read_time = 0;
+    size_t total_prefetch_wait_time = 0;
 
     Poco::Logger * logger = &Poco::Logger::get("GraceMergingAggregatedTransform");
 };
@@ -16,6 +16,7 @@
  */
 
 #include "StreamingAggregatingStep.h"
+#include <Columns/ColumnAggregateFunction.h>
 #include <Processors/Transforms/AggregatingTransform.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Common/CHUtil.h>
@@ -48,6 +49,10 @@ StreamingAggregatingTransform::StreamingAggregatingTransform(
     aggregated_keys_before_evict = PODArrayUtil::adjustMemoryEfficientSize(aggregated_keys_before_evict);
     max_allowed_memory_usage_ratio = config.max_memory_usage_ratio_for_streaming_aggregating;
     high_cardinality_threshold = config.high_cardinality_threshold_for_streaming_aggregating;
+    /// Without keys, the partial aggregation always reduces the rows into one.
+    enable_bypass = config.enable_partial_aggregation_bypass && params->params.keys_size && !params->params.only_merge;
+    bypass_min_rows = config.partial_aggregation_bypass_min_rows;
+    bypass_min_ratio = config.partial_aggregation_bypass_min_ratio;
 }
 
 StreamingAggregatingTransform::~StreamingAggregatingTransform()
@@ -55,7 +60,8 @@ StreamingAggregatingTransform::~StreamingAggregatingTransform()
     LOG_INFO(
         logger,
         "Metrics. total_input_blocks: {}, total_input_rows: {},  total_output_blocks: {}, total_output_rows: {}, "
-        "total_clear_data_variants_num: {}, total_aggregate_time: {}, total_convert_data_variants_time: {}, current mem usage: {}",
+        "total_clear_data_variants_num: {}, total_aggregate_time: {}, total_convert_data_variants_time: {}, total_bypass_rows: {}, "
+        "total_bypass_time: {}, current mem usage: {}",
         total_input_blocks,
         total_input_rows,
         total_output_blocks,
@@ -63,6 +69,8 @@ StreamingAggregatingTransform::~StreamingAggregatingTransform()
         total_clear_data_variants_num,
         total_aggregate_time,
         total_convert_data_variants_time,
+        total_bypass_rows,
+        total_bypass_time,
         ReadableSize(currentThreadGroupMemoryUsage()));
 }
 
@@ -189,6 +197,61 @@ bool StreamingAggregatingTransform::needEvict()
     return false;
 }
 
+bool StreamingAggregatingTransform::shouldBypass() const
+{
+    if (!enable_bypass || is_bypassing || !data_variants || data_variants_input_rows < bypass_min_rows)
+        return false;
+    return static_cast<double>(data_variants->size()) >= bypass_min_ratio * data_variants_input_rows;
+}
+
+DB::Chunk StreamingAggregatingTransform::bypassAggregation(DB::Chunk & chunk)
+{
+    Stopwatch watch;
+    auto num_rows = chunk.getNumRows();
+    auto columns = chunk.detachColumns();
+    const auto & output_header = outputs.front().getHeader();
+    const auto & aggregator_params = params->params;
+
+    DB::Columns result_columns;
+    result_columns.reserve(output_header.columns());
+    for (const auto & key : aggregator_params.keys)
+        result_columns.emplace_back(columns[header.getPositionByName(key)]->convertToFullIfNeeded());
+
+    for (size_t i = 0; i < aggregator_params.aggregates_size; ++i)
+    {
+        const auto & aggregate = aggregator_params.aggregates[i];
+        const auto & function = aggregate.function;
+        DB::Columns argument_holders;
+        std::vector<const DB::IColumn *> arguments;
+        argument_holders.reserve(aggregate.argument_names.size());
+        arguments.reserve(aggregate.argument_names.size());
+        for (const auto & argument_name : aggregate.argument_names)
+        {
+            argument_holders.emplace_back(columns[header.getPositionByName(argument_name)]->convertToFullIfNeeded());
+            arguments.push_back(argument_holders.back().get());
+        }
+
+        auto state_column = output_header.getByPosition(aggregator_params.keys_size + i).type->createColumn();
+        auto & real_column = typeid_cast<DB::ColumnAggregateFunction &>(*state_column);
+        auto & arena = real_column.createOrGetArena();
+        auto & states = real_column.getData();
+        states.reserve_exact(num_rows);
+        size_t size_of_state = function->sizeOfData();
+        size_t align_of_state = function->alignOfData();
+        /// The states are owned by the column once they are pushed into it, they are destroyed with the column on exceptions.
+        for (size_t row = 0; row < num_rows; ++row)
+        {
+            DB::AggregateDataPtr place = arena.alignedAlloc(size_of_state, align_of_state);
+            function->create(place);
+            states.push_back(place);
+        }
+        function->addBatch(0, num_rows, states.data(), 0, arguments.data(), &arena);
+        result_columns.emplace_back(std::move(state_column));
+    }
+    total_bypass_rows += num_rows;
+    total_bypass_time += watch.elapsedMicroseconds();
+    return DB::Chunk(std::move(result_columns), num_rows);
+}
 
 void StreamingAggregatingTransform::work()
 {
@@ -232,9 +295,22 @@ void StreamingAggregatingTransform::work()
             throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "block_converter should be null");
         }
 
+        if (is_bypassing)
+        {
+            has_input = false;
+            if (input_chunk.getNumRows())
+            {
+                output_chunk = bypassAggregation(input_chunk);
+                has_output = true;
+            }
+            input_chunk = {};
+            return;
+        }
+
         if (!data_variants)
         {
             data_variants = std::make_shared<DB::AggregatedDataVariants>();
+            data_variants_input_rows = 0;
         }
 
         has_input = false;
@@ -245,10 +321,22 @@ void StreamingAggregatingTransform::work()
             params->aggregator.executeOnBlock(
                 input_chunk.detachColumns(), 0, num_rows, *data_variants, key_columns, aggregate_columns, no_more_keys);
             total_aggregate_time += watch.elapsedMicroseconds();
+            data_variants_input_rows += num_rows;
             input_chunk = {};
         }
 
-        if (needEvict())
+        if (shouldBypass())
+        {
+            LOG_INFO(
+                logger,
+                "Bypass partial aggregation. aggregated rows: {}, keys: {}, min ratio: {}",
+                data_variants_input_rows,
+                data_variants->size(),
+                bypass_min_ratio);
+            is_bypassing = true;
+        }
+
+        if (is_bypassing || needEvict())
         {
             block_converter = std::make_unique<AggregateDataBlockConverter>(params->aggregator, data_variants, false);
             data_variants = nullptr;
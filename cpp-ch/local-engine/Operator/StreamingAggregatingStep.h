@@ -58,8 +58,15 @@ private:
     // If the cardinality of the keys is larger than this threshold, we will evict data once the keys size in
     // aggregate data variant is over aggregated_keys_before_evict, avoid the aggregated hash table becomes too large.
     double high_cardinality_threshold = 0.8;
+    // Skip the partial aggregation when it doesn't reduce the rows much.
+    bool enable_bypass = false;
+    size_t bypass_min_rows = 100000;
+    double bypass_min_ratio = 0.9;
 
     bool no_more_keys = false;
+    bool is_bypassing = false;
+    /// Input rows aggregated into current data_variants.
+    size_t data_variants_input_rows = 0;
     bool is_consume_finished = false;
     bool is_clear_aggregator = false;
     DB::AggregatedDataVariantsPtr data_variants = nullptr;
@@ -82,8 +89,13 @@ private:
     size_t total_clear_data_variants_num = 0;
     size_t total_aggregate_time = 0;
     size_t total_convert_data_variants_time = 0;
+    size_t total_bypass_rows = 0;
+    size_t total_bypass_time = 0;
 
     bool needEvict();
+    bool shouldBypass() const;
+    /// Convert every input row into one row of intermediate aggregate states, without hashing the keys.
+    DB::Chunk bypassAggregation(DB::Chunk & chunk);
 };
 
 class StreamingAggregatingStep : public DB::ITransformingStep
@@ -18,6 +18,9 @@
 #include <optional>
 #include <Core/Block.h>
 #include <Core/Settings.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
 #include <Functions/FunctionFactory.h>
 #include <IO/ReadBufferFromString.h>
 #include <IO/ReadHelpers.h>
@@ -27,6 +30,7 @@
 #include <Interpreters/HashJoin/HashJoin.h>
 #include <Interpreters/TableJoin.h>
 #include <Join/BroadCastJoinBuilder.h>
+#include <Join/BucketedBroadcastJoin.h>
 #include <Join/StorageJoinFromReadBuffer.h>
 #include <Operator/EarlyStopStep.h>
 #include <Parser/AdvancedParametersParseUtil.h>
@@ -35,6 +39,8 @@
 #include <Processors/QueryPlan/ExpressionStep.h>
 #include <Processors/QueryPlan/FilterStep.h>
 #include <Processors/QueryPlan/JoinStep.h>
+#include <Processors/QueryPlan/ReadFromPreparedSource.h>
+#include <Processors/Sources/NullSource.h>
 #include <google/protobuf/wrappers.pb.h>
 #include <Common/CHUtil.h>
 #include <Common/GlutenConfig.h>
@@ -291,17 +297,25 @@ DB::QueryPlanPtr JoinRelParser::parseJoin(const substrait::JoinRel & join, DB::Q
             }
             // other case: is_empty_hash_table, don't need to handle
         }
+        addRuntimeJoinFilter(*table_join, *left, storage_join->getKeyFilters());
         applyJoinFilter(*table_join, join, *left, *right, true);
-        auto broadcast_hash_join = storage_join->getJoinLocked(table_join, context);
+        if (storage_join->isSpilled())
+        {
+            query_plan = buildSpilledBroadcastJoin(table_join, std::move(left), std::move(right), storage_join);
+        }
+        else
+        {
+            auto broadcast_hash_join = storage_join->getJoinLocked(table_join, context);
 
-        QueryPlanStepPtr join_step = std::make_unique<FilledJoinStep>(left->getCurrentHeader(), broadcast_hash_join, 8192);
+            QueryPlanStepPtr join_step = std::make_unique<FilledJoinStep>(left->getCurrentHeader(), broadcast_hash_join, 8192);
 
-        join_step->setStepDescription("STORAGE_JOIN");
-        steps.emplace_back(join_step.get());
-        left->addStep(std::move(join_step));
-        query_plan = std::move(left);
-        /// hold right plan for profile
-        extra_plan_holder.emplace_back(std::move(right));
+            join_step->setStepDescription("STORAGE_JOIN");
+            steps.emplace_back(join_step.get());
+            left->addStep(std::move(join_step));
+            query_plan = std::move(left);
+            /// hold right plan for profile
+            extra_plan_holder.emplace_back(std::move(right));
+        }
     }
     else if (join_opt_info.is_smj)
     {
@@ -512,6 +526,56 @@ void JoinRelParser::collectJoinKeys(
     }
 }
 
+/// Filter the probe side by the value range and the bloom filter of the broadcast build side keys. The build side
+/// only publishes them for joins which drop the unmatched probe rows. The filter step is pushed down by the plan
+/// optimizations into the scan, where MergeTree and parquet use it to skip granules, row groups and pages, and to
+/// filter the rows in PREWHERE before the other columns are read.
+void JoinRelParser::addRuntimeJoinFilter(const DB::TableJoin & table_join, DB::QueryPlan & left, const JoinKeyFilters & key_filters)
+{
+    if (key_filters.empty() || table_join.getClauses().size() != 1)
+        return;
+
+    const auto & clause = table_join.getOnlyClause();
+    const auto & left_header = left.getCurrentHeader();
+    ActionsDAG actions_dag{left_header.getColumnsWithTypeAndName()};
+    ActionsDAG::NodeRawConstPtrs conditions;
+    for (size_t i = 0; i < clause.key_names_left.size(); ++i)
+    {
+        auto it = key_filters.find(clause.key_names_right[i]);
+        if (it == key_filters.end())
+            continue;
+        const auto & key_filter = it->second;
+        const auto * key_node = actions_dag.tryFindInOutputs(clause.key_names_left[i]);
+        if (!key_node || !removeNullable(key_node->result_type)->equals(*key_filter.type))
+            continue;
+
+        const auto * min_node = expression_parser->addConstColumn(actions_dag, key_filter.type, key_filter.min);
+        const auto * max_node = expression_parser->addConstColumn(actions_dag, key_filter.type, key_filter.max);
+        conditions.emplace_back(buildFunctionNode(actions_dag, "greaterOrEquals", {key_node, min_node}));
+        conditions.emplace_back(buildFunctionNode(actions_dag, "lessOrEquals", {key_node, max_node}));
+        if (!key_filter.bloom_filter.empty())
+        {
+            DataTypePtr int64_type = std::make_shared<DataTypeInt64>();
+            if (key_node->result_type->isNullable())
+                int64_type = makeNullable(int64_type);
+            const auto * type_node = expression_parser->addConstColumn(actions_dag, std::make_shared<DataTypeString>(), int64_type->getName());
+            const auto * cast_node = buildFunctionNode(actions_dag, "CAST", {key_node, type_node});
+            const auto * bloom_filter_node
+                = expression_parser->addConstColumn(actions_dag, std::make_shared<DataTypeString>(), key_filter.bloom_filter);
+            conditions.emplace_back(buildFunctionNode(actions_dag, "bloomFilterContains", {bloom_filter_node, cast_node}));
+        }
+    }
+    if (conditions.empty())
+        return;
+
+    const auto * filter_node = conditions.size() == 1 ? conditions.front() : buildFunctionNode(actions_dag, "and", conditions);
+    actions_dag.addOrReplaceInOutputs(*filter_node);
+    auto filter_step = std::make_unique<FilterStep>(left_header, std::move(actions_dag), filter_node->result_name, true);
+    filter_step->setStepDescription("Runtime join filter");
+    steps.emplace_back(filter_step.get());
+    left.addStep(std::move(filter_step));
+}
+
 bool JoinRelParser::applyJoinFilter(
     DB::TableJoin & table_join,
     const substrait::JoinRel & join_rel,
@@ -767,6 +831,55 @@ DB::QueryPlanPtr JoinRelParser::buildMultiOnClauseHashJoin(
     return query_plan;
 }
 
+/// The broadcast build side has been spilled into disk since it's too large, partitioned by the join keys into buckets.
+/// Instead of the shared in-memory hash table, each task joins its probe side with one bucket at a time. The buckets
+/// are already filled, the right input of the join step is empty.
+DB::QueryPlanPtr JoinRelParser::buildSpilledBroadcastJoin(
+    std::shared_ptr<DB::TableJoin> table_join,
+    DB::QueryPlanPtr left_plan,
+    DB::QueryPlanPtr right_plan,
+    std::shared_ptr<StorageJoinFromReadBuffer> storage_join)
+{
+    /// The build side is only spilled if BucketedBroadcastJoin supports the join, this holds unless the build side and
+    /// the plan disagree on the join.
+    if (!BucketedBroadcastJoin::isSupported(*table_join))
+        throw DB::Exception(
+            DB::ErrorCodes::LOGICAL_ERROR,
+            "Broadcast table is spilled but join {} {} cannot be executed on spilled buckets",
+            toString(table_join->kind()),
+            toString(table_join->strictness()));
+
+    auto build_side_plan = std::make_unique<DB::QueryPlan>();
+    auto build_side_step
+        = std::make_unique<DB::ReadFromPreparedSource>(DB::Pipe(std::make_shared<DB::NullSource>(storage_join->getRightSampleBlock())));
+    build_side_step->setStepDescription("Spilled broadcast table");
+    steps.emplace_back(build_side_step.get());
+    build_side_plan->addStep(std::move(build_side_step));
+
+    JoinPtr bucketed_join = std::make_shared<BucketedBroadcastJoin>(table_join, storage_join, context->getTempDataOnDisk());
+    QueryPlanStepPtr join_step = std::make_unique<DB::JoinStep>(
+        left_plan->getCurrentHeader(),
+        build_side_plan->getCurrentHeader(),
+        bucketed_join,
+        context->getSettingsRef()[Setting::max_block_size],
+        context->getSettingsRef()[Setting::min_joined_block_size_bytes],
+        1,
+        /* required_output_ = */ NameSet{},
+        false,
+        /* use_new_analyzer_ = */ false);
+    join_step->setStepDescription("SPILLED_STORAGE_JOIN");
+    steps.emplace_back(join_step.get());
+
+    std::vector<QueryPlanPtr> plans;
+    plans.emplace_back(std::move(left_plan));
+    plans.emplace_back(std::move(build_side_plan));
+    auto query_plan = std::make_unique<QueryPlan>();
+    query_plan->unitePlans(std::move(join_step), {std::move(plans)});
+    /// hold right plan for profile
+    extra_plan_holder.emplace_back(std::move(right_plan));
+    return query_plan;
+}
+
 DB::QueryPlanPtr JoinRelParser::buildSingleOnClauseHashJoin(
     const substrait::JoinRel & join_rel, std::shared_ptr<DB::TableJoin> table_join, DB::QueryPlanPtr left_plan, DB::QueryPlanPtr right_plan)
 {
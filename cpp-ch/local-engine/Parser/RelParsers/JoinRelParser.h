@@ -20,6 +20,7 @@
 #include <unordered_set>
 #include <Core/Joins.h>
 #include <Interpreters/TableJoin.h>
+#include <Join/JoinKeyFilter.h>
 #include <Parser/RelParsers/RelParser.h>
 #include <substrait/algebra.pb.h>
 
@@ -49,6 +50,14 @@ public:
     std::optional<const substrait::Rel *> getSingleInput(const substrait::Rel & rel) override;
     std::vector<DB::QueryPlanPtr> extraPlans() override { return std::move(extra_plan_holder); }
 
+    /// visible for UTs
+    void addRuntimeJoinFilter(const DB::TableJoin & table_join, DB::QueryPlan & left, const JoinKeyFilters & key_filters);
+    DB::QueryPlanPtr buildSpilledBroadcastJoin(
+        std::shared_ptr<DB::TableJoin> table_join,
+        DB::QueryPlanPtr left_plan,
+        DB::QueryPlanPtr right_plan,
+        std::shared_ptr<StorageJoinFromReadBuffer> storage_join);
+
 private:
     ContextPtr context;
     std::vector<QueryPlanPtr> extra_plan_holder;
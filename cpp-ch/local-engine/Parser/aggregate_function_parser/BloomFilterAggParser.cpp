@@ -20,6 +20,7 @@
 #include <Parser/AggregateFunctionParser.h>
 #include <Parser/aggregate_function_parser/BloomFilterAggParser.h>
 #include <Poco/StringTokenizer.h>
+#include <Common/GlutenConfig.h>
 #include "substrait/algebra.pb.h"
 
 namespace DB
@@ -41,13 +42,15 @@ Int64 optimalNumOfHashFunctions(Int64 n, Int64 m)
     return std::max(1, static_cast<int>(std::round(static_cast<double>(m) / n * std::log(2))));
 }
 
-DB::Array get_parameters(Int64 insert_num, Int64 bits_num)
+DB::Array get_parameters(Int64 insert_num, Int64 bits_num, bool split_block)
 {
     DB::Array parameters;
     Int64 hash_num = optimalNumOfHashFunctions(insert_num, bits_num);
     parameters.push_back(Field((bits_num + 7) / 8));
     parameters.push_back(Field(hash_num));
     parameters.push_back(Field(0)); // Using 0 as seed.
+    if (split_block)
+        parameters.push_back(Field(1));
     return parameters;
 }
 
@@ -68,7 +71,7 @@ DB::Array AggregateFunctionParserBloomFilterAgg::parseFunctionParameters(
         // Delete all args except the first arg.
         arg_nodes.resize(1);
 
-        return get_parameters(insert_num, bits_num);
+        return get_parameters(insert_num, bits_num, JoinConfig::loadFromContext(getContext()).bloom_filter_split_block);
     }
     else
     {
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "PartitionWriter.h"
+#include <deque>
 #include <filesystem>
 #include <format>
 #include <memory>
@@ -23,14 +24,20 @@
 #include <IO/ReadBufferFromFile.h>
 #include <IO/WriteBufferFromFile.h>
 #include <IO/WriteBufferFromString.h>
-#include <Interpreters/sortBlock.h>
-#include <Processors/Merges/Algorithms/MergingSortedAlgorithm.h>
-#include <Processors/Transforms/SortingTransform.h>
 #include <Storages/IO/CompressedWriteBuffer.h>
 #include <Storages/IO/NativeWriter.h>
+#include <base/scope_guard.h>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <Common/Stopwatch.h>
 #include <Common/ThreadPool.h>
+#include <Common/threadPoolCallbackRunner.h>
+
+namespace CurrentMetrics
+{
+extern const Metric LocalThread;
+extern const Metric LocalThreadActive;
+extern const Metric LocalThreadScheduled;
+}
 
 namespace DB
 {
@@ -44,25 +51,6 @@ using namespace DB;
 
 namespace local_engine
 {
-static const String PARTITION_COLUMN_NAME = "partition";
-
-int64_t searchLastPartitionIdIndex(ColumnPtr column, size_t start, size_t partition_id)
-{
-    const auto & int64_column = checkAndGetColumn<ColumnUInt64>(*column);
-    int64_t low = start, high = int64_column.size() - 1;
-    while (low <= high)
-    {
-        int64_t mid = low + (high - low) / 2;
-        if (int64_column.get64(mid) > partition_id)
-            high = mid - 1;
-        else
-            low = mid + 1;
-        if (int64_column.get64(high) == partition_id)
-            return high;
-    }
-    return -1;
-}
-
 bool PartitionWriter::worthToSpill(size_t cache_size) const
 {
     return (options.spill_threshold > 0 && cache_size >= options.spill_threshold) ||
@@ -206,27 +194,184 @@ void SortBasedPartitionWriter::write(const PartitionInfo & info, DB::Block & blo
     Stopwatch write_time_watch;
     if (output_header.columns() == 0)
         output_header = block.cloneEmpty();
-    auto partition_column = ColumnUInt64::create();
-    partition_column->reserve(block.rows());
-    partition_column->getData().insert_assume_reserved(info.src_partition_num.begin(), info.src_partition_num.end());
-    block.insert({std::move(partition_column), std::make_shared<DataTypeUInt64>(), PARTITION_COLUMN_NAME});
-    if (sort_header.columns() == 0)
+    const size_t rows = block.rows();
+    if (!rows)
+        return;
+
+    /// Group the rows by partition id with a counting sort. It's stable and needs no comparison, so the block doesn't
+    /// need to be sorted, and the accumulated blocks don't need to be merged on evicting.
+    const auto & partition_ids = info.src_partition_num;
+    PartitionedBlock partitioned_block;
+    auto & start_points = partitioned_block.partition_start_points;
+    start_points.assign(options.partition_num + 1, 0);
+    for (size_t i = 0; i < rows; ++i)
+        ++start_points[partition_ids[i] + 1];
+    for (size_t i = 0; i < options.partition_num; ++i)
     {
-        sort_header = block.cloneEmpty();
-        sort_description.emplace_back(SortColumnDescription(PARTITION_COLUMN_NAME));
+        partition_rows[i] += start_points[i + 1];
+        start_points[i + 1] += start_points[i];
     }
-    // partial sort
-    sortBlock(block, sort_description);
-    Chunk chunk;
-    chunk.setColumns(block.getColumns(), block.rows());
-    accumulated_blocks.emplace_back(std::move(chunk));
-    current_accumulated_bytes += accumulated_blocks.back().allocatedBytes();
-    current_accumulated_rows += accumulated_blocks.back().getNumRows();
+    IColumn::Permutation permutation(rows);
+    std::vector<size_t> positions(start_points.begin(), start_points.end() - 1);
+    for (size_t i = 0; i < rows; ++i)
+        permutation[positions[partition_ids[i]]++] = i;
+
+    ColumnsWithTypeAndName columns = block.getColumnsWithTypeAndName();
+    for (auto & column : columns)
+        column.column = column.column->permute(permutation, 0);
+    partitioned_block.block = Block(std::move(columns));
+
+    current_accumulated_bytes += partitioned_block.block.allocatedBytes() + start_points.size() * sizeof(size_t);
+    current_accumulated_rows += rows;
+    accumulated_blocks.emplace_back(std::move(partitioned_block));
     split_result->total_write_time += write_time_watch.elapsedNanoseconds();
     if (worthToSpill(current_accumulated_bytes))
         evictPartitions();
 }
 
+void SortBasedPartitionWriter::serializePartition(
+    size_t partition_id, size_t block_size, DB::WriteBuffer & output, SerializedPartition & partition) const
+{
+    auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(options.compress_method), options.compress_level);
+    const size_t output_begin = output.count();
+    CompressedWriteBuffer compressed_output(output, codec, options.io_buffer_size);
+    NativeWriter writer(compressed_output, output_header);
+    partition.partition_id = partition_id;
+
+    /// Concatenate the rows of this partition in all accumulated blocks into blocks of block_size rows.
+    MutableColumns columns = output_header.cloneEmptyColumns();
+    size_t rows = 0;
+    auto write_block = [&]()
+    {
+        if (!rows)
+            return;
+        partition.raw_bytes += writer.write(output_header.cloneWithColumns(std::move(columns)));
+        columns = output_header.cloneEmptyColumns();
+        rows = 0;
+    };
+    for (const auto & partitioned_block : accumulated_blocks)
+    {
+        size_t from = partitioned_block.partition_start_points[partition_id];
+        const size_t to = partitioned_block.partition_start_points[partition_id + 1];
+        while (from < to)
+        {
+            const size_t length = std::min(to - from, block_size - rows);
+            for (size_t i = 0; i < columns.size(); ++i)
+                columns[i]->insertRangeFrom(*partitioned_block.block.getByPosition(i).column, from, length);
+            rows += length;
+            from += length;
+            if (rows >= block_size)
+                write_block();
+        }
+    }
+    write_block();
+    compressed_output.finalize();
+    partition.compress_time = compressed_output.getCompressTime();
+    partition.compressed_bytes = output.count() - output_begin;
+}
+
+std::vector<SortBasedPartitionWriter::SerializedPartition>
+SortBasedPartitionWriter::serializePartitionRange(size_t partition_begin, size_t partition_end, size_t block_size) const
+{
+    std::vector<SerializedPartition> result;
+    for (size_t partition_id = partition_begin; partition_id < partition_end; ++partition_id)
+    {
+        if (!partition_rows[partition_id])
+            continue;
+
+        WriteBufferFromOwnString output;
+        SerializedPartition & partition = result.emplace_back();
+        serializePartition(partition_id, block_size, output, partition);
+        output.finalize();
+        partition.data = std::move(output.str());
+    }
+    return result;
+}
+
+void SortBasedPartitionWriter::serializePartitions(const PartitionConsumer & consumer, DB::WriteBuffer * output)
+{
+    const size_t block_size = adaptiveBlockSize();
+    const size_t threads = std::min(evict_threads, options.partition_num);
+    if (threads <= 1)
+    {
+        for (size_t partition_id = 0; partition_id < options.partition_num; ++partition_id)
+        {
+            if (!partition_rows[partition_id])
+                continue;
+            if (output)
+            {
+                SerializedPartition partition;
+                serializePartition(partition_id, block_size, *output, partition);
+                consumer(partition);
+            }
+            else
+            {
+                for (auto & partition : serializePartitionRange(partition_id, partition_id + 1, block_size))
+                    consumer(partition);
+            }
+        }
+        return;
+    }
+
+    if (!evict_pool)
+        evict_pool = std::make_unique<ThreadPool>(
+            CurrentMetrics::LocalThread, CurrentMetrics::LocalThreadActive, CurrentMetrics::LocalThreadScheduled, threads);
+    auto runner = threadPoolCallbackRunnerUnsafe<std::vector<SerializedPartition>>(*evict_pool, "SortShuffleEvict");
+
+    /// Split the partitions into ranges of similar rows, several ranges per thread for load balance. New ranges are
+    /// scheduled only while the accumulated bytes of the ranges in flight stay within evict_window_bytes, which bounds
+    /// the memory of the serialized data waiting to be consumed. At least one range is always in flight.
+    const size_t row_bytes = std::max<size_t>(current_accumulated_bytes / std::max<size_t>(current_accumulated_rows, 1), 1);
+    const size_t window_rows = std::max<size_t>(evict_window_bytes / row_bytes, 1);
+    const size_t rows_per_range = std::max<size_t>(std::min(current_accumulated_rows / (threads * 4), window_rows / (threads * 2)), 1);
+    struct PendingRange
+    {
+        std::future<std::vector<SerializedPartition>> future;
+        size_t bytes = 0;
+    };
+    std::deque<PendingRange> pending_ranges;
+    size_t pending_bytes = 0;
+    SCOPE_EXIT({
+        for (auto & range : pending_ranges)
+            if (range.future.valid())
+                range.future.wait();
+    });
+
+    size_t range_begin = 0;
+    auto schedule_next_range = [&]()
+    {
+        size_t range_end = range_begin;
+        size_t range_rows = 0;
+        while (range_end < options.partition_num && range_rows < rows_per_range)
+            range_rows += partition_rows[range_end++];
+        auto & range = pending_ranges.emplace_back();
+        range.bytes = range_rows * row_bytes;
+        range.future = runner(
+            [this, range_begin, range_end, block_size]() { return serializePartitionRange(range_begin, range_end, block_size); }, {});
+        pending_bytes += range.bytes;
+        range_begin = range_end;
+    };
+
+    while (range_begin < options.partition_num || !pending_ranges.empty())
+    {
+        while (range_begin < options.partition_num && (pending_ranges.empty() || pending_bytes < evict_window_bytes))
+            schedule_next_range();
+        auto partitions = pending_ranges.front().future.get();
+        pending_bytes -= pending_ranges.front().bytes;
+        pending_ranges.pop_front();
+        for (auto & partition : partitions)
+            consumer(partition);
+    }
+}
+
+void SortBasedPartitionWriter::resetAccumulatedBlocks()
+{
+    accumulated_blocks.clear();
+    std::fill(partition_rows.begin(), partition_rows.end(), 0);
+    current_accumulated_bytes = 0;
+    current_accumulated_rows = 0;
+}
+
 LocalPartitionWriter::LocalPartitionWriter(const SplitOptions & options)
     : PartitionWriter(options, getLogger("LocalPartitionWriter"))
     , Spillable(options)
@@ -273,80 +418,34 @@ size_t MemorySortLocalPartitionWriter::evictPartitions()
             return;
         auto file = getNextSpillFile();
         WriteBufferFromFile output(file, options.io_buffer_size);
-        auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(options.compress_method), options.compress_level);
-        CompressedWriteBuffer compressed_output(output, codec, options.io_buffer_size);
-        NativeWriter writer(compressed_output, output_header);
 
         SpillInfo info;
         info.spilled_file = file;
 
         Stopwatch serialization_time_watch;
-        MergeSorter sorter(sort_header, std::move(accumulated_blocks), sort_description, adaptiveBlockSize(), 0);
-        size_t cur_partition_id = 0;
-        info.partition_spill_infos[cur_partition_id] = {0, 0};
-        while (auto data = sorter.read())
-        {
-            Block serialized_block = sort_header.cloneWithColumns(data.detachColumns());
-            const auto partitions = serialized_block.getByName(PARTITION_COLUMN_NAME).column;
-            serialized_block.erase(PARTITION_COLUMN_NAME);
-            size_t row_offset = 0;
-            while (row_offset < serialized_block.rows())
+        size_t write_time = 0;
+        serializePartitions(
+            [&](SerializedPartition & partition)
             {
-                auto last_idx = searchLastPartitionIdIndex(partitions, row_offset, cur_partition_id);
-                if (last_idx < 0)
-                {
-                    auto & last = info.partition_spill_infos[cur_partition_id];
-                    compressed_output.sync();
-                    last.second = output.count() - last.first;
-                    cur_partition_id++;
-                    info.partition_spill_infos[cur_partition_id] = {last.first + last.second, 0};
-                    continue;
-                }
-
-                if (row_offset == 0 && last_idx == serialized_block.rows() - 1)
+                if (!partition.data.empty())
                 {
-                    auto count = writer.write(serialized_block);
-                    split_result->raw_partition_lengths[cur_partition_id] += count;
-                    break;
+                    Stopwatch write_time_watch;
+                    output.write(partition.data.data(), partition.data.size());
+                    write_time += write_time_watch.elapsedNanoseconds();
                 }
-                else
-                {
-                    auto cut_block = serialized_block.cloneWithCutColumns(row_offset, last_idx - row_offset + 1);
-
-                    auto count = writer.write(cut_block);
-                    split_result->raw_partition_lengths[cur_partition_id] += count;
-                    row_offset = last_idx + 1;
-                    if (last_idx != serialized_block.rows() - 1)
-                    {
-                        auto & last = info.partition_spill_infos[cur_partition_id];
-                        compressed_output.sync();
-                        last.second = output.count() - last.first;
-                        cur_partition_id++;
-                        info.partition_spill_infos[cur_partition_id] = {last.first + last.second, 0};
-                    }
-                }
-            }
-        }
-        compressed_output.sync();
-        auto & last = info.partition_spill_infos[cur_partition_id];
-        last.second = output.count() - last.first;
+                info.partition_spill_infos[partition.partition_id]
+                    = {output.count() - partition.compressed_bytes, partition.compressed_bytes};
+                split_result->raw_partition_lengths[partition.partition_id] += partition.raw_bytes;
+                split_result->total_compress_time += partition.compress_time;
+            },
+            &output);
+        output.finalize();
         spilled_bytes = current_accumulated_bytes;
         res = current_accumulated_bytes;
-        current_accumulated_bytes = 0;
-        current_accumulated_rows = 0;
-        std::erase_if(
-            info.partition_spill_infos,
-            [](const auto & item)
-            {
-                auto const & [key, value] = item;
-                return value.second == 0;
-            });
+        resetAccumulatedBlocks();
         spill_infos.emplace_back(info);
-        split_result->total_compress_time += compressed_output.getCompressTime();
-        split_result->total_io_time += compressed_output.getWriteTime();
+        split_result->total_io_time += write_time;
         split_result->total_serialize_time += serialization_time_watch.elapsedNanoseconds();
-        compressed_output.finalize();
-        output.finalize();
     };
 
     Stopwatch spill_time_watch;
@@ -369,72 +468,23 @@ size_t MemorySortCelebornPartitionWriter::evictPartitions()
         if (accumulated_blocks.empty())
             return;
 
-        WriteBufferFromOwnString output;
-        auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(options.compress_method), options.compress_level);
-        CompressedWriteBuffer compressed_output(output, codec, options.io_buffer_size);
-        NativeWriter writer(compressed_output, output_header);
-
-        MergeSorter sorter(sort_header, std::move(accumulated_blocks), sort_description, adaptiveBlockSize(), 0);
-        size_t cur_partition_id = 0;
-        auto push_to_celeborn = [&]()
-        {
-            compressed_output.sync();
-            auto & data = output.str();
-            if (!data.empty())
+        serializePartitions(
+            [&](SerializedPartition & partition)
             {
+                split_result->raw_partition_lengths[partition.partition_id] += partition.raw_bytes;
+                split_result->total_compress_time += partition.compress_time;
+                if (partition.data.empty())
+                    return;
                 Stopwatch push_time_watch;
-                celeborn_client->pushPartitionData(cur_partition_id, data.data(), data.size());
+                celeborn_client->pushPartitionData(partition.partition_id, partition.data.data(), partition.data.size());
                 split_result->total_io_time += push_time_watch.elapsedNanoseconds();
-                split_result->partition_lengths[cur_partition_id] += data.size();
-                split_result->total_bytes_written += data.size();
-            }
-            output.restart();
-        };
-
-        while (auto data = sorter.read())
-        {
-            Block serialized_block = sort_header.cloneWithColumns(data.detachColumns());
-            const auto partitions = serialized_block.getByName(PARTITION_COLUMN_NAME).column;
-            serialized_block.erase(PARTITION_COLUMN_NAME);
-            size_t row_offset = 0;
-            while (row_offset < serialized_block.rows())
-            {
-                auto last_idx = searchLastPartitionIdIndex(partitions, row_offset, cur_partition_id);
-                if (last_idx < 0)
-                {
-                    push_to_celeborn();
-                    cur_partition_id++;
-                    continue;
-                }
-
-                if (row_offset == 0 && last_idx == serialized_block.rows() - 1)
-                {
-                    auto count = writer.write(serialized_block);
-                    split_result->raw_partition_lengths[cur_partition_id] += count;
-                    break;
-                }
-                auto cut_block = serialized_block.cloneWithCutColumns(row_offset, last_idx - row_offset + 1);
-                auto count = writer.write(cut_block);
-                split_result->raw_partition_lengths[cur_partition_id] += count;
-                row_offset = last_idx + 1;
-                if (last_idx != serialized_block.rows() - 1)
-                {
-                    push_to_celeborn();
-                    cur_partition_id++;
-                }
-            }
-        }
-        push_to_celeborn();
+                split_result->partition_lengths[partition.partition_id] += partition.data.size();
+                split_result->total_bytes_written += partition.data.size();
+            });
         spilled_bytes = current_accumulated_bytes;
         res = current_accumulated_bytes;
-        current_accumulated_bytes = 0;
-        current_accumulated_rows = 0;
-
-        split_result->total_compress_time += compressed_output.getCompressTime();
-        split_result->total_io_time += compressed_output.getWriteTime();
+        resetAccumulatedBlocks();
         split_result->total_serialize_time += serialization_time_watch.elapsedNanoseconds();
-        compressed_output.finalize();
-        output.finalize();
     };
 
     Stopwatch spill_time_watch;
@@ -16,6 +16,7 @@
  */
 #pragma once
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <Core/Block.h>
@@ -26,10 +27,10 @@
 #include <jni/CelebornClient.h>
 #include <Common/GlutenConfig.h>
 #include <Common/QueryContext.h>
+#include <Common/ThreadPool.h>
 
 namespace DB
 {
-class MergingSortedAlgorithm;
 namespace Setting
 {
 extern const SettingsUInt64 prefer_external_sort_block_bytes;
@@ -162,6 +163,10 @@ protected:
         max_merge_block_size = options.split_size;
         max_sort_buffer_size = options.max_sort_buffer_size;
         max_merge_block_bytes = QueryContext::globalContext()->getSettingsRef()[DB::Setting::prefer_external_sort_block_bytes];
+        const auto sort_shuffle_config = SortShuffleConfig::loadFromContext(QueryContext::globalContext());
+        evict_threads = sort_shuffle_config.sort_shuffle_evict_threads;
+        evict_window_bytes = sort_shuffle_config.sort_shuffle_evict_window_bytes;
+        partition_rows.resize(options.partition_num, 0);
     }
 public:
     String getName() const override { return "SortBasedPartitionWriter"; }
@@ -177,15 +182,47 @@ public:
     }
 
 protected:
+    /// One input block whose rows are grouped by partition id.
+    struct PartitionedBlock
+    {
+        DB::Block block;
+        /// The rows of partition i are in [partition_start_points[i], partition_start_points[i + 1])
+        std::vector<size_t> partition_start_points;
+    };
+
+    /// One serialized and compressed partition. `data` is empty if it was compressed straight into the output.
+    struct SerializedPartition
+    {
+        size_t partition_id = 0;
+        String data;
+        size_t compressed_bytes = 0;
+        size_t raw_bytes = 0;
+        size_t compress_time = 0;
+    };
+    using PartitionConsumer = std::function<void(SerializedPartition & partition)>;
+
+    /// Serialize the accumulated blocks partition by partition. Since the rows are already grouped by partition id,
+    /// partitions are independent runs, and they are serialized in parallel by evict_threads. `consumer` is called in the
+    /// order of partition id as soon as the partition is ready, while the later partitions are still in progress.
+    /// With one evict thread, partitions are compressed straight into `output` if it's given, otherwise one at a time
+    /// into memory.
+    void serializePartitions(const PartitionConsumer & consumer, DB::WriteBuffer * output = nullptr);
+    void serializePartition(size_t partition_id, size_t block_size, DB::WriteBuffer & output, SerializedPartition & partition) const;
+    std::vector<SerializedPartition> serializePartitionRange(size_t partition_begin, size_t partition_end, size_t block_size) const;
+    void resetAccumulatedBlocks();
+
     size_t max_merge_block_size = DB::DEFAULT_BLOCK_SIZE;
     size_t max_sort_buffer_size = 1_GiB;
     size_t max_merge_block_bytes = 0;
     size_t current_accumulated_bytes = 0;
     size_t current_accumulated_rows = 0;
-    DB::Chunks accumulated_blocks;
+    std::vector<PartitionedBlock> accumulated_blocks;
+    /// Accumulated rows of each partition.
+    std::vector<size_t> partition_rows;
     DB::Block output_header;
-    DB::Block sort_header;
-    DB::SortDescription sort_description;
+    size_t evict_threads = 1;
+    size_t evict_window_bytes = 64_MiB;
+    std::unique_ptr<ThreadPool> evict_pool;
 };
 
 class MemorySortLocalPartitionWriter : public SortBasedPartitionWriter, public Spillable
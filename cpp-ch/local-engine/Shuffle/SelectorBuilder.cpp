@@ -18,8 +18,10 @@
 #include <limits>
 #include <memory>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnDecimal.h>
 #include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
 #include <DataTypes/DataTypeArray.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <DataTypes/DataTypesDecimal.h>
@@ -84,6 +86,83 @@ PartitionInfo RoundRobinSelectorBuilder::build(DB::Block & block)
     return PartitionInfo::fromSelector(std::move(result), parts_num, use_sort_shuffle);
 }
 
+template <typename T>
+void hashToPartitionIds(
+    const PaddedPODArray<T> & hashes, const NullMap * null_map, UInt32 parts_num, bool spark_pmod, IColumn::Selector & partition_ids)
+{
+    const size_t rows = hashes.size();
+    partition_ids.resize(rows);
+    const bool is_power_of_two = (parts_num & (parts_num - 1)) == 0;
+    /// IColumn::get64() zero-extends the narrower values.
+    using UnsignedT = std::make_unsigned_t<T>;
+    if (spark_pmod)
+    {
+        const auto n = static_cast<Int32>(parts_num);
+        if (is_power_of_two)
+        {
+            for (size_t i = 0; i < rows; ++i)
+                partition_ids[i] = static_cast<UInt64>(static_cast<Int32>(static_cast<UnsignedT>(hashes[i])) & (n - 1));
+        }
+        else
+        {
+            for (size_t i = 0; i < rows; ++i)
+            {
+                Int32 res = static_cast<Int32>(static_cast<UnsignedT>(hashes[i])) % n;
+                partition_ids[i] = static_cast<UInt64>(res + (res < 0) * n);
+            }
+        }
+        return;
+    }
+
+    const UInt64 mask = parts_num - 1;
+    if (null_map)
+    {
+        const auto & nulls = *null_map;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            auto hash = static_cast<UInt64>(static_cast<UnsignedT>(hashes[i])) & static_cast<UInt64>(static_cast<Int64>(nulls[i]) - 1);
+            partition_ids[i] = is_power_of_two ? hash & mask : hash % parts_num;
+        }
+    }
+    else if (is_power_of_two)
+    {
+        for (size_t i = 0; i < rows; ++i)
+            partition_ids[i] = static_cast<UInt64>(static_cast<UnsignedT>(hashes[i])) & mask;
+    }
+    else
+    {
+        for (size_t i = 0; i < rows; ++i)
+            partition_ids[i] = static_cast<UInt64>(static_cast<UnsignedT>(hashes[i])) % parts_num;
+    }
+}
+
+#define INSTANTIATE_HASH_TO_PARTITION_IDS(T) \
+    template void hashToPartitionIds<T>( \
+        const PaddedPODArray<T> & hashes, const NullMap * null_map, UInt32 parts_num, bool spark_pmod, IColumn::Selector & partition_ids);
+INSTANTIATE_HASH_TO_PARTITION_IDS(Int8)
+INSTANTIATE_HASH_TO_PARTITION_IDS(UInt8)
+INSTANTIATE_HASH_TO_PARTITION_IDS(Int16)
+INSTANTIATE_HASH_TO_PARTITION_IDS(UInt16)
+INSTANTIATE_HASH_TO_PARTITION_IDS(Int32)
+INSTANTIATE_HASH_TO_PARTITION_IDS(UInt32)
+INSTANTIATE_HASH_TO_PARTITION_IDS(Int64)
+INSTANTIATE_HASH_TO_PARTITION_IDS(UInt64)
+#undef INSTANTIATE_HASH_TO_PARTITION_IDS
+
+namespace
+{
+template <typename T>
+bool tryHashToPartitionIds(
+    const IColumn & column, const NullMap * null_map, UInt32 parts_num, bool spark_pmod, IColumn::Selector & partition_ids)
+{
+    const auto * typed_column = typeid_cast<const ColumnVector<T> *>(&column);
+    if (!typed_column)
+        return false;
+    hashToPartitionIds(typed_column->getData(), null_map, parts_num, spark_pmod, partition_ids);
+    return true;
+}
+}
+
 HashSelectorBuilder::HashSelectorBuilder(
     UInt32 parts_num_, const std::vector<size_t> & exprs_index_, const std::string & hash_function_name_, bool use_external_sort_shuffle)
     : SelectorBuilder(use_external_sort_shuffle), parts_num(parts_num_), exprs_index(exprs_index_), hash_function_name(hash_function_name_)
@@ -121,6 +200,21 @@ PartitionInfo HashSelectorBuilder::build(DB::Block & block)
     }
     else
     {
+        const IColumn * hash_data = hash_column.get();
+        const NullMap * null_map = nullptr;
+        if (const auto * nullable = typeid_cast<const ColumnNullable *>(hash_data))
+        {
+            null_map = &nullable->getNullMapData();
+            hash_data = &nullable->getNestedColumn();
+        }
+        /// Typed kernels for the result types of the hash functions, the loops below are the fallback.
+        const bool spark_pmod = hash_function_name == "sparkMurmurHash3_32";
+        if (tryHashToPartitionIds<Int32>(*hash_data, null_map, parts_num, spark_pmod, partition_ids)
+            || tryHashToPartitionIds<UInt32>(*hash_data, null_map, parts_num, spark_pmod, partition_ids)
+            || tryHashToPartitionIds<Int64>(*hash_data, null_map, parts_num, spark_pmod, partition_ids)
+            || tryHashToPartitionIds<UInt64>(*hash_data, null_map, parts_num, spark_pmod, partition_ids))
+            return PartitionInfo::fromSelector(std::move(partition_ids), parts_num, use_sort_shuffle);
+
         if (hash_function_name == "sparkMurmurHash3_32")
         {
             /// sparkMurmurHash3_32 returns are all not null.
@@ -170,13 +264,15 @@ RangeSelectorBuilder::RangeSelectorBuilder(const std::string & option, const siz
     auto ordering_infos = info->get("ordering").extract<Poco::JSON::Array::Ptr>();
     initSortInformation(ordering_infos);
     initRangeBlock(info->get("range_bounds").extract<Poco::JSON::Array::Ptr>());
+    initFlatBounds();
     partition_num = partition_num_;
 }
 
 PartitionInfo RangeSelectorBuilder::build(DB::Block & block)
 {
     DB::IColumn::Selector result;
-    computePartitionIdByBinarySearch(block, result);
+    if (!use_flat_bounds || !computePartitionIdByFlatBounds(block, result))
+        computePartitionIdByBinarySearch(block, result);
     return PartitionInfo::fromSelector(std::move(result), partition_num, use_sort_shuffle);
 }
 
@@ -343,6 +439,129 @@ void RangeSelectorBuilder::initActionsDAG(const DB::Block & block)
     has_init_actions_dag = true;
 }
 
+namespace
+{
+template <typename ColumnType>
+bool tryWidenToInt64(const IColumn & column, PaddedPODArray<Int64> & values)
+{
+    const auto * typed_column = typeid_cast<const ColumnType *>(&column);
+    if (!typed_column)
+        return false;
+    const auto & data = typed_column->getData();
+    values.resize(data.size());
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if constexpr (requires { data[i].value; })
+            values[i] = static_cast<Int64>(data[i].value);
+        else
+            values[i] = static_cast<Int64>(data[i]);
+    }
+    return true;
+}
+
+/// Decimals and timestamps are compared by their underlying integers, the scale of the key and the bounds are the same.
+bool widenToInt64(const IColumn & column, PaddedPODArray<Int64> & values)
+{
+    return tryWidenToInt64<ColumnInt8>(column, values) || tryWidenToInt64<ColumnInt16>(column, values)
+        || tryWidenToInt64<ColumnInt32>(column, values) || tryWidenToInt64<ColumnInt64>(column, values)
+        || tryWidenToInt64<ColumnUInt8>(column, values) || tryWidenToInt64<ColumnUInt16>(column, values)
+        || tryWidenToInt64<ColumnUInt32>(column, values) || tryWidenToInt64<ColumnDecimal<Decimal32>>(column, values)
+        || tryWidenToInt64<ColumnDecimal<Decimal64>>(column, values) || tryWidenToInt64<ColumnDecimal<DateTime64>>(column, values);
+}
+
+/// The partition id of a key is the number of bounds which are sorted before it, i.e. the lower bound of the key.
+template <bool ascending>
+void searchFlatBounds(const PaddedPODArray<Int64> & bounds, const PaddedPODArray<Int64> & keys, IColumn::Selector & selector)
+{
+    auto before = [](Int64 bound, Int64 key)
+    {
+        if constexpr (ascending)
+            return bound < key;
+        else
+            return bound > key;
+    };
+    const Int64 * bounds_data = bounds.data();
+    const size_t bounds_num = bounds.size();
+    const size_t rows = keys.size();
+    selector.resize(rows);
+    if (bounds_num <= 64)
+    {
+        /// Counting the bounds is branch free and vectorized, it's faster than searching for a few bounds.
+        for (size_t i = 0; i < rows; ++i)
+        {
+            const Int64 key = keys[i];
+            UInt64 partition_id = 0;
+            for (size_t j = 0; j < bounds_num; ++j)
+                partition_id += before(bounds_data[j], key);
+            selector[i] = partition_id;
+        }
+        return;
+    }
+    /// Branch free binary search, the compiler generates conditional moves instead of unpredictable branches.
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const Int64 key = keys[i];
+        const Int64 * base = bounds_data;
+        size_t len = bounds_num;
+        while (len > 1)
+        {
+            const size_t half = len / 2;
+            base = before(base[half], key) ? base + half : base;
+            len -= half;
+        }
+        selector[i] = static_cast<UInt64>(base - bounds_data) + before(*base, key);
+    }
+}
+}
+
+void RangeSelectorBuilder::initFlatBounds()
+{
+    if (sorting_key_columns.size() != 1 || !range_bounds_block.rows())
+        return;
+    const IColumn * bounds_column = range_bounds_block.getByPosition(0).column.get();
+    if (const auto * nullable = typeid_cast<const ColumnNullable *>(bounds_column))
+    {
+        if (nullable->hasNull())
+            return;
+        bounds_column = &nullable->getNestedColumn();
+    }
+    use_flat_bounds = widenToInt64(*bounds_column, flat_bounds);
+}
+
+bool RangeSelectorBuilder::computePartitionIdByFlatBounds(const DB::Block & block, DB::IColumn::Selector & selector) const
+{
+    const auto & key = block.getByPosition(sorting_key_columns[0]);
+    if (!removeNullable(key.type)->equals(*sort_field_types[0].inner_type))
+        return false;
+    auto key_column = key.column->convertToFullColumnIfConst();
+    const IColumn * key_data = key_column.get();
+    const NullMap * null_map = nullptr;
+    if (const auto * nullable = typeid_cast<const ColumnNullable *>(key_data))
+    {
+        null_map = &nullable->getNullMapData();
+        key_data = &nullable->getNestedColumn();
+    }
+    PaddedPODArray<Int64> keys;
+    if (!widenToInt64(*key_data, keys))
+        return false;
+
+    const auto & sort_description = sort_descriptions[0];
+    if (sort_description.direction > 0)
+        searchFlatBounds<true>(flat_bounds, keys, selector);
+    else
+        searchFlatBounds<false>(flat_bounds, keys, selector);
+
+    if (null_map)
+    {
+        /// A null key is compared with any bound by nulls_direction, so it's in the first or the last partition.
+        const UInt64 null_partition = sort_description.nulls_direction * sort_description.direction <= 0 ? 0 : flat_bounds.size();
+        const auto & nulls = *null_map;
+        for (size_t i = 0; i < selector.size(); ++i)
+            selector[i] = nulls[i] ? null_partition : selector[i];
+    }
+    return true;
+}
+
 void RangeSelectorBuilder::computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector)
 {
     Chunks chunks;
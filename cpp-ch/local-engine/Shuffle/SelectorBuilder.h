@@ -17,6 +17,7 @@
 #pragma once
 #include <memory>
 #include <vector>
+#include <Columns/ColumnNullable.h>
 #include <Core/Block.h>
 #include <Core/ColumnWithTypeAndName.h>
 #include <Core/SortDescription.h>
@@ -66,6 +67,17 @@ private:
     Int32 pid_selection = 0;
 };
 
+/// Same as `hash % parts_num` on the hash value read by IColumn::get64(), but without virtual calls per row, and the
+/// modulo is replaced by a mask when parts_num is a power of two. If spark_pmod is true, it's spark's pmod on the Int32 hash.
+/// The rows set in null_map go to partition 0. It's declared here to be visible for UTs.
+template <typename T>
+void hashToPartitionIds(
+    const DB::PaddedPODArray<T> & hashes,
+    const DB::NullMap * null_map,
+    UInt32 parts_num,
+    bool spark_pmod,
+    DB::IColumn::Selector & partition_ids);
+
 class HashSelectorBuilder : public SelectorBuilder
 {
 public:
@@ -87,6 +99,11 @@ public:
     ~RangeSelectorBuilder() override = default;
     PartitionInfo build(DB::Block & block) override;
 
+    /// visible for UTs
+    void computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector);
+    /// Return false if the key column can't be searched in flat_bounds.
+    bool computePartitionIdByFlatBounds(const DB::Block & block, DB::IColumn::Selector & selector) const;
+
 private:
     DB::SortDescription sort_descriptions;
     std::vector<size_t> sorting_key_columns;
@@ -105,14 +122,19 @@ private:
     std::unique_ptr<DB::ExpressionActions> projection_expression_actions;
     size_t partition_num;
 
+    /// When there is only one sorting key and it's an integer, date, timestamp or decimal (up to 64 bits) key, the bounds
+    /// are flattened into an Int64 array, which is searched without IColumn comparisons.
+    bool use_flat_bounds = false;
+    DB::PaddedPODArray<Int64> flat_bounds;
+
     void initSortInformation(Poco::JSON::Array::Ptr orderings);
     void initRangeBlock(Poco::JSON::Array::Ptr range_bounds);
+    void initFlatBounds();
     void initActionsDAG(const DB::Block & block);
 
     template <typename T>
     void safeInsertFloatValue(const Poco::Dynamic::Var & field_value, DB::MutableColumnPtr & col);
 
-    void computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector);
     int compareRow(
         const DB::Columns & columns,
         const std::vector<size_t> & required_columns,
@@ -29,6 +29,7 @@
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Storages/MergeTree/MetaDataHelper.h>
 #include <jni/jni_common.h>
+#include <Common/GlutenConfig.h>
 #include <Common/Logger.h>
 #include <Common/ThreadPool.h>
 #include <Common/logger_useful.h>
@@ -81,19 +82,33 @@ struct CacheJobContext
     MergeTreeTableInstance table;
 };
 
+DB::ContextMutablePtr CacheManager::createJobContext() const
+{
+    auto job_context = DB::Context::createCopy(context);
+    const auto config = GlutenJobSchedulerConfig::loadFromContext(context);
+    if (config.job_scheduler_max_bytes_per_second)
+        job_context->setSetting("max_remote_read_network_bandwidth", config.job_scheduler_max_bytes_per_second);
+    return job_context;
+}
+
 Task CacheManager::cachePart(
-    const MergeTreeTableInstance & table, const MergeTreePart & part, const std::unordered_set<String> & columns, bool only_meta_cache)
+    const MergeTreeTableInstance & table,
+    const MergeTreePart & part,
+    const std::unordered_set<String> & columns,
+    bool only_meta_cache,
+    const DB::ContextPtr & read_context_)
 {
     CacheJobContext job_context{table};
     job_context.table.parts.clear();
     job_context.table.parts.push_back(part);
     job_context.table.snapshot_id = "";
     MergeTreeCacheConfig config = MergeTreeCacheConfig::loadFromContext(context);
-    Task task = [job_detail = job_context, context = this->context, read_columns = columns, only_meta_cache,
-        prefetch_data = config.enable_data_prefetch]()
+    Task task = [job_detail = job_context, context = this->context, read_context = read_context_, read_columns = columns, only_meta_cache,
+        prefetch_data = config.enable_data_prefetch, prefetch_threads = config.data_prefetch_threads](const TaskContext & task_context)
     {
         try
         {
+            task_context.checkCancelled();
             auto storage = job_detail.table.restoreStorage(context);
             std::vector<DataPartPtr> selected_parts
                 = StorageMergeTreeFactory::getDataPartsByNames(storage->getStorageID(), "", {job_detail.table.parts.front().name});
@@ -108,9 +123,20 @@ Task CacheManager::cachePart(
                     job_detail.table.parts.front().name);
                 return;
             }
-            // prefetch part data
-            if (prefetch_data)
-                storage->prefetchPartDataFile({job_detail.table.parts.front().name});
+            task_context.checkCancelled();
+            // prefetch only the files of the requested columns, the read pipeline below would just read them back from the cache
+            if (prefetch_data && !selected_parts.empty())
+            {
+                storage->prefetchPartColumns(selected_parts.front(), read_columns, read_context, prefetch_threads, task_context);
+                LOG_INFO(
+                    getLogger("CacheManager"),
+                    "Prefetch {} columns of table {}.{} part {} success.",
+                    read_columns.size(),
+                    job_detail.table.database,
+                    job_detail.table.table,
+                    job_detail.table.parts.front().name);
+                return;
+            }
 
             auto storage_snapshot = std::make_shared<StorageSnapshot>(*storage, storage->getInMemoryMetadataPtr());
             NamesAndTypesList names_and_types_list;
@@ -127,8 +153,8 @@ Task CacheManager::cachePart(
                 names_and_types_list.getNames(),
                 storage_snapshot,
                 *query_info,
-                context,
-                context->getSettingsRef()[Setting::max_block_size],
+                read_context,
+                read_context->getSettingsRef()[Setting::max_block_size],
                 1);
             QueryPlan plan;
             plan.addStep(std::move(read_step));
@@ -137,6 +163,11 @@ Task CacheManager::cachePart(
             PullingPipelineExecutor executor(pipeline);
             while (true)
             {
+                if (task_context.isCancelled())
+                {
+                    executor.cancel();
+                    task_context.checkCancelled();
+                }
                 if (Chunk chunk; !executor.pull(chunk))
                     break;
             }
@@ -155,10 +186,11 @@ Task CacheManager::cachePart(
 JobId CacheManager::cacheParts(const MergeTreeTableInstance & table, const std::unordered_set<String>& columns, bool only_meta_cache)
 {
     JobId id = toString(UUIDHelpers::generateV4());
-    Job job(id);
+    Job job(id, JobOptions{.priority = only_meta_cache ? META_CACHE_PRIORITY : DATA_CACHE_PRIORITY});
+    const auto job_context = createJobContext();
     for (const auto & part : table.parts)
     {
-        job.addTask(cachePart(table, part, columns, only_meta_cache));
+        job.addTask(cachePart(table, part, columns, only_meta_cache, job_context));
     }
     auto& scheduler = JobScheduler::instance();
     scheduler.scheduleJob(std::move(job));
@@ -177,6 +209,7 @@ jobject CacheManager::getCacheStatus(JNIEnv * env, const String & jobId)
         {
             case JobSatus::RUNNING:
                 status = 0;
+                message = fmt::format("{} of {} tasks finished", job_status->finished_tasks, job_status->total_tasks);
                 break;
             case JobSatus::FINISHED:
                 status = 1;
@@ -189,6 +222,11 @@ jobject CacheManager::getCacheStatus(JNIEnv * env, const String & jobId)
                     message.append(";");
                 }
                 break;
+            case JobSatus::CANCELLED:
+                status = 3;
+                message = fmt::format(
+                    "job {} was cancelled after {} of {} tasks finished", jobId, job_status->finished_tasks, job_status->total_tasks);
+                break;
         }
     }
     else
@@ -199,17 +237,26 @@ jobject CacheManager::getCacheStatus(JNIEnv * env, const String & jobId)
     return env->NewObject(cache_result_class, cache_result_constructor, status, charTojstring(env, message.c_str()));
 }
 
+bool CacheManager::cancelJob(const String & jobId)
+{
+    return JobScheduler::instance().cancelJob(jobId);
+}
+
 Task CacheManager::cacheFile(const substrait::ReadRel::LocalFiles::FileOrFiles & file, ReadBufferBuilderPtr read_buffer_builder)
 {
-    auto task = [file, read_buffer_builder, context = this->context]()
+    auto task = [file, read_buffer_builder, context = this->context](const TaskContext & task_context)
     {
         LOG_INFO(getLogger("CacheManager"), "Loading cache file {}", file.uri_file());
 
         try
         {
             std::unique_ptr<DB::ReadBuffer> rb = read_buffer_builder->build(file);
+            // Skip buffer by buffer rather than ignoreAll, so that a cancelled job stops early.
             while (!rb->eof())
-                rb->ignoreAll();
+            {
+                task_context.checkCancelled();
+                rb->position() = rb->buffer().end();
+            }
         }
         catch (std::exception & e)
         {
@@ -224,13 +271,13 @@ Task CacheManager::cacheFile(const substrait::ReadRel::LocalFiles::FileOrFiles &
 JobId CacheManager::cacheFiles(substrait::ReadRel::LocalFiles file_infos)
 {
     JobId id = toString(UUIDHelpers::generateV4());
-    Job job(id);
+    Job job(id, JobOptions{.priority = DATA_CACHE_PRIORITY});
     DB::ReadSettings read_settings = context->getReadSettings();
 
     if (file_infos.items_size())
     {
         const Poco::URI file_uri(file_infos.items().Get(0).uri_file());
-        const auto read_buffer_builder = ReadBufferBuilderFactory::instance().createBuilder(file_uri.getScheme(), context);
+        const auto read_buffer_builder = ReadBufferBuilderFactory::instance().createBuilder(file_uri.getScheme(), createJobContext());
 
         if (context->getConfigRef().getBool("gluten_cache.local.enabled", false))
             for (const auto & file : file_infos.items())
@@ -42,14 +42,25 @@ public:
     static void initialize(const DB::ContextMutablePtr & context);
     JobId cacheParts(const MergeTreeTableInstance & table, const std::unordered_set<String> & columns, bool only_meta_cache);
     static jobject getCacheStatus(JNIEnv * env, const String & jobId);
+    static bool cancelJob(const String & jobId);
 
     Task cacheFile(const substrait::ReadRel::LocalFiles::FileOrFiles & file, ReadBufferBuilderPtr read_buffer_builder);
+    /// Metadata only jobs are cheap and usually wait in front of queries, they go before the data warmup jobs.
+    static constexpr DB::Priority META_CACHE_PRIORITY{0};
+    static constexpr DB::Priority DATA_CACHE_PRIORITY{1};
     JobId cacheFiles(substrait::ReadRel::LocalFiles file_infos);
     static void removeFiles(String file, String cache_name);
 
 private:
     Task cachePart(
-        const MergeTreeTableInstance & table, const MergeTreePart & part, const std::unordered_set<String> & columns, bool only_meta_cache);
+        const MergeTreeTableInstance & table,
+        const MergeTreePart & part,
+        const std::unordered_set<String> & columns,
+        bool only_meta_cache,
+        const DB::ContextPtr & read_context);
+    /// Context shared by the tasks of one job. It carries the job's remote read bandwidth limit, so all its reads go
+    /// through one throttler.
+    DB::ContextMutablePtr createJobContext() const;
     CacheManager() = default;
     DB::ContextMutablePtr context;
 };
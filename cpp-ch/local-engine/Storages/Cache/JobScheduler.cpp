@@ -15,7 +15,6 @@
  * limitations under the License.
  */
 
-
 #include "JobScheduler.h"
 
 #include <Interpreters/Context.h>
@@ -28,6 +27,7 @@ namespace DB
 namespace ErrorCodes
 {
 extern const int BAD_ARGUMENTS;
+extern const int QUERY_WAS_CANCELLED;
 }
 }
 
@@ -42,14 +42,23 @@ namespace local_engine
 {
 std::shared_ptr<JobScheduler> global_job_scheduler = nullptr;
 
+void TaskContext::checkCancelled() const
+{
+    if (isCancelled())
+        throw DB::Exception(DB::ErrorCodes::QUERY_WAS_CANCELLED, "Job was cancelled");
+}
+
 void JobScheduler::initialize(const DB::ContextPtr & context)
 {
     auto config = GlutenJobSchedulerConfig::loadFromContext(context);
-    instance().thread_pool = std::make_unique<ThreadPool>(
+    auto & scheduler = instance();
+    scheduler.max_threads = std::max<size_t>(1, config.job_scheduler_max_threads);
+    scheduler.max_tasks_per_job = config.job_scheduler_max_tasks_per_job;
+    scheduler.thread_pool = std::make_unique<ThreadPool>(
         CurrentMetrics::LocalThread,
         CurrentMetrics::LocalThreadActive,
         CurrentMetrics::LocalThreadScheduled,
-        config.job_scheduler_max_threads,
+        scheduler.max_threads,
         0,
         0);
 
@@ -58,83 +67,157 @@ void JobScheduler::initialize(const DB::ContextPtr & context)
 JobId JobScheduler::scheduleJob(Job&& job)
 {
     cleanFinishedJobs();
-    if (job_details.contains(job.id))
-    {
-        throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "job {} exists.", job.id);
-    }
-    size_t task_num = job.tasks.size();
     auto job_id = job.id;
-    std::vector<TaskResult> task_results;
-    task_results.reserve(task_num);
-    JobContext job_context = {std::move(job), std::make_unique<std::atomic_uint32_t>(task_num), std::move(task_results)};
+    auto job_context = std::make_shared<JobContext>(std::move(job));
     {
         std::lock_guard lock(job_details_mutex);
-        job_details.emplace(job_id, std::move(job_context));
+        if (job_details.contains(job_id))
+        {
+            throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "job {} exists.", job_id);
+        }
+        job_details.emplace(job_id, job_context);
+        if (job_context->isFinished())
+            addFinishedJob(job_id);
+        else
+            pending_jobs.push_back(job_context);
+        LOG_INFO(
+            logger,
+            "schedule job {} with {} tasks, priority {}",
+            job_id,
+            job_context->job.tasks.size(),
+            job_context->job.options.priority.value);
+        dispatch();
     }
-    LOG_INFO(logger, "schedule job {}", job_id);
+    return job_id;
+}
 
-    auto & job_detail = job_details.at(job_id);
+size_t JobScheduler::maxRunningTasks(const JobContext & job_context) const
+{
+    const size_t limit = job_context.job.options.max_parallelism ? job_context.job.options.max_parallelism : max_tasks_per_job;
+    return limit ? limit : max_threads;
+}
 
-    for (auto & task : job_detail.job.tasks)
+void JobScheduler::dispatch()
+{
+    while (running_tasks < max_threads)
     {
-        job_detail.task_results.emplace_back(TaskResult());
-        auto & task_result = job_detail.task_results.back();
-        thread_pool->scheduleOrThrow(
-            [&]()
-            {
-                SCOPE_EXIT({
-                    job_detail.remain_tasks->fetch_sub(1, std::memory_order::acquire);
-                    if (job_detail.isFinished())
-                    {
-                        addFinishedJob(job_detail.job.id);
-                    }
-                });
-                try
-                {
-                    task();
-                    task_result.status = TaskResult::Status::SUCCESS;
-                }
-                catch (std::exception & e)
-                {
-                    task_result.status = TaskResult::Status::FAILED;
-                    task_result.message = e.what();
-                }
-            });
+        auto selected = pending_jobs.end();
+        for (auto it = pending_jobs.begin(); it != pending_jobs.end(); ++it)
+        {
+            const auto & candidate = **it;
+            if (candidate.running_tasks >= maxRunningTasks(candidate))
+                continue;
+            if (selected == pending_jobs.end() || candidate.job.options.priority < (*selected)->job.options.priority)
+                selected = it;
+        }
+        if (selected == pending_jobs.end())
+            return;
+
+        auto job_context = *selected;
+        pending_jobs.erase(selected);
+        const size_t task_index = job_context->next_task++;
+        if (job_context->next_task < job_context->job.tasks.size())
+            pending_jobs.push_back(job_context);
+
+        ++job_context->running_tasks;
+        ++running_tasks;
+        thread_pool->scheduleOrThrow([this, job_context, task_index]() { runTask(job_context, task_index); });
     }
-    return job_id;
+}
+
+void JobScheduler::runTask(const JobContextPtr & job_context, size_t task_index)
+{
+    TaskContext task_context(job_context->cancelled);
+    TaskResult result;
+    if (task_context.isCancelled())
+        result.status = TaskResult::Status::CANCELLED;
+    else
+    {
+        try
+        {
+            job_context->job.tasks[task_index](task_context);
+            result.status = TaskResult::Status::SUCCESS;
+        }
+        catch (std::exception & e)
+        {
+            result.status = task_context.isCancelled() ? TaskResult::Status::CANCELLED : TaskResult::Status::FAILED;
+            result.message = e.what();
+        }
+    }
+
+    std::lock_guard lock(job_details_mutex);
+    job_context->task_results[task_index] = std::move(result);
+    --job_context->running_tasks;
+    --running_tasks;
+    ++job_context->finished_tasks;
+    if (job_context->isFinished())
+        addFinishedJob(job_context->job.id);
+    dispatch();
 }
 
 std::optional<JobSatus> JobScheduler::getJobSatus(const JobId & job_id)
 {
-    if (!job_details.contains(job_id))
+    std::lock_guard lock(job_details_mutex);
+    auto it = job_details.find(job_id);
+    if (it == job_details.end())
     {
         return std::nullopt;
     }
     std::optional<JobSatus> res;
-    auto & job_context = job_details.at(job_id);
+    auto & job_context = *it->second;
     if (job_context.isFinished())
     {
         std::vector<String> messages;
+        size_t succeeded_tasks = 0;
         for (auto & task_result : job_context.task_results)
         {
             if (task_result.status == TaskResult::Status::FAILED)
             {
                 messages.push_back(task_result.message);
             }
+            else if (task_result.status == TaskResult::Status::SUCCESS)
+                ++succeeded_tasks;
         }
-        if (messages.empty())
-            res = JobSatus::success();
+        if (!messages.empty())
+            res = JobSatus::failed(messages);
+        else if (job_context.cancelled->load())
+            /// finished_tasks also counts the tasks dropped by the cancel, report the ones which did their work.
+            res = JobSatus::cancelled(succeeded_tasks, job_context.job.tasks.size());
         else
-            res= JobSatus::failed(messages);
+            res = JobSatus::success();
     }
     else
-        res = JobSatus::running();
+        res = JobSatus::running(job_context.finished_tasks, job_context.job.tasks.size());
     return res;
 }
 
+bool JobScheduler::cancelJob(const JobId & job_id)
+{
+    std::lock_guard lock(job_details_mutex);
+    auto it = job_details.find(job_id);
+    if (it == job_details.end())
+        return false;
+
+    auto & job_context = it->second;
+    if (job_context->isFinished())
+        return true;
+    LOG_INFO(logger, "cancel job {}, {} of {} tasks finished", job_id, job_context->finished_tasks, job_context->job.tasks.size());
+    job_context->cancelled->store(true);
+    const size_t total_tasks = job_context->job.tasks.size();
+    for (size_t i = job_context->next_task; i < total_tasks; ++i)
+        job_context->task_results[i].status = TaskResult::Status::CANCELLED;
+    job_context->finished_tasks += total_tasks - job_context->next_task;
+    job_context->next_task = total_tasks;
+    pending_jobs.remove(job_context);
+    if (job_context->isFinished())
+        addFinishedJob(job_id);
+    return true;
+}
+
 void JobScheduler::cleanupJob(const JobId & job_id)
 {
     LOG_INFO(logger, "clean job {}", job_id);
+    std::lock_guard lock(job_details_mutex);
     job_details.erase(job_id);
 }
 
@@ -147,17 +230,23 @@ void JobScheduler::addFinishedJob(const JobId & job_id)
 
 void JobScheduler::cleanFinishedJobs()
 {
-    std::lock_guard lock(finished_job_mutex);
-    for (auto it = finished_job.begin(); it != finished_job.end();)
+    std::vector<JobId> expired_jobs;
     {
-        // clean finished job after 5 minutes
-        if (it->second.elapsedSeconds() > 60 * 5)
+        std::lock_guard lock(finished_job_mutex);
+        for (auto it = finished_job.begin(); it != finished_job.end();)
         {
-            cleanupJob(it->first);
-            it = finished_job.erase(it);
+            // clean finished job after 5 minutes
+            if (it->second.elapsedSeconds() > 60 * 5)
+            {
+                expired_jobs.push_back(it->first);
+                it = finished_job.erase(it);
+            }
+            else
+                ++it;
         }
-        else
-            ++it;
     }
+    // job_details_mutex is taken before finished_job_mutex elsewhere, so clean up after releasing the latter.
+    for (const auto & job_id : expired_jobs)
+        cleanupJob(job_id);
+}
 }
-}
\ No newline at end of file
@@ -15,8 +15,10 @@
  * limitations under the License.
  */
 #pragma once
+#include <list>
 #include <Interpreters/Context_fwd.h>
 #include <base/types.h>
+#include <Common/Priority.h>
 #include <Common/Stopwatch.h>
 #include <Common/ThreadPool_fwd.h>
 
@@ -24,14 +26,38 @@ namespace local_engine
 {
 
 using JobId = String;
-using Task = std::function<void()>;
+
+/// Passed to every task. Tasks which run for long should poll it and stop once their job is cancelled.
+class TaskContext
+{
+public:
+    explicit TaskContext(const std::shared_ptr<std::atomic_bool> & cancelled_) : cancelled(cancelled_) { }
+
+    bool isCancelled() const { return cancelled->load(std::memory_order_relaxed); }
+
+    /// Throws QUERY_WAS_CANCELLED if the job was cancelled.
+    void checkCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic_bool> cancelled;
+};
+
+using Task = std::function<void(const TaskContext &)>;
+
+struct JobOptions
+{
+    /// Jobs with a smaller value start their tasks first, jobs with the same priority take turns.
+    DB::Priority priority;
+    /// Max number of tasks of the job running at the same time, 0 means the job_scheduler_max_tasks_per_job default.
+    size_t max_parallelism = 0;
+};
 
 class Job
 {
     friend class JobScheduler;
 public:
-    explicit Job(const JobId& id)
-        : id(id)
+    explicit Job(const JobId& id, const JobOptions & options_ = {})
+        : id(id), options(options_)
     {
     }
 
@@ -42,6 +68,7 @@ public:
 
 private:
     JobId id;
+    JobOptions options;
     std::vector<Task> tasks;
 };
 
@@ -53,25 +80,33 @@ struct JobSatus
     {
         RUNNING,
         FINISHED,
-        FAILED
+        FAILED,
+        CANCELLED
     };
     Status status;
     std::vector<String> messages;
+    size_t finished_tasks = 0;
+    size_t total_tasks = 0;
 
     static JobSatus success()
     {
         return JobSatus{FINISHED};
     }
 
-    static JobSatus running()
+    static JobSatus running(size_t finished_tasks, size_t total_tasks)
     {
-        return JobSatus{RUNNING};
+        return JobSatus{RUNNING, {}, finished_tasks, total_tasks};
     }
 
     static JobSatus failed(const std::vector<std::string> & messages)
     {
         return JobSatus{FAILED, messages};
     }
+
+    static JobSatus cancelled(size_t finished_tasks, size_t total_tasks)
+    {
+        return JobSatus{CANCELLED, {}, finished_tasks, total_tasks};
+    }
 };
 
 struct TaskResult
@@ -80,25 +115,38 @@ struct TaskResult
     {
         SUCCESS,
         FAILED,
-        RUNNING
+        RUNNING,
+        CANCELLED
     };
     Status status = RUNNING;
     String message;
 };
 
+/// State of a scheduled job, guarded by JobScheduler::job_details_mutex.
 class JobContext
 {
 public:
+    explicit JobContext(Job && job_) : job(std::move(job_)), task_results(job.tasks.size()) { }
+
     Job job;
-    std::unique_ptr<std::atomic_uint32_t> remain_tasks = std::make_unique<std::atomic_uint32_t>();
     std::vector<TaskResult> task_results;
+    /// Tasks before next_task were started or dropped by a cancel.
+    size_t next_task = 0;
+    size_t running_tasks = 0;
+    size_t finished_tasks = 0;
+    std::shared_ptr<std::atomic_bool> cancelled = std::make_shared<std::atomic_bool>(false);
 
-    bool isFinished()
+    bool isFinished() const
     {
-        return remain_tasks->load(std::memory_order::relaxed) == 0;
+        return finished_tasks == job.tasks.size();
     }
 };
 
+using JobContextPtr = std::shared_ptr<JobContext>;
+
+/// Runs the tasks of jobs on a shared pool. Tasks are not queued to the pool up front: a task is started only when a
+/// thread is free, taken from the job with the best priority which is below its parallelism limit. This keeps one
+/// large job from delaying the jobs scheduled after it, and makes cancelling a job drop its tasks which did not start.
 class JobScheduler
 {
 public:
@@ -114,6 +162,10 @@ public:
 
     std::optional<JobSatus> getJobSatus(const JobId& job_id);
 
+    /// Drops the tasks of the job which did not start yet and asks the running ones to stop.
+    /// Returns false if the job is unknown.
+    bool cancelJob(const JobId& job_id);
+
     void cleanupJob(const JobId& job_id);
 
     void addFinishedJob(const JobId& job_id);
@@ -121,8 +173,19 @@ public:
     void cleanFinishedJobs();
 private:
     JobScheduler() = default;
+
+    /// Starts tasks while there are free threads, called with job_details_mutex held.
+    void dispatch();
+    void runTask(const JobContextPtr & job_context, size_t task_index);
+    size_t maxRunningTasks(const JobContext & job_context) const;
+
     std::unique_ptr<ThreadPool> thread_pool;
-    std::unordered_map<JobId, JobContext> job_details;
+    size_t max_threads = 0;
+    size_t max_tasks_per_job = 0;
+    size_t running_tasks = 0;
+    std::unordered_map<JobId, JobContextPtr> job_details;
+    /// Jobs with tasks left to start. A job goes to the back once one of its tasks is started.
+    std::list<JobContextPtr> pending_jobs;
     std::mutex job_details_mutex;
 
     std::vector<std::pair<JobId, Stopwatch>> finished_job;
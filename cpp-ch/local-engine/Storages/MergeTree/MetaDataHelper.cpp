@@ -18,6 +18,7 @@
 #include <filesystem>
 #include <Core/Settings.h>
 #include <Disks/ObjectStorages/MetadataStorageFromDisk.h>
+#include <Disks/ObjectStorages/MetadataStorageFromRocksDB.h>
 #include <Storages/MergeTree/MergeSparkMergeTreeTask.h>
 #include <Poco/StringTokenizer.h>
 #include <Common/QueryContext.h>
@@ -89,11 +90,27 @@ void restoreMetaData<ROCKSDB>(
     std::unordered_set<String> not_exists_part;
     auto metadata_storage = data_disk->getMetadataStorage();
     auto table_path = std::filesystem::path(mergeTreeTable.relative_path);
-    for (const auto & part : mergeTreeTable.getPartNames())
+    const auto part_name_set = mergeTreeTable.getPartNames();
+    const std::vector<std::string> part_names(part_name_set.begin(), part_name_set.end());
+    std::vector<std::string> part_paths;
+    part_paths.reserve(part_names.size());
+    for (const auto & part : part_names)
+        part_paths.emplace_back(table_path / part);
+#if USE_ROCKSDB
+    // Check all the parts with one MultiGet, tables may have tens of thousands of them.
+    if (const auto * rocksdb_storage = dynamic_cast<const MetadataStorageFromRocksDB *>(metadata_storage.get()))
     {
-        auto part_path = table_path / part;
-        if (!metadata_storage->existsDirectory(part_path))
-            not_exists_part.emplace(part);
+        const auto exists = rocksdb_storage->existsDirectories(part_paths);
+        for (size_t i = 0; i < part_names.size(); ++i)
+            if (!exists[i])
+                not_exists_part.emplace(part_names[i]);
+    }
+    else
+#endif
+    {
+        for (size_t i = 0; i < part_names.size(); ++i)
+            if (!metadata_storage->existsDirectory(part_paths[i]))
+                not_exists_part.emplace(part_names[i]);
     }
 
     if (auto lock = storage->lockForAlter(context.getSettingsRef()[Setting::lock_acquire_timeout]))
@@ -106,6 +106,8 @@ SinkToStoragePtr SparkMergeTreeSink::create(
 
     auto dest_storage = merge_tree_table.getStorage(context);
     bool isRemoteStorage = dest_storage->getStoragePolicy()->getAnyDisk()->isRemote();
+    /// Without local storage, parts are written through the disk's CompactObjectStorageDiskTransaction, which streams
+    /// the part data file to the object store while the part is written instead of copying finished local parts.
     bool insert_with_local_storage = !write_settings_.insert_without_local_storage;
     SinkHelperPtr sink_helper;
     if (insert_with_local_storage && isRemoteStorage)
@@ -18,11 +18,15 @@
 
 #include <Disks/ObjectStorages/CompactObjectStorageDiskTransaction.h>
 #include <Disks/SingleDiskVolume.h>
+#include <IO/SharedThreadPools.h>
 #include <Interpreters/MergeTreeTransaction.h>
+#include <Storages/Cache/JobScheduler.h>
 #include <Storages/MergeTree/DataPartStorageOnDiskFull.h>
 #include <Storages/MergeTree/MergeTreeSettings.h>
 #include <Storages/MergeTree/SparkMergeTreeSink.h>
 #include <Storages/MergeTree/checkDataPart.h>
+#include <Common/GlutenConfig.h>
+#include <Common/threadPoolCallbackRunner.h>
 
 namespace ProfileEvents
 {
@@ -162,52 +166,196 @@ SparkStorageMergeTree::SparkStorageMergeTree(
 
 std::atomic<int> SparkStorageMergeTree::part_num;
 
-void SparkStorageMergeTree::prefetchPartDataFile(const std::unordered_set<std::string> & parts) const
+void SparkStorageMergeTree::prefetchPartFile(
+    const DiskPtr & disk, const String & part_name, const String & file_name, const ReadSettings & read_settings) const
 {
-    prefetchPartFiles(parts, CompactObjectStorageDiskTransaction::PART_DATA_FILE_NAME);
+    const String data_path = fs::path(relative_data_path) / part_name / file_name;
+    if (!disk->existsFile(data_path))
+        return;
+    LOG_DEBUG(log, "Prefetching part file {}", data_path);
+    /// Read through the disk with the query read settings, so that the bytes land in the filesystem cache, and drop
+    /// them buffer by buffer instead of collecting the whole file into memory.
+    auto settings = read_settings;
+    settings.remote_fs_method = RemoteFSReadMethod::read;
+    auto in = disk->readFile(data_path, settings);
+    in->ignoreAll();
 }
 
-void SparkStorageMergeTree::prefetchPartFiles(const std::unordered_set<std::string> & parts, String file_name) const
+void SparkStorageMergeTree::prefetchPartColumns(
+    const DataPartPtr & part,
+    const NameSet & columns,
+    const ContextPtr & context,
+    size_t max_concurrency,
+    const TaskContext & task_context) const
 {
     auto disk = getDisks().front();
     if (!disk->isRemote())
         return;
-    std::vector<String> data_paths;
-    std::ranges::for_each(parts, [&](const String & name) { data_paths.emplace_back(fs::path(relative_data_path) / name / file_name); });
-    auto read_settings = ReadSettings{};
-    read_settings.remote_fs_method = RemoteFSReadMethod::read;
-    for (const auto & data_path : data_paths)
+
+    /// Files of a compacted part are ranges of the part data object, so reading the files of a column through the
+    /// disk caches exactly the bytes of that column. A compact part stores the columns interleaved granule by
+    /// granule in one file, and is small by definition, so it is warmed as a whole.
+    if (part->getType() != MergeTreeDataPartType::Wide)
     {
-        if (!disk->existsFile(data_path))
+        prefetchPartFile(disk, part->name, CompactObjectStorageDiskTransaction::PART_DATA_FILE_NAME, context->getReadSettings());
+        return;
+    }
+
+    const String marks_extension = part->index_granularity_info.mark_type.getFileExtension();
+    Strings files;
+    for (const auto & column_name : columns)
+    {
+        const auto column = part->getColumns().tryGetByName(column_name);
+        if (!column)
             continue;
-        LOG_DEBUG(log, "Prefetching part file {}", data_path);
-        auto in = disk->readFile(data_path, read_settings);
-        String ignore_data;
-        readStringUntilEOF(ignore_data, *in);
+        part->getSerialization(column->name)
+            ->enumerateStreams(
+                [&](const ISerialization::SubstreamPath & substream_path)
+                {
+                    const auto stream_name = IMergeTreeDataPart::getStreamNameForColumn(*column, substream_path, ".bin", part->checksums);
+                    if (!stream_name)
+                        return;
+                    files.emplace_back(*stream_name + ".bin");
+                    files.emplace_back(*stream_name + marks_extension);
+                });
     }
-}
 
-void SparkStorageMergeTree::prefetchMetaDataFile(const std::unordered_set<std::string> & parts) const
-{
-    prefetchPartFiles(parts, CompactObjectStorageDiskTransaction::PART_META_FILE_NAME);
+    Stopwatch watch;
+    const auto read_settings = context->getReadSettings();
+    max_concurrency = std::min(max_concurrency, files.size());
+    if (max_concurrency <= 1)
+    {
+        for (const auto & file : files)
+        {
+            task_context.checkCancelled();
+            prefetchPartFile(disk, part->name, file, read_settings);
+        }
+    }
+    else
+    {
+        auto runner = threadPoolCallbackRunnerUnsafe<void>(getIOThreadPool().get(), "PrefetchColumns");
+        std::deque<std::future<void>> pending;
+        try
+        {
+            for (const auto & file : files)
+            {
+                if (pending.size() >= max_concurrency)
+                {
+                    pending.front().get();
+                    pending.pop_front();
+                }
+                task_context.checkCancelled();
+                pending.emplace_back(runner(
+                    [&, file]
+                    {
+                        /// The files queued in the pool before the cancellation are skipped as well.
+                        if (!task_context.isCancelled())
+                            prefetchPartFile(disk, part->name, file, read_settings);
+                    },
+                    {}));
+            }
+            while (!pending.empty())
+            {
+                pending.front().get();
+                pending.pop_front();
+            }
+        }
+        catch (...)
+        {
+            /// The jobs reference this frame, let them finish before rethrowing.
+            for (auto & future : pending)
+                if (future.valid())
+                    future.wait();
+            throw;
+        }
+    }
+    LOG_DEBUG(
+        log,
+        "Prefetched {} files of {} columns of part {} in {} microseconds",
+        files.size(),
+        columns.size(),
+        part->name,
+        watch.elapsedMicroseconds());
 }
 
 std::vector<MergeTreeDataPartPtr> SparkStorageMergeTree::loadDataPartsWithNames(const std::unordered_set<std::string> & parts)
 {
     Stopwatch watch;
-    prefetchMetaDataFile(parts);
-    std::vector<MergeTreeDataPartPtr> data_parts;
     const auto disk = getStoragePolicy()->getDisks().at(0);
-    for (const auto & name : parts)
+    const bool prefetch_metadata = disk->isRemote();
+    const auto read_settings = getContext()->getReadSettings();
+    /// Latency of each part from its metadata fetch to the end of its loading, the stragglers of a table show up in
+    /// the max rather than in the total.
+    std::atomic<UInt64> total_part_microseconds = 0;
+    std::atomic<UInt64> max_part_microseconds = 0;
+
+    /// Each part is prefetched and loaded by the same job, so the metadata fetch of one part overlaps with the
+    /// loading of the others.
+    auto load_part = [&](const String & name) -> MergeTreeDataPartPtr
     {
+        Stopwatch part_watch;
+        if (prefetch_metadata)
+            prefetchPartFile(disk, name, CompactObjectStorageDiskTransaction::PART_META_FILE_NAME, read_settings);
         const auto num = part_num.fetch_add(1);
         MergeTreePartInfo part_info = {"all", num, num, 0};
         auto res = loadDataPart(part_info, name, disk, MergeTreeDataPartState::Active);
-        data_parts.emplace_back(res.part);
+
+        const UInt64 elapsed = part_watch.elapsedMicroseconds();
+        total_part_microseconds += elapsed;
+        UInt64 current_max = max_part_microseconds.load();
+        while (elapsed > current_max && !max_part_microseconds.compare_exchange_weak(current_max, elapsed))
+            ;
+        return res.part;
+    };
+
+    std::vector<MergeTreeDataPartPtr> data_parts;
+    data_parts.reserve(parts.size());
+    const size_t max_concurrency = std::min(MergeTreeConfig::loadFromContext(getContext()).table_part_loading_threads, parts.size());
+    if (max_concurrency <= 1)
+    {
+        for (const auto & name : parts)
+            data_parts.emplace_back(load_part(name));
+    }
+    else
+    {
+        auto runner = threadPoolCallbackRunnerUnsafe<MergeTreeDataPartPtr>(getActivePartsLoadingThreadPool().get(), "LoadSparkParts");
+        std::deque<std::future<MergeTreeDataPartPtr>> pending;
+        try
+        {
+            for (const auto & name : parts)
+            {
+                if (pending.size() >= max_concurrency)
+                {
+                    data_parts.emplace_back(pending.front().get());
+                    pending.pop_front();
+                }
+                pending.emplace_back(runner([&load_part, &name] { return load_part(name); }, {}));
+            }
+            while (!pending.empty())
+            {
+                data_parts.emplace_back(pending.front().get());
+                pending.pop_front();
+            }
+        }
+        catch (...)
+        {
+            /// The jobs reference this frame, let them finish before rethrowing.
+            for (auto & future : pending)
+                if (future.valid())
+                    future.wait();
+            throw;
+        }
     }
 
     watch.stop();
-    LOG_DEBUG(log, "Loaded data parts ({} items) took {} microseconds", parts.size(), watch.elapsedMicroseconds());
+    LOG_INFO(
+        log,
+        "Loaded data parts ({} items) took {} microseconds with {} threads, {} microseconds per part on average, {} at most",
+        parts.size(),
+        watch.elapsedMicroseconds(),
+        std::max<size_t>(1, max_concurrency),
+        parts.empty() ? 0 : total_part_microseconds.load() / parts.size(),
+        max_part_microseconds.load());
     ProfileEvents::increment(ProfileEvents::LoadedDataParts, parts.size());
     ProfileEvents::increment(ProfileEvents::LoadedDataPartsMicroseconds, watch.elapsedMicroseconds());
     return data_parts;
@@ -30,6 +30,7 @@
 namespace local_engine
 {
 struct SparkMergeTreeWritePartitionSettings;
+class TaskContext;
 using namespace DB;
 
 class SparkMergeTreeDataWriter
@@ -73,7 +74,14 @@ public:
     std::map<std::string, MutationCommands> getUnfinishedMutationCommands() const override;
     std::vector<MergeTreeDataPartPtr> loadDataPartsWithNames(const std::unordered_set<std::string> & parts);
     void removePartFromMemory(const MergeTreeData::DataPart & part_to_detach);
-    void prefetchPartDataFile(const std::unordered_set<std::string> & parts) const;
+    /// Fetch only the data and marks files of the given columns into the filesystem cache, up to max_concurrency files
+    /// at a time. No more files are fetched once the task is cancelled.
+    void prefetchPartColumns(
+        const DataPartPtr & part,
+        const NameSet & columns,
+        const ContextPtr & context,
+        size_t max_concurrency,
+        const TaskContext & task_context) const;
 
     MergeTreeDataSelectExecutor reader;
     MergeTreeDataMergerMutator merger_mutator;
@@ -94,8 +102,7 @@ private:
     static std::atomic<int> part_num;
     SimpleIncrement increment;
 
-    void prefetchPartFiles(const std::unordered_set<std::string> & parts, String file_name) const;
-    void prefetchMetaDataFile(const std::unordered_set<std::string> & parts) const;
+    void prefetchPartFile(const DiskPtr & disk, const String & part_name, const String & file_name, const ReadSettings & read_settings) const;
     void startBackgroundMovesIfNeeded() override;
     std::unique_ptr<MergeTreeSettings> getDefaultSettings() const override;
     LoadPartResult loadDataPart(
@@ -19,9 +19,19 @@
 #include <Columns/ColumnArray.h>
 #include <Columns/ColumnConst.h>
 #include <Columns/ColumnMap.h>
+#include <Columns/ColumnsNumber.h>
+#include <Core/Defines.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Interpreters/AggregationCommon.h>
+#include <Interpreters/ExpressionAnalyzer.h>
+#include <Interpreters/TreeRewriter.h>
+#include <QueryPipeline/Chain.h>
 #include <QueryPipeline/QueryPipeline.h>
 #include <Poco/URI.h>
 #include <Common/DebugUtils.h>
+#include <Common/GlutenConfig.h>
+#include <Common/formatReadable.h>
+#include <Common/logger_useful.h>
 
 namespace local_engine
 {
@@ -213,6 +223,318 @@ OutputFormatFilePtr createOutputFormatFile(
     return OutputFormatFileUtil::createFile(context, write_buffer_builder, encoded, preferred_schema, format_hint);
 }
 
+namespace
+{
+constexpr size_t NO_PART = std::numeric_limits<size_t>::max();
+const String PARTITION_INDEX_COLUMN{"__partition_index__"};
+}
+
+SparkPartitionedBaseSink::SparkPartitionedBaseSink(
+    const DB::ContextPtr & context,
+    const DB::Names & partition_by,
+    const DB::Block & input_header,
+    const std::shared_ptr<WriteStatsBase> & stats)
+    : SinkToStorage(input_header)
+    , context_(context)
+    , stats_(stats)
+    , empty_delta_stats_(DeltaStats::create(input_header, partition_by))
+    , bucketed_write_(isBucketedWrite(input_header))
+{
+    const auto config = ExecutorConfig::loadFromContext(context);
+    max_open_writers_ = config.max_partition_writers;
+    max_pending_bytes_ = config.max_partition_writer_pending_bytes;
+
+    for (const auto & name : partition_by)
+        key_positions_.push_back(input_header.getPositionByName(name));
+    if (bucketed_write_)
+        key_positions_.push_back(input_header.columns() - 1);
+    for (const auto position : key_positions_)
+        key_header_.insert(input_header.getByPosition(position).cloneEmpty());
+
+    /// The expression is only evaluated for the first row of each distinct key
+    auto partition_by_ast = make_partition_expression(partition_by, input_header);
+    auto syntax_result = TreeRewriter(context).analyze(partition_by_ast, key_header_.getNamesAndTypesList());
+    partition_id_expr_ = ExpressionAnalyzer(partition_by_ast, syntax_result, context).getActions(false);
+    partition_id_column_ = partition_by_ast->getColumnName();
+}
+
+void SparkPartitionedBaseSink::consume(Chunk & chunk)
+{
+    const size_t rows = chunk.getNumRows();
+    if (rows == 0)
+        return;
+    const auto & columns = chunk.getColumns();
+
+    Columns key_columns;
+    ColumnRawPtrs key_column_ptrs;
+    for (const auto position : key_positions_)
+    {
+        key_columns.emplace_back(columns[position]->convertToFullColumnIfConst());
+        key_column_ptrs.push_back(key_columns.back().get());
+    }
+
+    const size_t known_partitions = partitions_.size();
+    std::vector<size_t> new_partition_rows;
+    std::vector<size_t> chunk_partitions;
+    selector_.resize(rows);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const StringRef key = serializeKeysToPoolContiguous(row, key_column_ptrs.size(), key_column_ptrs, keys_arena_);
+        HashMapWithSavedHash<StringRef, size_t>::LookupResult it;
+        bool inserted;
+        partition_index_.emplace(key, it, inserted);
+        if (inserted)
+        {
+            it->getMapped() = partitions_.size();
+            partitions_.emplace_back();
+            chunk_part_index_.push_back(NO_PART);
+            new_partition_rows.push_back(row);
+        }
+        else
+            keys_arena_.rollback(key.size);
+
+        const size_t partition = it->getMapped();
+        if (chunk_part_index_[partition] == NO_PART)
+        {
+            chunk_part_index_[partition] = chunk_partitions.size();
+            chunk_partitions.push_back(partition);
+        }
+        selector_[row] = chunk_part_index_[partition];
+    }
+    if (!new_partition_rows.empty())
+        buildPartitionIds(key_columns, new_partition_rows, known_partitions);
+
+    std::vector<MutableColumns> parts(chunk_partitions.size());
+    for (const auto & column : columns)
+    {
+        auto scattered = column->scatter(chunk_partitions.size(), selector_);
+        for (size_t i = 0; i < parts.size(); ++i)
+            parts[i].emplace_back(std::move(scattered[i]));
+    }
+
+    for (size_t i = 0; i < chunk_partitions.size(); ++i)
+    {
+        chunk_part_index_[chunk_partitions[i]] = NO_PART;
+        auto & partition = partitions_[chunk_partitions[i]];
+        if (!partition.writer && !partition.grouped && (max_open_writers_ == 0 || open_writers_ < max_open_writers_))
+            openWriter(partition);
+
+        if (partition.writer)
+        {
+            const size_t part_rows = parts[i].front()->size();
+            partition.writer->push(Chunk(std::move(parts[i]), part_rows));
+            continue;
+        }
+
+        partition.grouped = true;
+        /// The scattered parts of a const column are const, their rows can't be appended to the pending rows.
+        for (auto & column : parts[i])
+        {
+            column = IColumn::mutate(column->convertToFullColumnIfConst());
+            pending_bytes_ += column->allocatedBytes();
+        }
+        if (partition.pending.empty())
+            partition.pending = std::move(parts[i]);
+        else
+        {
+            for (size_t col = 0; col < parts[i].size(); ++col)
+                partition.pending[col]->insertRangeFrom(*parts[i][col], 0, parts[i][col]->size());
+        }
+    }
+
+    if (max_pending_bytes_ && pending_bytes_ > max_pending_bytes_)
+        spillPending();
+}
+
+void SparkPartitionedBaseSink::spillPending()
+{
+    Block header = getHeader().cloneEmpty();
+    header.insert({std::make_shared<DataTypeUInt64>(), PARTITION_INDEX_COLUMN});
+    auto & run = spilled_runs_.emplace_back(header, context_->getTempDataOnDisk().get());
+
+    size_t rows_spilled = 0;
+    for (size_t index = 0; index < partitions_.size(); ++index)
+    {
+        auto & partition = partitions_[index];
+        if (partition.pending.empty())
+            continue;
+
+        Columns pending;
+        for (auto & column : partition.pending)
+            pending.emplace_back(column->convertToFullColumnIfConst());
+        partition.pending.clear();
+
+        const size_t rows = pending.front()->size();
+        for (size_t offset = 0; offset < rows; offset += DEFAULT_BLOCK_SIZE)
+        {
+            const size_t length = std::min<size_t>(DEFAULT_BLOCK_SIZE, rows - offset);
+            Columns slice;
+            for (const auto & column : pending)
+                slice.emplace_back(column->cut(offset, length));
+            slice.emplace_back(ColumnUInt64::create(length, index));
+            run->write(header.cloneWithColumns(std::move(slice)));
+        }
+        rows_spilled += rows;
+    }
+    run.finishWriting();
+
+    LOG_DEBUG(
+        getLogger("SparkPartitionedBaseSink"),
+        "Spilled {} rows ({}) of grouped partitions into run {}",
+        rows_spilled,
+        ReadableSize(pending_bytes_),
+        spilled_runs_.size());
+    pending_bytes_ = 0;
+}
+
+void SparkPartitionedBaseSink::onFinish()
+{
+    /// Release the buffers of the open writers before the grouped partitions are written with one writer at a time
+    for (auto & partition : partitions_)
+        if (partition.writer)
+            closeWriter(partition);
+
+    if (spilled_runs_.empty())
+        writeGroupedFromMemory();
+    else
+        writeGroupedFromRuns();
+
+    const size_t grouped_partitions = std::ranges::count_if(partitions_, [](const Partition & partition) { return partition.grouped; });
+    if (grouped_partitions)
+        LOG_INFO(
+            getLogger("SparkPartitionedBaseSink"),
+            "Reached {} open partition writers, {} of {} partitions were grouped and written at the end, {} runs spilled",
+            max_open_writers_,
+            grouped_partitions,
+            partitions_.size(),
+            spilled_runs_.size());
+}
+
+void SparkPartitionedBaseSink::writeGroupedFromMemory()
+{
+    for (auto & partition : partitions_)
+    {
+        if (partition.pending.empty())
+            continue;
+
+        openWriter(partition);
+        Columns pending;
+        for (auto & column : partition.pending)
+            pending.emplace_back(std::move(column));
+        partition.pending.clear();
+
+        const size_t rows = pending.front()->size();
+        for (size_t offset = 0; offset < rows; offset += DEFAULT_BLOCK_SIZE)
+        {
+            const size_t length = std::min<size_t>(DEFAULT_BLOCK_SIZE, rows - offset);
+            Columns slice;
+            for (const auto & column : pending)
+                slice.emplace_back(column->cut(offset, length));
+            partition.writer->push(Chunk(std::move(slice), length));
+        }
+        closeWriter(partition);
+    }
+}
+
+void SparkPartitionedBaseSink::writeGroupedFromRuns()
+{
+    if (pending_bytes_)
+        spillPending();
+
+    /// Every run is sorted by the partition index, so the partitions are merged from all the runs in index order
+    /// and each grouped partition is still written by a single writer.
+    struct RunCursor
+    {
+        TemporaryBlockStreamReaderHolder reader;
+        Block block;
+        size_t offset = 0;
+        bool finished = false;
+    };
+    std::vector<RunCursor> cursors;
+    cursors.reserve(spilled_runs_.size());
+    for (auto & run : spilled_runs_)
+        cursors.push_back(RunCursor{run.getReadStream(), {}, 0, false});
+
+    const size_t index_position = getHeader().columns();
+    for (size_t index = 0; index < partitions_.size(); ++index)
+    {
+        auto & partition = partitions_[index];
+        if (!partition.grouped)
+            continue;
+
+        openWriter(partition);
+        for (auto & cursor : cursors)
+        {
+            while (!cursor.finished)
+            {
+                if (cursor.offset == cursor.block.rows())
+                {
+                    cursor.block = cursor.reader->read();
+                    cursor.offset = 0;
+                    cursor.finished = !cursor.block.rows();
+                    continue;
+                }
+
+                const auto & indexes = assert_cast<const ColumnUInt64 &>(*cursor.block.getByPosition(index_position).column).getData();
+                size_t end = cursor.offset;
+                while (end < indexes.size() && indexes[end] == index)
+                    ++end;
+                if (end == cursor.offset)
+                    break;
+
+                Columns slice;
+                for (size_t col = 0; col < index_position; ++col)
+                    slice.emplace_back(cursor.block.getByPosition(col).column->cut(cursor.offset, end - cursor.offset));
+                partition.writer->push(Chunk(std::move(slice), end - cursor.offset));
+                cursor.offset = end;
+            }
+        }
+        closeWriter(partition);
+    }
+}
+
+void SparkPartitionedBaseSink::onException(std::exception_ptr /* exception */)
+{
+    for (auto & partition : partitions_)
+        if (partition.writer)
+            partition.writer->cancel();
+}
+
+void SparkPartitionedBaseSink::openWriter(Partition & partition)
+{
+    Chain chain;
+    chain.addSource(createSinkForPartition(partition.id));
+    partition.pipeline = std::make_unique<QueryPipeline>(std::move(chain));
+    partition.writer = std::make_unique<PushingPipelineExecutor>(*partition.pipeline);
+    partition.writer->start();
+    ++open_writers_;
+}
+
+void SparkPartitionedBaseSink::closeWriter(Partition & partition)
+{
+    partition.writer->finish();
+    partition.writer.reset();
+    partition.pipeline.reset();
+    --open_writers_;
+}
+
+void SparkPartitionedBaseSink::buildPartitionIds(const Columns & key_columns, const std::vector<size_t> & rows, size_t first_partition)
+{
+    MutableColumns new_keys = key_header_.cloneEmptyColumns();
+    for (size_t i = 0; i < new_keys.size(); ++i)
+    {
+        new_keys[i]->reserve(rows.size());
+        for (const auto row : rows)
+            new_keys[i]->insertFrom(*key_columns[i], row);
+    }
+
+    Block block = key_header_.cloneWithColumns(std::move(new_keys));
+    partition_id_expr_->execute(block);
+    const auto & partition_ids = block.getByName(partition_id_column_).column;
+    for (size_t i = 0; i < rows.size(); ++i)
+        partitions_[first_partition + i].id = partition_ids->getDataAt(i).toString();
+}
+
 std::unique_ptr<NativeOutputWriter> NormalFileWriter::create(
     const DB::ContextPtr & context, const std::string & file_uri, const DB::Block & preferred_schema, const std::string & format_hint)
 {
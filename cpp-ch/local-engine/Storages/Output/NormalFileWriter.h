@@ -19,6 +19,8 @@
 #include <Core/Block.h>
 #include <Core/Field.h>
 #include <Interpreters/Context.h>
+#include <Interpreters/ExpressionActions.h>
+#include <Interpreters/TemporaryDataOnDisk.h>
 #include <Parsers/ASTFunction.h>
 #include <Parsers/ASTIdentifier.h>
 #include <Parsers/ASTLiteral.h>
@@ -26,6 +28,7 @@
 #include <Processors/Executors/PushingPipelineExecutor.h>
 #include <Processors/ISimpleTransform.h>
 #include <Processors/Sinks/SinkToStorage.h>
+#include <QueryPipeline/QueryPipeline.h>
 #include <Storages/NativeOutputWriter.h>
 #include <Storages/Output/OutputFormatFile.h>
 #include <Storages/PartitionedSink.h>
@@ -34,6 +37,7 @@
 #include <Common/BlockTypeUtils.h>
 #include <Common/CHUtil.h>
 #include <Common/FieldVisitorsAccurateComparison.h>
+#include <Common/HashTable/HashMap.h>
 
 namespace local_engine
 {
@@ -381,7 +385,12 @@ protected:
     }
 };
 
-class SparkPartitionedBaseSink : public DB::PartitionedSink
+/// Routes every row to the sink of its dynamic partition. Rows are keyed by the typed values of the partition (and bucket)
+/// columns, the partition directory, e.g. `col1=a/col2=b`, is only built once per distinct key.
+/// With ExecutorConfig::MAX_PARTITION_WRITERS set, rows of the partitions which don't get one of the limited writers are
+/// grouped by partition in memory and written one partition after another when the input is finished, so a task touching
+/// many partitions doesn't keep a file writer with its buffers open for each of them.
+class SparkPartitionedBaseSink : public DB::SinkToStorage
 {
 public:
     static const std::string DEFAULT_PARTITION_NAME;
@@ -424,7 +433,7 @@ public:
         return DB::makeASTFunction("concat", std::move(arguments));
     }
 
-    DB::SinkPtr createSinkForPartition(const String & partition_id) override
+    virtual DB::SinkPtr createSinkForPartition(const String & partition_id)
     {
         if (bucketed_write_)
         {
@@ -437,25 +446,64 @@ public:
 
     virtual DB::SinkPtr createSinkForPartition(const String & partition_id, const String & bucket) = 0;
 
+    String getName() const override { return "SparkPartitionedBaseSink"; }
+
+    void consume(DB::Chunk & chunk) override;
+    void onFinish() override;
+    void onException(std::exception_ptr exception) override;
+
 protected:
     DB::ContextPtr context_;
     std::shared_ptr<WriteStatsBase> stats_;
     DeltaStats empty_delta_stats_;
     bool bucketed_write_;
 
+private:
+    struct Partition
+    {
+        String id;
+        std::unique_ptr<DB::QueryPipeline> pipeline;
+        std::unique_ptr<DB::PushingPipelineExecutor> writer;
+        /// Rows waiting for the grouped write at the end, only used once the writer limit is reached.
+        DB::MutableColumns pending;
+        /// Set once the partition got rows without a writer, all its rows are written at the end from then on.
+        bool grouped = false;
+    };
+
+    void openWriter(Partition & partition);
+    void closeWriter(Partition & partition);
+    /// Writes the pending rows of all the partitions into one run on disk, ordered by the index in partitions_.
+    void spillPending();
+    void writeGroupedFromMemory();
+    void writeGroupedFromRuns();
+    void buildPartitionIds(const DB::Columns & key_columns, const std::vector<size_t> & rows, size_t first_partition);
+
+    DB::Block key_header_;
+    DB::ColumnNumbers key_positions_;
+    DB::ExpressionActionsPtr partition_id_expr_;
+    String partition_id_column_;
+    size_t max_open_writers_;
+    size_t open_writers_ = 0;
+    size_t max_pending_bytes_;
+    size_t pending_bytes_ = 0;
+    /// Each run holds the input columns plus the partition index, sorted by the partition index.
+    std::vector<DB::TemporaryBlockStreamHolder> spilled_runs_;
+
+    /// Serialized key values, see serializeKeysToPoolContiguous, to the index in partitions_.
+    DB::Arena keys_arena_;
+    HashMapWithSavedHash<StringRef, size_t> partition_index_;
+    std::vector<Partition> partitions_;
+
+    /// Per chunk scratch: index in partitions_ to the index of the scattered part.
+    std::vector<size_t> chunk_part_index_;
+    DB::IColumn::Selector selector_;
+
 public:
     SparkPartitionedBaseSink(
         const DB::ContextPtr & context,
         const DB::Names & partition_by,
         const DB::Block & input_header,
-        const std::shared_ptr<WriteStatsBase> & stats)
-        : PartitionedSink(make_partition_expression(partition_by, input_header), context, input_header)
-        , context_(context)
-        , stats_(stats)
-        , bucketed_write_(isBucketedWrite(input_header))
-        , empty_delta_stats_(DeltaStats::create(input_header, partition_by))
-    {
-    }
+        const std::shared_ptr<WriteStatsBase> & stats);
 };
 
 class SubstraitPartitionedFileSink final : public SparkPartitionedBaseSink
@@ -491,7 +539,7 @@ public:
         bool bucketed_write = !bucket.empty();
         std::string filename = bucketed_write ? generator_.generate(bucket) : generator_.generate();
         const auto partition_path = fmt::format("{}/{}", partition_id, filename);
-        validatePartitionKey(partition_path, true);
+        DB::PartitionedSink::validatePartitionKey(partition_path, true);
         return std::make_shared<SubstraitFileSink>(
             context_, base_path_, partition_id, bucketed_write, filename, format_hint_, sample_block_, stats_, empty_delta_stats_);
     }
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ParquetMetadataCache.h"
+
+#if USE_PARQUET
+#include <Common/formatReadable.h>
+#include <Common/logger_useful.h>
+
+namespace local_engine
+{
+ParquetMetadataCache & ParquetMetadataCache::instance()
+{
+    static ParquetMetadataCache cache;
+    return cache;
+}
+
+void ParquetMetadataCache::initialize(size_t max_bytes_)
+{
+    std::lock_guard lock(mutex);
+    max_bytes = max_bytes_;
+    lru_list.clear();
+    entries.clear();
+    current_bytes = 0;
+    LOG_INFO(logger, "Initialize parquet metadata cache, max bytes: {}", ReadableSize(max_bytes_));
+}
+
+ParquetMetadataCache::MetadataPtr ParquetMetadataCache::get(const String & key)
+{
+    if (!enabled())
+        return nullptr;
+    std::lock_guard lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end())
+    {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    lru_list.splice(lru_list.end(), lru_list, it->second);
+    return it->second->metadata;
+}
+
+void ParquetMetadataCache::set(const String & key, const MetadataPtr & metadata)
+{
+    if (!enabled() || !metadata)
+        return;
+    const size_t bytes = metadata->size();
+    std::lock_guard lock(mutex);
+    if (bytes > max_bytes || entries.contains(key))
+        return;
+    while (!lru_list.empty() && current_bytes + bytes > max_bytes)
+    {
+        auto & evicted = lru_list.front();
+        current_bytes -= evicted.bytes;
+        entries.erase(evicted.key);
+        lru_list.pop_front();
+    }
+    lru_list.push_back({key, metadata, bytes});
+    entries.emplace(key, std::prev(lru_list.end()));
+    current_bytes += bytes;
+    LOG_TEST(logger, "Cache footer of {}, cached bytes: {}, entries: {}, hits: {}, misses: {}", key, current_bytes, entries.size(), hits, misses);
+}
+
+void ParquetMetadataCache::clear()
+{
+    std::lock_guard lock(mutex);
+    lru_list.clear();
+    entries.clear();
+    current_bytes = 0;
+}
+}
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <config.h>
+
+#if USE_PARQUET
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <base/types.h>
+#include <parquet/metadata.h>
+#include <Common/Logger.h>
+
+namespace local_engine
+{
+/// An executor wide LRU cache of parsed parquet footers, shared by all tasks. The cache key must identify the content of
+/// the file, e.g. path + size + modification time, so a rewritten file is never read with a stale footer.
+/// The memory of a footer is approximated by its serialized size.
+class ParquetMetadataCache
+{
+public:
+    using MetadataPtr = std::shared_ptr<parquet::FileMetaData>;
+
+    static ParquetMetadataCache & instance();
+
+    /// 0 disables the cache.
+    void initialize(size_t max_bytes_);
+    bool enabled() const { return max_bytes > 0; }
+
+    MetadataPtr get(const String & key);
+    void set(const String & key, const MetadataPtr & metadata);
+    void clear();
+
+private:
+    ParquetMetadataCache() = default;
+
+    struct Entry
+    {
+        String key;
+        MetadataPtr metadata;
+        size_t bytes = 0;
+    };
+    using LRUList = std::list<Entry>;
+
+    std::mutex mutex;
+    LRUList lru_list;
+    std::unordered_map<String, LRUList::iterator> entries;
+    std::atomic<size_t> max_bytes = 0;
+    size_t current_bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    LoggerPtr logger = getLogger("ParquetMetadataCache");
+};
+}
+#endif
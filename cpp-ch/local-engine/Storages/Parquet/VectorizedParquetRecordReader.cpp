@@ -196,7 +196,7 @@ bool VectorizedParquetRecordReader::initialize(
     /// column pruning
     DB::ArrowFieldIndexUtil field_util(
         format_settings_.parquet.case_insensitive_column_matching, format_settings_.parquet.allow_missing_columns);
-    auto index_mapping = field_util.findRequiredIndices(header, schema, *metadata);
+    auto index_mapping = field_util.findRequiredIndices(header, schema, file_metadata);
 
     std::vector<Int32> column_indices;
     for (const auto & [clickhouse_header_index, parquet_indexes] : index_mapping)
@@ -389,7 +389,7 @@ DB::Chunk VectorizedParquetBlockInputFormat::read()
         const auto arrow_file = DB::asArrowFile(*in, record_reader_.format_settings_, is_stopped, "Parquet", PARQUET_MAGIC_BYTES);
         if (is_stopped != 0)
             return {};
-        if (!record_reader_.initialize(getPort().getHeader(), arrow_file, column_index_filter_))
+        if (!record_reader_.initialize(getPort().getHeader(), arrow_file, column_index_filter_, metadata_))
             return {};
     }
     return record_reader_.nextBatch();
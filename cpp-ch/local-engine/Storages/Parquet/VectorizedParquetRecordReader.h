@@ -232,6 +232,7 @@ class VectorizedParquetBlockInputFormat final : public DB::IInputFormat
     std::atomic<int> is_stopped{0};
     VectorizedParquetRecordReader record_reader_;
     ColumnIndexFilterPtr column_index_filter_;
+    std::shared_ptr<parquet::FileMetaData> metadata_;
 
 protected:
     void onCancel() noexcept override { is_stopped = 1; }
@@ -239,6 +240,8 @@ protected:
 public:
     VectorizedParquetBlockInputFormat(DB::ReadBuffer & in_, const DB::Block & header_, const DB::FormatSettings & format_settings);
     void setColumnIndexFilter(const ColumnIndexFilterPtr & column_index_filter) { column_index_filter_ = column_index_filter; }
+    /// The footer which was already read, avoid reading it again.
+    void setFileMetaData(const std::shared_ptr<parquet::FileMetaData> & metadata) { metadata_ = metadata; }
     String getName() const override { return "VectorizedParquetBlockInputFormat"; }
     void resetParser() override;
 
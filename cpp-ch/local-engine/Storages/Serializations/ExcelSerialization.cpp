@@ -91,7 +91,7 @@ void ExcelSerialization::deserializeTextCSV(IColumn & column, ReadBuffer & istr,
     }
     else if (typeid_cast<const SerializationString *>(nested_ptr.get()))
     {
-        deserializeExcelStringTextCSV(column, istr, settings, escape);
+        deserializeExcelStringTextCSV(column, istr, settings, escape, structural_index.get());
     }
     else if (typeid_cast<const SerializationBool *>(nested_ptr.get()))
     {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <DataTypes/Serializations/ISerialization.h>
+#include <Storages/Serializations/ExcelStructuralIndex.h>
 #include <base/extended_types.h>
 #include <Common/DateLUTImpl.h>
 
@@ -37,7 +38,10 @@ using namespace DB;
 class ExcelSerialization final : public DB::ISerialization
 {
 public:
-    explicit ExcelSerialization(const SerializationPtr & nested_, String escape_) : nested_ptr(nested_), escape(escape_){}
+    explicit ExcelSerialization(const SerializationPtr & nested_, String escape_, ExcelStructuralIndexPtr structural_index_ = nullptr)
+        : nested_ptr(nested_), escape(escape_), structural_index(structural_index_)
+    {
+    }
 
     void serializeBinary(const Field &, WriteBuffer &, const FormatSettings &) const override
     {
@@ -111,5 +115,6 @@ private:
 private:
     SerializationPtr nested_ptr;
     String escape;
+    ExcelStructuralIndexPtr structural_index;
 };
 }
@@ -55,7 +55,8 @@ inline void appendToStringOrVector(PaddedPODArray<UInt8> & s, ReadBuffer & rb, c
 }
 
 template <typename Vector, bool include_quotes>
-void readExcelCSVQuoteString(Vector & s, ReadBuffer & buf, const char delimiter, const String & escape_value, const char & quote)
+void readExcelCSVQuoteString(
+    Vector & s, ReadBuffer & buf, const char delimiter, const String & escape_value, const char & quote, ExcelStructuralIndex * index)
 {
     if constexpr (include_quotes)
         s.push_back(quote);
@@ -67,6 +68,14 @@ void readExcelCSVQuoteString(Vector & s, ReadBuffer & buf, const char delimiter,
 
         [&]()
         {
+            if (auto * buffer_index = index ? index->prepare(buf) : nullptr)
+            {
+                /// The index also marks the other quote character, skip over it.
+                next_pos = const_cast<char *>(buffer_index->findQuote(next_pos));
+                while (next_pos < buf.buffer().end() && *next_pos != quote && (escape_value.empty() || *next_pos != escape_value[0]))
+                    next_pos = const_cast<char *>(buffer_index->findQuote(next_pos + 1));
+                return;
+            }
 #ifdef __SSE2__
             auto qe = _mm_set1_epi8(quote);
             for (; next_pos + 15 < buf.buffer().end(); next_pos += 16)
@@ -162,7 +171,8 @@ void readExcelCSVQuoteString(Vector & s, ReadBuffer & buf, const char delimiter,
 }
 
 template <typename Vector>
-void readExcelCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::CSV & settings, const String & escape_value)
+void readExcelCSVStringInto(
+    Vector & s, ReadBuffer & buf, const FormatSettings::CSV & settings, const String & escape_value, ExcelStructuralIndex * index)
 {
     /// Empty string
     if (buf.eof())
@@ -180,9 +190,9 @@ void readExcelCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::
     {
         ++buf.position();
         if (!buf.eof() && *buf.position() == '{' && *(buf.position() + 1) == maybe_quote)
-            readExcelCSVQuoteString<Vector, true>(s, buf, delimiter, escape_value, maybe_quote);
+            readExcelCSVQuoteString<Vector, true>(s, buf, delimiter, escape_value, maybe_quote, index);
         else
-            readExcelCSVQuoteString(s, buf, delimiter, escape_value, maybe_quote);
+            readExcelCSVQuoteString(s, buf, delimiter, escape_value, maybe_quote, index);
     }
     else
     {
@@ -234,6 +244,11 @@ void readExcelCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::
 
             [&]()
             {
+                if (auto * buffer_index = index ? index->prepare(buf) : nullptr)
+                {
+                    next_pos = const_cast<char *>(buffer_index->findTerminator(next_pos));
+                    return;
+                }
 #ifdef __SSE2__
                 auto rc = _mm_set1_epi8('\r');
                 auto nc = _mm_set1_epi8('\n');
@@ -283,9 +298,10 @@ void readExcelCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::
     }
 }
 
-void deserializeExcelStringTextCSV(IColumn & column, ReadBuffer & istr, const FormatSettings & settings, const String & escape_value)
+void deserializeExcelStringTextCSV(
+    IColumn & column, ReadBuffer & istr, const FormatSettings & settings, const String & escape_value, ExcelStructuralIndex * index)
 {
-    excelRead(column, [&](ColumnString::Chars & data) { readExcelCSVStringInto(data, istr, settings.csv, escape_value); });
+    excelRead(column, [&](ColumnString::Chars & data) { readExcelCSVStringInto(data, istr, settings.csv, escape_value, index); });
 }
 
 }
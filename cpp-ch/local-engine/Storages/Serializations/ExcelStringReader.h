@@ -21,6 +21,7 @@
 #include <Columns/IColumn.h>
 #include <Formats/FormatSettings.h>
 #include <IO/ReadBuffer.h>
+#include <Storages/Serializations/ExcelStructuralIndex.h>
 
 
 namespace local_engine
@@ -50,13 +51,22 @@ static inline void excelRead(IColumn & column, Reader && reader)
     }
 }
 
+/// index, when given, must be built for the same delimiter and escape, it replaces the scans for the end of the field.
 template <typename Vector, bool include_quotes = false>
-void readExcelCSVQuoteString(Vector & s, ReadBuffer & buf, const char delimiter, const String & escape_value, const char & quote);
+void readExcelCSVQuoteString(
+    Vector & s,
+    ReadBuffer & buf,
+    const char delimiter,
+    const String & escape_value,
+    const char & quote,
+    ExcelStructuralIndex * index = nullptr);
 template <typename Vector>
-void readExcelCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::CSV & settings, const String & escape_value);
+void readExcelCSVStringInto(
+    Vector & s, ReadBuffer & buf, const FormatSettings::CSV & settings, const String & escape_value, ExcelStructuralIndex * index = nullptr);
 
 
-void deserializeExcelStringTextCSV(IColumn & column, ReadBuffer & istr, const FormatSettings & settings, const String & escape_value);
+void deserializeExcelStringTextCSV(
+    IColumn & column, ReadBuffer & istr, const FormatSettings & settings, const String & escape_value, ExcelStructuralIndex * index = nullptr);
 
 
 }
@@ -0,0 +1,198 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ExcelStructuralIndex.h"
+
+#include <algorithm>
+#include <bit>
+#include <Common/TargetSpecific.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+#if USE_MULTITARGET_CODE
+#    include <immintrin.h>
+#endif
+
+namespace local_engine
+{
+namespace
+{
+/// Blocks indexed at once when a lookup goes past the indexed part of the buffer.
+constexpr size_t INDEX_BATCH_BLOCKS = 64;
+
+void indexBlocksScalar(
+    const char * data, size_t size, char delimiter, char escape, UInt64 * terminators, UInt64 * quotes, size_t first_block, size_t last_block)
+{
+    for (size_t block = first_block; block < last_block; ++block)
+    {
+        UInt64 terminator_mask = 0;
+        UInt64 quote_mask = 0;
+        const size_t block_begin = block * 64;
+        const size_t block_size = std::min<size_t>(64, size - block_begin);
+        for (size_t i = 0; i < block_size; ++i)
+        {
+            const char c = data[block_begin + i];
+            terminator_mask |= static_cast<UInt64>(c == delimiter || c == '\r' || c == '\n') << i;
+            quote_mask |= static_cast<UInt64>(c == '"' || c == '\'' || c == escape) << i;
+        }
+        terminators[block] = terminator_mask;
+        quotes[block] = quote_mask;
+    }
+}
+
+#ifdef __SSE2__
+void indexBlocksSSE2(
+    const char * data, size_t size, char delimiter, char escape, UInt64 * terminators, UInt64 * quotes, size_t first_block, size_t last_block)
+{
+    const __m128i delimiter_chars = _mm_set1_epi8(delimiter);
+    const __m128i cr_chars = _mm_set1_epi8('\r');
+    const __m128i lf_chars = _mm_set1_epi8('\n');
+    const __m128i double_quote_chars = _mm_set1_epi8('"');
+    const __m128i single_quote_chars = _mm_set1_epi8('\'');
+    const __m128i escape_chars = _mm_set1_epi8(escape);
+
+    size_t block = first_block;
+    for (; block < last_block && (block + 1) * 64 <= size; ++block)
+    {
+        UInt64 terminator_mask = 0;
+        UInt64 quote_mask = 0;
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + block * 64 + lane * 16));
+            const __m128i terminator = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, cr_chars), _mm_cmpeq_epi8(bytes, lf_chars)), _mm_cmpeq_epi8(bytes, delimiter_chars));
+            const __m128i quote = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, double_quote_chars), _mm_cmpeq_epi8(bytes, single_quote_chars)),
+                _mm_cmpeq_epi8(bytes, escape_chars));
+            terminator_mask |= static_cast<UInt64>(static_cast<UInt16>(_mm_movemask_epi8(terminator))) << (lane * 16);
+            quote_mask |= static_cast<UInt64>(static_cast<UInt16>(_mm_movemask_epi8(quote))) << (lane * 16);
+        }
+        terminators[block] = terminator_mask;
+        quotes[block] = quote_mask;
+    }
+    indexBlocksScalar(data, size, delimiter, escape, terminators, quotes, block, last_block);
+}
+#endif
+}
+
+DECLARE_AVX2_SPECIFIC_CODE(
+
+    inline size_t indexBlocks(
+        const char * data,
+        size_t size,
+        char delimiter,
+        char escape,
+        UInt64 * terminators,
+        UInt64 * quotes,
+        size_t first_block,
+        size_t last_block) {
+        const __m256i delimiter_chars = _mm256_set1_epi8(delimiter);
+        const __m256i cr_chars = _mm256_set1_epi8('\r');
+        const __m256i lf_chars = _mm256_set1_epi8('\n');
+        const __m256i double_quote_chars = _mm256_set1_epi8('"');
+        const __m256i single_quote_chars = _mm256_set1_epi8('\'');
+        const __m256i escape_chars = _mm256_set1_epi8(escape);
+
+        size_t block = first_block;
+        for (; block < last_block && (block + 1) * 64 <= size; ++block)
+        {
+            UInt64 terminator_mask = 0;
+            UInt64 quote_mask = 0;
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + block * 64 + lane * 32));
+                const __m256i terminator = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(bytes, cr_chars), _mm256_cmpeq_epi8(bytes, lf_chars)),
+                    _mm256_cmpeq_epi8(bytes, delimiter_chars));
+                const __m256i quote = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(bytes, double_quote_chars), _mm256_cmpeq_epi8(bytes, single_quote_chars)),
+                    _mm256_cmpeq_epi8(bytes, escape_chars));
+                terminator_mask |= static_cast<UInt64>(static_cast<UInt32>(_mm256_movemask_epi8(terminator))) << (lane * 32);
+                quote_mask |= static_cast<UInt64>(static_cast<UInt32>(_mm256_movemask_epi8(quote))) << (lane * 32);
+            }
+            terminators[block] = terminator_mask;
+            quotes[block] = quote_mask;
+        }
+        return block;
+    }
+
+)
+
+ExcelStructuralIndex::ExcelStructuralIndex(char delimiter_, const String & escape_value)
+    : delimiter(delimiter_), escape(escapeChar(escape_value))
+{
+}
+
+ExcelStructuralIndex * ExcelStructuralIndex::prepare(const DB::ReadBuffer & buf)
+{
+    if (buf.buffer().size() < MIN_INDEXED_BUFFER_SIZE)
+        return nullptr;
+
+    /// count() - offset() is the stream position of the working buffer, it tells apart successive buffers which reuse
+    /// the same memory.
+    if (owner != &buf || begin != buf.buffer().begin() || end != buf.buffer().end() || buffer_start != buf.count() - buf.offset())
+        reset(buf);
+    return this;
+}
+
+void ExcelStructuralIndex::reset(const DB::ReadBuffer & buf)
+{
+    owner = &buf;
+    begin = buf.buffer().begin();
+    end = buf.buffer().end();
+    buffer_start = buf.count() - buf.offset();
+    const size_t num_blocks = (end - begin + 63) / 64;
+    terminators.resize(num_blocks);
+    quotes.resize(num_blocks);
+    indexed_blocks = 0;
+}
+
+void ExcelStructuralIndex::indexBlocks(size_t up_to_block)
+{
+    const size_t last_block = std::min(terminators.size(), std::max(up_to_block, indexed_blocks + INDEX_BATCH_BLOCKS));
+    const size_t size = end - begin;
+    size_t block = indexed_blocks;
+#if USE_MULTITARGET_CODE
+    if (DB::isArchSupported(DB::TargetArch::AVX2))
+        block = TargetSpecific::AVX2::indexBlocks(begin, size, delimiter, escape, terminators.data(), quotes.data(), block, last_block);
+#endif
+#ifdef __SSE2__
+    indexBlocksSSE2(begin, size, delimiter, escape, terminators.data(), quotes.data(), block, last_block);
+#else
+    indexBlocksScalar(begin, size, delimiter, escape, terminators.data(), quotes.data(), block, last_block);
+#endif
+    indexed_blocks = last_block;
+}
+
+const char * ExcelStructuralIndex::find(const char * pos, const std::vector<UInt64> & masks)
+{
+    size_t offset = pos - begin;
+    size_t block = offset / 64;
+    UInt64 mask_from = ~0ULL << (offset % 64);
+    for (; block < masks.size(); ++block, mask_from = ~0ULL)
+    {
+        if (block >= indexed_blocks)
+            indexBlocks(block + 1);
+        /// Bits past the end of the buffer are never set.
+        if (const UInt64 mask = masks[block] & mask_from)
+            return begin + block * 64 + std::countr_zero(mask);
+    }
+    return end;
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <IO/ReadBuffer.h>
+#include <base/types.h>
+
+namespace local_engine
+{
+
+/// Bitmaps of the structural characters of a read buffer's working buffer, one bit per byte: field terminators
+/// (delimiter, '\r', '\n') and quotes ('"', '\'' and the escape character). The buffer is indexed with SIMD, 64 bytes per
+/// word, once and lazily as fields are read, so a field finds its end with a few bit operations instead of rescanning
+/// its bytes. Quote hits are candidates, the caller checks which quote character it is.
+///
+/// ExcelRowInputFormat owns an index and hands it to its reader and serializations, the Excel string readers use it when
+/// they are given one and fall back to scanning the buffer otherwise.
+class ExcelStructuralIndex
+{
+public:
+    /// Small working buffers, e.g. the own memory of a PeekableReadBuffer holding a few peeked bytes, are not worth an
+    /// index and may be rewritten in place, so they are always scanned.
+    static constexpr size_t MIN_INDEXED_BUFFER_SIZE = 64 * 1024;
+
+    ExcelStructuralIndex(char delimiter_, const String & escape_value);
+
+    /// Index of the working buffer of buf, rebuilt when buf moved to another buffer, or nullptr when the buffer is too
+    /// small.
+    ExcelStructuralIndex * prepare(const DB::ReadBuffer & buf);
+
+    /// First field terminator in [pos, buffer end), or buffer end.
+    const char * findTerminator(const char * pos) { return find(pos, terminators); }
+    /// First quote or escape candidate in [pos, buffer end), or buffer end.
+    const char * findQuote(const char * pos) { return find(pos, quotes); }
+
+private:
+    /// Without an escape character the quote characters stand in for it, they are candidates anyway.
+    static char escapeChar(const String & escape_value) { return escape_value.empty() ? '"' : escape_value[0]; }
+
+    void reset(const DB::ReadBuffer & buf);
+    void indexBlocks(size_t up_to_block);
+    const char * find(const char * pos, const std::vector<UInt64> & masks);
+
+    const char delimiter;
+    const char escape;
+
+    const DB::ReadBuffer * owner = nullptr;
+    const char * begin = nullptr;
+    const char * end = nullptr;
+    size_t buffer_start = 0;
+
+    std::vector<UInt64> terminators;
+    std::vector<UInt64> quotes;
+    size_t indexed_blocks = 0;
+};
+
+using ExcelStructuralIndexPtr = std::shared_ptr<ExcelStructuralIndex>;
+
+}
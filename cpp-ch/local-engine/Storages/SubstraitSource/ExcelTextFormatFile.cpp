@@ -30,6 +30,7 @@
 #include <Storages/Serializations/ExcelDecimalSerialization.h>
 #include <Storages/Serializations/ExcelSerialization.h>
 #include <Storages/Serializations/ExcelStringReader.h>
+#include <Storages/Serializations/ExcelStructuralIndex.h>
 #include <Common/GlutenSettings.h>
 
 namespace DB
@@ -44,17 +45,30 @@ namespace ErrorCodes
 namespace local_engine
 {
 
-void skipErrorChars(DB::ReadBuffer & buf, bool has_quote, char quote, String & escape, const DB::FormatSettings & settings)
+void skipErrorChars(
+    DB::ReadBuffer & buf, bool has_quote, char quote, String & escape, const DB::FormatSettings & settings, ExcelStructuralIndex * index)
 {
     if (has_quote)
     {
         ColumnString::Chars data;
-        readExcelCSVQuoteString(data, buf, settings.csv.delimiter, escape, quote);
+        readExcelCSVQuoteString(data, buf, settings.csv.delimiter, escape, quote, index);
     }
     else
+    {
         /// skip all chars before quote/delimiter exclude line delimiter
-        while (!buf.eof() && *buf.position() != settings.csv.delimiter && *buf.position() != '\n' && *buf.position() != '\r')
-            ++buf.position();
+        while (!buf.eof())
+        {
+            if (auto * buffer_index = index ? index->prepare(buf) : nullptr)
+                buf.position() = const_cast<char *>(buffer_index->findTerminator(buf.position()));
+            else
+                while (buf.hasPendingData() && *buf.position() != settings.csv.delimiter && *buf.position() != '\n'
+                       && *buf.position() != '\r')
+                    ++buf.position();
+
+            if (buf.hasPendingData())
+                break;
+        }
+    }
 }
 
 bool ExcelTextFormatFile::useThis(const DB::ContextPtr & context)
@@ -79,8 +93,9 @@ FormatFile::InputFormatPtr ExcelTextFormatFile::createInputFormat(const DB::Bloc
         column_names.push_back(item);
     }
 
+    auto structural_index = std::make_shared<ExcelStructuralIndex>(format_settings.csv.delimiter, file_info.text().escape());
     std::shared_ptr<local_engine::ExcelRowInputFormat> txt_input_format = std::make_shared<local_engine::ExcelRowInputFormat>(
-        header, buffer, params, format_settings, column_names, file_info.text().escape());
+        header, buffer, params, format_settings, column_names, file_info.text().escape(), structural_index);
     res->input = txt_input_format;
     return res;
 }
@@ -153,7 +168,8 @@ ExcelRowInputFormat::ExcelRowInputFormat(
     const DB::RowInputFormatParams & params_,
     const DB::FormatSettings & format_settings_,
     DB::Names & input_field_names_,
-    String escape_)
+    String escape_,
+    ExcelStructuralIndexPtr structural_index_)
     : CSVRowInputFormat(
         header_,
         buf_,
@@ -161,8 +177,9 @@ ExcelRowInputFormat::ExcelRowInputFormat(
         true,
         false,
         format_settings_,
-        std::make_unique<ExcelTextFormatReader>(*buf_, input_field_names_, escape_, format_settings_))
+        std::make_unique<ExcelTextFormatReader>(*buf_, input_field_names_, escape_, structural_index_, format_settings_))
     , escape(escape_)
+    , structural_index(structural_index_)
 {
     DB::Serializations gluten_serializations;
     for (const auto & item : data_types)
@@ -195,7 +212,7 @@ ExcelRowInputFormat::ExcelRowInputFormat(
                 nest_type->getDefaultSerialization(), decimal_type.getPrecision(), decimal_type.getScale());
         }
         else
-            nest_serialization = std::make_shared<ExcelSerialization>(nest_type->getDefaultSerialization(), escape);
+            nest_serialization = std::make_shared<ExcelSerialization>(nest_type->getDefaultSerialization(), escape, structural_index);
 
 
         if (item->isNullable())
@@ -209,8 +226,15 @@ ExcelRowInputFormat::ExcelRowInputFormat(
 
 
 ExcelTextFormatReader::ExcelTextFormatReader(
-    DB::PeekableReadBuffer & buf_, DB::Names & input_field_names_, String escape_, const DB::FormatSettings & format_settings_)
-    : CSVFormatReader(buf_, format_settings_), input_field_names(input_field_names_), escape(escape_)
+    DB::PeekableReadBuffer & buf_,
+    DB::Names & input_field_names_,
+    String escape_,
+    ExcelStructuralIndexPtr structural_index_,
+    const DB::FormatSettings & format_settings_)
+    : CSVFormatReader(buf_, format_settings_)
+    , input_field_names(input_field_names_)
+    , escape(escape_)
+    , structural_index(structural_index_)
 {
 }
 
@@ -290,7 +314,7 @@ bool ExcelTextFormatReader::readField(
         if (!isParseError(e.code()))
             throw;
 
-        skipErrorChars(*buf, has_quote, maybe_quote, escape, format_settings);
+        skipErrorChars(*buf, has_quote, maybe_quote, escape, format_settings, structural_index.get());
         column_back_func(column);
         column.insertDefault();
 
@@ -304,7 +328,7 @@ bool ExcelTextFormatReader::readField(
     const auto nestedColumn = DB::removeNullable(column.getPtr());
     if (column_size == nestedColumn->size())
     {
-        skipErrorChars(*buf, has_quote, maybe_quote, escape, format_settings);
+        skipErrorChars(*buf, has_quote, maybe_quote, escape, format_settings, structural_index.get());
         column_back_func(column);
         column.insertDefault();
         return false;
@@ -317,7 +341,7 @@ void ExcelTextFormatReader::skipField()
 {
     skipWhitespacesAndTabs(*buf, format_settings.csv.allow_whitespace_or_tab_as_delimiter);
     ColumnString::Chars data;
-    readExcelCSVStringInto(data, *buf, format_settings.csv, escape);
+    readExcelCSVStringInto(data, *buf, format_settings.csv, escape, structural_index.get());
 }
 
 void ExcelTextFormatReader::preSkipNullValue()
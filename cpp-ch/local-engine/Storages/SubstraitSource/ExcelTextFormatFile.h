@@ -21,6 +21,7 @@
 #include <IO/ReadBuffer.h>
 #include <Processors/Formats/IRowInputFormat.h>
 #include <Processors/Formats/Impl/CSVRowInputFormat.h>
+#include <Storages/Serializations/ExcelStructuralIndex.h>
 #include <Storages/SubstraitSource/FormatFile.h>
 
 namespace local_engine
@@ -64,19 +65,26 @@ public:
         const DB::RowInputFormatParams & params_,
         const DB::FormatSettings & format_settings_,
         DB::Names & input_field_names_,
-        String escape_);
+        String escape_,
+        ExcelStructuralIndexPtr structural_index_);
 
     String getName() const override { return "ExcelRowInputFormat"; }
 
 private:
     String escape;
+    /// Structural characters of the current buffer, shared by the reader and the string serializations.
+    ExcelStructuralIndexPtr structural_index;
 };
 
 class ExcelTextFormatReader final : public DB::CSVFormatReader
 {
 public:
     ExcelTextFormatReader(
-        DB::PeekableReadBuffer & buf_, DB::Names & input_field_names_, String escape_, const DB::FormatSettings & format_settings_);
+        DB::PeekableReadBuffer & buf_,
+        DB::Names & input_field_names_,
+        String escape_,
+        ExcelStructuralIndexPtr structural_index_,
+        const DB::FormatSettings & format_settings_);
 
     std::vector<String> readNames() override;
     std::vector<String> readTypes() override;
@@ -94,5 +102,6 @@ private:
 
     std::vector<String> input_field_names;
     String escape;
+    ExcelStructuralIndexPtr structural_index;
 };
 }
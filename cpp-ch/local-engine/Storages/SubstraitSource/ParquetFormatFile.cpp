@@ -30,6 +30,7 @@
 #include <Processors/Formats/Impl/ArrowBufferedStreams.h>
 #include <Processors/Formats/Impl/ArrowColumnToCHColumn.h>
 #include <Processors/Formats/Impl/ParquetBlockInputFormat.h>
+#include <Storages/Parquet/ParquetMetadataCache.h>
 #include <Storages/Parquet/VectorizedParquetRecordReader.h>
 #include <parquet/arrow/reader.h>
 #include <parquet/metadata.h>
@@ -67,17 +68,22 @@ FormatFile::InputFormatPtr ParquetFormatFile::createInputFormat(const DB::Block
     auto res = std::make_shared<FormatFile::InputFormat>();
     res->read_buffer = read_buffer_builder->build(file_info);
 
-    std::vector<RowGroupInformation> required_row_groups;
-    int total_row_groups = 0;
-    if (auto * seekable_in = dynamic_cast<DB::SeekableReadBuffer *>(res->read_buffer.get()))
+    auto file_meta = lookupFileMetaData();
+    if (!file_meta)
     {
-        // reuse the read_buffer to avoid opening the file twice.
-        // especially，the cost of opening a hdfs file is large.
-        required_row_groups = collectRequiredRowGroups(seekable_in, total_row_groups);
-        seekable_in->seek(0, SEEK_SET);
+        if (auto * seekable_in = dynamic_cast<DB::SeekableReadBuffer *>(res->read_buffer.get()))
+        {
+            // reuse the read_buffer to avoid opening the file twice.
+            // especially，the cost of opening a hdfs file is large.
+            file_meta = readFileMetaData(seekable_in);
+            seekable_in->seek(0, SEEK_SET);
+        }
+        else
+            file_meta = getFileMetaData();
     }
-    else
-        required_row_groups = collectRequiredRowGroups(total_row_groups);
+
+    const int total_row_groups = file_meta->num_row_groups();
+    std::vector<RowGroupInformation> required_row_groups = collectRequiredRowGroups(*file_meta);
 
     auto format_settings = DB::getFormatSettings(context);
 
@@ -96,7 +102,11 @@ FormatFile::InputFormatPtr ParquetFormatFile::createInputFormat(const DB::Block
     const DB::Settings & settings = context->getSettingsRef();
 
     if (use_pageindex_reader && pageindex_reader_support(header))
-        res->input = std::make_shared<VectorizedParquetBlockInputFormat>(*(res->read_buffer), header, format_settings);
+    {
+        auto input = std::make_shared<VectorizedParquetBlockInputFormat>(*(res->read_buffer), header, format_settings);
+        input->setFileMetaData(file_meta);
+        res->input = input;
+    }
     else
         res->input = std::make_shared<DB::ParquetBlockInputFormat>(
             *(res->read_buffer),
@@ -116,8 +126,7 @@ std::optional<size_t> ParquetFormatFile::getTotalRows()
             return total_rows;
     }
 
-    int _;
-    auto rowgroups = collectRequiredRowGroups(_);
+    auto rowgroups = collectRequiredRowGroups(*getFileMetaData());
     size_t rows = 0;
     for (const auto & rowgroup : rowgroups)
         rows += rowgroup.num_rows;
@@ -142,13 +151,23 @@ bool ParquetFormatFile::pageindex_reader_support(const DB::Block & header)
     return result == header.end();
 }
 
-std::vector<RowGroupInformation> ParquetFormatFile::collectRequiredRowGroups(int & total_row_groups) const
+String ParquetFormatFile::metadataCacheKey() const
 {
-    auto in = read_buffer_builder->build(file_info);
-    return collectRequiredRowGroups(in.get(), total_row_groups);
+    if (!file_info.has_properties() || file_info.properties().filesize() <= 0 || file_info.properties().modificationtime() <= 0)
+        return {};
+    return fmt::format("{}@{}@{}", file_info.uri_file(), file_info.properties().filesize(), file_info.properties().modificationtime());
+}
+
+std::shared_ptr<parquet::FileMetaData> ParquetFormatFile::lookupFileMetaData() const
+{
+    auto & cache = ParquetMetadataCache::instance();
+    if (!cache.enabled())
+        return nullptr;
+    const auto key = metadataCacheKey();
+    return key.empty() ? nullptr : cache.get(key);
 }
 
-std::vector<RowGroupInformation> ParquetFormatFile::collectRequiredRowGroups(DB::ReadBuffer * read_buffer, int & total_row_groups) const
+std::shared_ptr<parquet::FileMetaData> ParquetFormatFile::readFileMetaData(DB::ReadBuffer * read_buffer) const
 {
     const DB::FormatSettings format_settings{
         .seekable_read = true,
@@ -160,9 +179,25 @@ std::vector<RowGroupInformation> ParquetFormatFile::collectRequiredRowGroups(DB:
     if (!status.ok())
         throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Open file({}) failed. {}", file_info.uri_file(), status.ToString());
 
-    const auto file_meta = reader->parquet_reader()->metadata();
-    total_row_groups = file_meta->num_row_groups();
+    auto file_meta = reader->parquet_reader()->metadata();
+    auto & cache = ParquetMetadataCache::instance();
+    if (cache.enabled())
+        if (const auto key = metadataCacheKey(); !key.empty())
+            cache.set(key, file_meta);
+    return file_meta;
+}
+
+std::shared_ptr<parquet::FileMetaData> ParquetFormatFile::getFileMetaData() const
+{
+    if (auto file_meta = lookupFileMetaData())
+        return file_meta;
+    auto in = read_buffer_builder->build(file_info);
+    return readFileMetaData(in.get());
+}
 
+std::vector<RowGroupInformation> ParquetFormatFile::collectRequiredRowGroups(const parquet::FileMetaData & file_meta) const
+{
+    const int total_row_groups = file_meta.num_row_groups();
     std::vector<RowGroupInformation> row_group_metadatas;
     row_group_metadatas.reserve(total_row_groups);
 
@@ -176,7 +211,7 @@ std::vector<RowGroupInformation> ParquetFormatFile::collectRequiredRowGroups(DB:
 
     for (int i = 0; i < total_row_groups; ++i)
     {
-        const auto row_group_meta = file_meta->RowGroup(i);
+        const auto row_group_meta = file_meta.RowGroup(i);
         Int64 start_offset = 0;
         Int64 total_bytes = 0;
         start_offset = get_column_start_offset(*row_group_meta->ColumnChunk(0));
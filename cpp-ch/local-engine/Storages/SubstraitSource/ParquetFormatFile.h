@@ -62,8 +62,13 @@ private:
     std::mutex mutex;
     std::optional<size_t> total_rows;
 
-    std::vector<RowGroupInformation> collectRequiredRowGroups(int & total_row_groups) const;
-    std::vector<RowGroupInformation> collectRequiredRowGroups(DB::ReadBuffer * read_buffer, int & total_row_groups) const;
+    /// Empty if the file can't be identified by its size and modification time, then the footer is not cached.
+    String metadataCacheKey() const;
+    std::shared_ptr<parquet::FileMetaData> lookupFileMetaData() const;
+    std::shared_ptr<parquet::FileMetaData> readFileMetaData(DB::ReadBuffer * read_buffer) const;
+    std::shared_ptr<parquet::FileMetaData> getFileMetaData() const;
+
+    std::vector<RowGroupInformation> collectRequiredRowGroups(const parquet::FileMetaData & file_meta) const;
 };
 
 }
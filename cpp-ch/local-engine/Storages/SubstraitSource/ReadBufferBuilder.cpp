@@ -753,8 +753,22 @@ ReadBufferBuilder::wrapWithBzip2(std::unique_ptr<DB::ReadBuffer> in, const subst
     bounded_in->setReadUntilPosition(new_end);
     bool first_block_need_special_process = (new_start > 0);
     bool last_block_need_special_process = (new_end < file_size);
+
+    /// Bzip2 blocks are independent once their delimiters are found, so they may be decoded concurrently.
+    const size_t max_parallel_blocks = ExecutorConfig::loadFromContext(context).bzip2_max_decompression_threads;
+    ThreadPoolCallbackRunnerUnsafe<void> schedule;
+    if (max_parallel_blocks > 1)
+        schedule = DB::threadPoolCallbackRunnerUnsafe<void>(SplittableBzip2ReadBuffer::getDecodeThreadPool(), "Bzip2Decoder");
+
     auto decompressed_in = std::make_unique<SplittableBzip2ReadBuffer>(
-        std::move(bounded_in), first_block_need_special_process, last_block_need_special_process);
+        std::move(bounded_in),
+        first_block_need_special_process,
+        last_block_need_special_process,
+        DBMS_DEFAULT_BUFFER_SIZE,
+        nullptr,
+        0,
+        std::move(schedule),
+        max_parallel_blocks);
     return std::move(decompressed_in);
 }
 
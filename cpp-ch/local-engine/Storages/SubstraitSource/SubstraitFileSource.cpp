@@ -29,11 +29,13 @@
 #include <DataTypes/DataTypeNullable.h>
 #include <IO/ReadBufferFromString.h>
 #include <IO/ReadHelpers.h>
+#include <IO/SharedThreadPools.h>
 #include <QueryPipeline/Pipe.h>
 #include <Storages/SubstraitSource/FormatFile.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
 #include <Common/CHUtil.h>
 #include <Common/Exception.h>
+#include <Common/GlutenConfig.h>
 #include <Common/GlutenStringUtils.h>
 #include <Common/typeid_cast.h>
 #include "DataTypes/DataTypesDecimal.h"
@@ -67,6 +69,39 @@ static DB::Block getRealHeader(const DB::Block & header)
     return result_header;
 }
 
+static std::unique_ptr<FileReaderWrapper> createFileReader(
+    const FormatFilePtr & file,
+    const DB::ContextPtr & context,
+    const DB::Block & to_read_header,
+    const DB::Block & output_header,
+    const std::shared_ptr<const DB::KeyCondition> & key_condition,
+    const ColumnIndexFilterPtr & column_index_filter)
+{
+    if (!file->supportSplit() && file->getStartOffset())
+    {
+        /// For the files do not support split strategy, the task with not 0 offset will generate empty data
+        return std::make_unique<EmptyFileReader>(file);
+    }
+
+    std::unique_ptr<FileReaderWrapper> reader;
+    if (!to_read_header)
+    {
+        auto total_rows = file->getTotalRows();
+        if (total_rows.has_value())
+            reader = std::make_unique<ConstColumnsFileReader>(file, context, output_header, *total_rows);
+        else
+        {
+            /// For text/json format file, we can't get total rows from file metadata.
+            /// So we add a dummy column to indicate the number of rows.
+            reader = std::make_unique<NormalFileReader>(file, context, getRealHeader(to_read_header), getRealHeader(output_header));
+        }
+    }
+    else
+        reader = std::make_unique<NormalFileReader>(file, context, to_read_header, output_header);
+    reader->applyKeyCondition(key_condition, column_index_filter);
+    return reader;
+}
+
 SubstraitFileSource::SubstraitFileSource(
     const DB::ContextPtr & context_,
     const DB::Block & header_,
@@ -90,9 +125,22 @@ SubstraitFileSource::SubstraitFileSource(
         for (const auto & key : partition_keys)
             if (const auto * col = to_read_header.findByName(key, true))
                 to_read_header.erase(col->name);
+
+        open_ahead_files = ExecutorConfig::loadFromContext(context).file_source_open_ahead_files;
+        if (open_ahead_files && files.size() > 1)
+            open_ahead_runner
+                = DB::threadPoolCallbackRunnerUnsafe<std::unique_ptr<FileReaderWrapper>>(DB::getIOThreadPool().get(), "FileOpenAhead");
+        else
+            open_ahead_files = 0;
     }
 }
 
+SubstraitFileSource::~SubstraitFileSource()
+{
+    /// Readers still being opened are dropped by their tasks, dropping the futures does not wait for them.
+    open_ahead_cancelled->store(true, std::memory_order_release);
+}
+
 void SubstraitFileSource::setKeyCondition(const std::optional<DB::ActionsDAG> & filter_actions_dag, DB::ContextPtr context_)
 {
     setKeyConditionImpl(filter_actions_dag, context_, to_read_header);
@@ -137,38 +185,58 @@ bool SubstraitFileSource::tryPrepareReader()
     auto current_file = files[current_file_index];
     current_file_index += 1;
 
-    if (!current_file->supportSplit() && current_file->getStartOffset())
+    if (!open_ahead_readers.empty())
     {
-        /// For the files do not support split strategy, the task with not 0 offset will generate empty data
-        file_reader = std::make_unique<EmptyFileReader>(current_file);
-        return true;
-    }
-
-    if (!to_read_header)
-    {
-        auto total_rows = current_file->getTotalRows();
-        if (total_rows.has_value())
-            file_reader = std::make_unique<ConstColumnsFileReader>(current_file, context, output_header, *total_rows);
-        else
-        {
-            /// For text/json format file, we can't get total rows from file metadata.
-            /// So we add a dummy column to indicate the number of rows.
-            file_reader
-                = std::make_unique<NormalFileReader>(current_file, context, getRealHeader(to_read_header), getRealHeader(output_header));
-        }
+        auto future = std::move(open_ahead_readers.front());
+        open_ahead_readers.pop_front();
+        file_reader = future.get();
+        /// Null only if the source was cancelled before the file was opened.
+        if (!file_reader)
+            return false;
     }
     else
-        file_reader = std::make_unique<NormalFileReader>(current_file, context, to_read_header, output_header);
+        file_reader = createFileReader(current_file, context, to_read_header, output_header, key_condition, column_index_filter);
+
+    scheduleOpenAhead();
+
     input_file_name_parser.setFileName(current_file->getURIPath());
     input_file_name_parser.setBlockStart(current_file->getStartOffset());
     input_file_name_parser.setBlockLength(current_file->getLength());
-    file_reader->applyKeyCondition(key_condition, column_index_filter);
     return true;
 }
 
+void SubstraitFileSource::scheduleOpenAhead()
+{
+    if (!open_ahead_files)
+        return;
+
+    size_t next_file_index = current_file_index + open_ahead_readers.size();
+    while (open_ahead_readers.size() < open_ahead_files && next_file_index < files.size())
+    {
+        /// The task only holds copies, so it may outlive the source and the source never waits for it. Only the open
+        /// runs in the background, decoding stays on the pipeline thread.
+        auto task = [file = files[next_file_index++],
+                     task_context = context,
+                     read_header = to_read_header,
+                     result_header = output_header,
+                     condition = key_condition,
+                     index_filter = column_index_filter,
+                     cancelled = open_ahead_cancelled]() -> std::unique_ptr<FileReaderWrapper>
+        {
+            if (cancelled->load(std::memory_order_acquire))
+                return nullptr;
+            auto reader = createFileReader(file, task_context, read_header, result_header, condition, index_filter);
+            if (cancelled->load(std::memory_order_acquire))
+                return nullptr;
+            return reader;
+        };
+        open_ahead_readers.emplace_back(open_ahead_runner(std::move(task), {}));
+    }
+}
 
 void SubstraitFileSource::onCancel() noexcept
 {
+    open_ahead_cancelled->store(true, std::memory_order_release);
     if (file_reader)
         file_reader->cancel();
 }
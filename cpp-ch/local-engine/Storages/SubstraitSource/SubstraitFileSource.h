@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <deque>
+#include <future>
 #include <Columns/IColumn.h>
 #include <Core/Block.h>
 #include <Core/Field.h>
@@ -26,6 +28,7 @@
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
 #include <base/types.h>
 #include <Parser/InputFileNameParser.h>
+#include <Common/threadPoolCallbackRunner.h>
 
 namespace local_engine
 {
@@ -122,7 +125,7 @@ class SubstraitFileSource : public DB::SourceWithKeyCondition
 {
 public:
     SubstraitFileSource(const DB::ContextPtr & context_, const DB::Block & header_, const substrait::ReadRel::LocalFiles & file_infos);
-    ~SubstraitFileSource() override = default;
+    ~SubstraitFileSource() override;
 
     String getName() const override { return "SubstraitFileSource"; }
 
@@ -133,6 +136,7 @@ protected:
 
 private:
     bool tryPrepareReader();
+    void scheduleOpenAhead();
     void onCancel() noexcept override;
 
     DB::ContextPtr context;
@@ -146,5 +150,12 @@ private:
     std::unique_ptr<FileReaderWrapper> file_reader;
     ReadBufferBuilderPtr read_buffer_builder;
     ColumnIndexFilterPtr column_index_filter;
+
+    /// Readers of files[current_file_index, current_file_index + open_ahead_readers.size()), in order.
+    size_t open_ahead_files = 0;
+    std::deque<std::future<std::unique_ptr<FileReaderWrapper>>> open_ahead_readers;
+    DB::ThreadPoolCallbackRunnerUnsafe<std::unique_ptr<FileReaderWrapper>> open_ahead_runner;
+    /// Shared with the open ahead tasks, which drop their reader once the source is cancelled or destroyed.
+    std::shared_ptr<std::atomic<bool>> open_ahead_cancelled = std::make_shared<std::atomic<bool>>(false);
 };
 }
@@ -1308,6 +1308,13 @@ JNIEXPORT jobject Java_org_apache_gluten_execution_CHNativeCacheManager_nativeGe
     LOCAL_ENGINE_JNI_METHOD_END(env, nullptr);
 }
 
+JNIEXPORT jboolean Java_org_apache_gluten_execution_CHNativeCacheManager_nativeCancelCache(JNIEnv * env, jobject, jstring id)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    return local_engine::CacheManager::cancelJob(jstring2string(env, id));
+    LOCAL_ENGINE_JNI_METHOD_END(env, false);
+}
+
 JNIEXPORT jstring Java_org_apache_gluten_execution_CHNativeCacheManager_nativeCacheFiles(JNIEnv * env, jobject, jbyteArray files)
 {
     LOCAL_ENGINE_JNI_METHOD_START
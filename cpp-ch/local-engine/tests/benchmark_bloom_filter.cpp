@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <AggregateFunctions/SplitBlockBloomFilter.h>
+#include <Interpreters/BloomFilter.h>
+#include <benchmark/benchmark.h>
+#include <Common/PODArray.h>
+
+using namespace DB;
+
+/// Build side keys are inserted into a filter sized like Spark's runtime filters (8 bits per key), then a probe side
+/// batch with 1 of 10 keys present is checked against it.
+static constexpr size_t PROBE_ROWS = 65536;
+
+static PaddedPODArray<UInt64> createKeys(size_t rows, UInt64 seed)
+{
+    std::mt19937_64 rng(seed);
+    PaddedPODArray<UInt64> keys(rows);
+    for (auto & key : keys)
+        key = rng();
+    return keys;
+}
+
+static PaddedPODArray<UInt64> createProbeKeys(const PaddedPODArray<UInt64> & build_keys)
+{
+    auto keys = createKeys(PROBE_ROWS, 42);
+    for (size_t i = 0; i < keys.size(); i += 10)
+        keys[i] = build_keys[i % build_keys.size()];
+    return keys;
+}
+
+static void BM_ClassicBloomFilterFind(benchmark::State & state)
+{
+    const size_t build_rows = state.range(0);
+    const auto build_keys = createKeys(build_rows, 7);
+    const auto probe_keys = createProbeKeys(build_keys);
+    // 3 hashes is what optimalNumOfHashFunctions gives for 8 bits per key.
+    BloomFilter filter(BloomFilterParameters(build_rows, 3, 0));
+    for (auto key : build_keys)
+        filter.add(reinterpret_cast<const char *>(&key), sizeof(key));
+
+    PaddedPODArray<UInt8> result(PROBE_ROWS);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < PROBE_ROWS; ++i)
+            result[i] = filter.find(reinterpret_cast<const char *>(&probe_keys[i]), sizeof(UInt64));
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * PROBE_ROWS);
+}
+
+static void BM_SplitBlockBloomFilterFind(benchmark::State & state)
+{
+    const size_t build_rows = state.range(0);
+    const auto build_keys = createKeys(build_rows, 7);
+    const auto probe_keys = createProbeKeys(build_keys);
+    local_engine::SplitBlockBloomFilter filter(build_rows, 0);
+    for (auto key : build_keys)
+        filter.add(key);
+
+    PaddedPODArray<UInt8> result(PROBE_ROWS);
+    for (auto _ : state)
+    {
+        filter.findMany(probe_keys.data(), PROBE_ROWS, result.data());
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * PROBE_ROWS);
+}
+
+static void BM_ClassicBloomFilterAdd(benchmark::State & state)
+{
+    const size_t build_rows = state.range(0);
+    const auto build_keys = createKeys(build_rows, 7);
+    for (auto _ : state)
+    {
+        BloomFilter filter(BloomFilterParameters(build_rows, 3, 0));
+        for (auto key : build_keys)
+            filter.add(reinterpret_cast<const char *>(&key), sizeof(key));
+        benchmark::DoNotOptimize(filter.getFilter().data());
+    }
+    state.SetItemsProcessed(state.iterations() * build_rows);
+}
+
+static void BM_SplitBlockBloomFilterAdd(benchmark::State & state)
+{
+    const size_t build_rows = state.range(0);
+    const auto build_keys = createKeys(build_rows, 7);
+    for (auto _ : state)
+    {
+        local_engine::SplitBlockBloomFilter filter(build_rows, 0);
+        for (auto key : build_keys)
+            filter.add(key);
+        benchmark::DoNotOptimize(filter.getFilter().data());
+    }
+    state.SetItemsProcessed(state.iterations() * build_rows);
+}
+
+static void BM_BloomFilterFalsePositiveRate(benchmark::State & state)
+{
+    const size_t build_rows = state.range(0);
+    const auto build_keys = createKeys(build_rows, 7);
+    const auto probe_keys = createKeys(PROBE_ROWS, 42);
+    BloomFilter classic(BloomFilterParameters(build_rows, 3, 0));
+    local_engine::SplitBlockBloomFilter split_block(build_rows, 0);
+    for (auto key : build_keys)
+    {
+        classic.add(reinterpret_cast<const char *>(&key), sizeof(key));
+        split_block.add(key);
+    }
+
+    size_t classic_hits = 0;
+    size_t split_block_hits = 0;
+    for (auto _ : state)
+    {
+        classic_hits = 0;
+        split_block_hits = 0;
+        for (auto key : probe_keys)
+        {
+            classic_hits += classic.find(reinterpret_cast<const char *>(&key), sizeof(key));
+            split_block_hits += split_block.find(key);
+        }
+    }
+    state.counters["classic_fpp"] = static_cast<double>(classic_hits) / PROBE_ROWS;
+    state.counters["split_block_fpp"] = static_cast<double>(split_block_hits) / PROBE_ROWS;
+}
+
+BENCHMARK(BM_ClassicBloomFilterFind)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_SplitBlockBloomFilterFind)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_ClassicBloomFilterAdd)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_SplitBlockBloomFilterAdd)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_BloomFilterFalsePositiveRate)->Arg(1 << 20)->Iterations(1);
@@ -14,10 +14,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <AggregateFunctions/AggregateFunctionGroupBloomFilter.h>
 #include <Columns/ColumnSet.h>
 #include <DataTypes/DataTypeFactory.h>
 #include <DataTypes/DataTypeSet.h>
 #include <Functions/FunctionFactory.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/WriteBufferFromString.h>
 #include <Interpreters/Set.h>
 #include <gtest/gtest.h>
 #include <Common/DebugUtils.h>
@@ -191,3 +194,50 @@ TEST(TestFunction, NotIn2)
     debug::headColumn(result2);
     ASSERT_EQ(result2->getUInt(3), 1);
 }
+
+TEST(TestFunction, SplitBlockBloomFilter)
+{
+    using namespace DB;
+    local_engine::AggregateFunctionGroupBloomFilterData data;
+    data.init(1024, 0, 0, true);
+    std::vector<UInt64> keys;
+    for (UInt64 i = 0; i < 1024; ++i)
+    {
+        keys.push_back(i * 7919);
+        data.add(keys.back());
+    }
+
+    String serialized;
+    {
+        WriteBufferFromString out(serialized);
+        data.write(out);
+    }
+    local_engine::AggregateFunctionGroupBloomFilterData restored;
+    ReadBufferFromString in(serialized);
+    restored.read(in);
+    ASSERT_TRUE(restored.initted);
+    ASSERT_TRUE(restored.split_block);
+
+    PaddedPODArray<UInt8> found(keys.size());
+    restored.split_block_filter.findMany(keys.data(), keys.size(), found.data());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ASSERT_TRUE(found[i]);
+        ASSERT_TRUE(restored.find(keys[i]));
+    }
+
+    /// States of the classic filter are still read as such.
+    local_engine::AggregateFunctionGroupBloomFilterData classic;
+    classic.init(1024, 3, 0, false);
+    classic.add(UInt64(42));
+    serialized.clear();
+    {
+        WriteBufferFromString out(serialized);
+        classic.write(out);
+    }
+    local_engine::AggregateFunctionGroupBloomFilterData classic_restored;
+    ReadBufferFromString classic_in(serialized);
+    classic_restored.read(classic_in);
+    ASSERT_FALSE(classic_restored.split_block);
+    ASSERT_TRUE(classic_restored.find(UInt64(42)));
+}
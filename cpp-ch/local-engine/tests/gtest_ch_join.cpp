@@ -14,12 +14,30 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <random>
+#include <thread>
+#include <gluten_test_util.h>
+#include <incbin.h>
+#include <testConfig.h>
 #include <Core/Settings.h>
 #include <DataTypes/DataTypeFactory.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesDecimal.h>
+#include <DataTypes/DataTypesNumber.h>
 #include <Functions/FunctionFactory.h>
 #include <Interpreters/HashJoin/HashJoin.h>
 #include <Interpreters/TableJoin.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/WriteBufferFromString.h>
+#include <Interpreters/castColumn.h>
+#include <Join/BroadCastJoinBuilder.h>
+#include <Join/BucketedBroadcastJoin.h>
+#include <Join/JoinKeyFilter.h>
 #include <Join/StorageJoinFromReadBuffer.h>
+#include <Parser/ParserContext.h>
+#include <Parser/RelParsers/JoinRelParser.h>
+#include <Parser/SubstraitParserUtils.h>
 #include <Parsers/ASTIdentifier.h>
 #include <Processors/Executors/PipelineExecutor.h>
 #include <Processors/Executors/PullingPipelineExecutor.h>
@@ -27,15 +45,29 @@
 #include <Processors/QueryPlan/JoinStep.h>
 #include <Processors/QueryPlan/Optimizations/QueryPlanOptimizationSettings.h>
 #include <Processors/QueryPlan/QueryPlan.h>
+#include <Processors/QueryPlan/ReadFromMergeTree.h>
 #include <Processors/QueryPlan/ReadFromPreparedSource.h>
+#include <Processors/Sources/NullSource.h>
 #include <Processors/Sources/SourceFromSingleChunk.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Storages/MergeTree/SparkMergeTreeMeta.h>
+#include <Storages/IO/NativeWriter.h>
+#include <Storages/MergeTree/SparkStorageMergeTree.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
+#include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
+#include <base/scope_guard.h>
 #include <gtest/gtest.h>
+#include <Poco/Util/MapConfiguration.h>
 #include <Common/DebugUtils.h>
+#include <Common/FieldVisitorToString.h>
+#include <Common/GlutenConfig.h>
 #include <Common/QueryContext.h>
 
+namespace DB::Setting
+{
+extern const SettingsBool join_use_nulls;
+}
+
 using namespace DB;
 using namespace local_engine;
 
@@ -150,3 +182,384 @@ TEST(TestJoin, simple)
     executor.pull(res);
     debug::headBlock(res);
 }
+
+namespace
+{
+Block keyBlock(const DataTypePtr & type, const std::vector<Field> & values, const String & name = "k")
+{
+    auto column = type->createColumn();
+    for (const auto & value : values)
+        column->insert(value);
+    return Block{{std::move(column), type, name}};
+}
+
+/// bloomFilterContains(bloom_filter, CAST(keys AS Int64)), the condition the runtime join filter adds on the probe side.
+ColumnPtr bloomFilterContains(const String & bloom_filter, const ColumnWithTypeAndName & keys)
+{
+    const size_t rows = keys.column->size();
+    const auto string_type = std::make_shared<DataTypeString>();
+    const auto int64_type = std::make_shared<DataTypeInt64>();
+    ColumnsWithTypeAndName arguments{
+        {string_type->createColumnConst(rows, bloom_filter), string_type, "bloom_filter"},
+        {castColumn(keys, int64_type), int64_type, "key"}};
+    auto function = FunctionFactory::instance().get("bloomFilterContains", QueryContext::globalContext());
+    auto executable = function->build(arguments);
+    return executable->execute(arguments, executable->getResultType(), rows, false);
+}
+
+bool hasFunction(const ActionsDAG & actions_dag, const String & name)
+{
+    return std::ranges::any_of(
+        actions_dag.getNodes(),
+        [&](const ActionsDAG::Node & node)
+        { return node.type == ActionsDAG::ActionType::FUNCTION && node.function_base && node.function_base->getName() == name; });
+}
+
+/// Adds the runtime join filter of probe key `probe_key` joined with the build side keys [1, 100] on top of `plan`,
+/// optimizes the plan and checks the filter reached `source_step`.
+void checkRuntimeJoinFilterPushedDown(QueryPlan & plan, const SourceStepWithFilter & source_step, const String & probe_key)
+{
+    const auto context = QueryContext::globalContext();
+    std::vector<Field> build_keys;
+    for (Int64 i = 1; i <= 100; ++i)
+        build_keys.emplace_back(i);
+    auto key_filter = JoinKeyFilter::build({keyBlock(std::make_shared<DataTypeInt64>(), build_keys, "build_k")}, "build_k", 1000);
+    ASSERT_TRUE(key_filter.has_value());
+    JoinKeyFilters key_filters{{"build_k", *key_filter}};
+
+    TableJoin table_join(context->getSettingsRef(), context->getGlobalTemporaryVolume(), context->getTempDataOnDisk());
+    table_join.addDisjunct();
+    ASTPtr left_key = std::make_shared<ASTIdentifier>(probe_key);
+    ASTPtr right_key = std::make_shared<ASTIdentifier>("build_k");
+    table_join.addOnKeys(left_key, right_key, false);
+
+    JoinRelParser join_parser(ParserContext::build(context));
+    join_parser.addRuntimeJoinFilter(table_join, plan, key_filters);
+    plan.optimize(QueryPlanOptimizationSettings::fromContext(context));
+
+    const auto & filter_dag = source_step.getFilterActionsDAG();
+    ASSERT_TRUE(filter_dag.has_value()) << source_step.getName() << " got no filter";
+    EXPECT_TRUE(hasFunction(*filter_dag, "greaterOrEquals"));
+    EXPECT_TRUE(hasFunction(*filter_dag, "lessOrEquals"));
+    EXPECT_TRUE(hasFunction(*filter_dag, "bloomFilterContains"));
+}
+}
+
+TEST(JoinKeyFilter, IgnoreNullKeys)
+{
+    const auto type = makeNullable(std::make_shared<DataTypeInt64>());
+    auto filter = JoinKeyFilter::build(
+        {keyBlock(type, {Field(), Int64(5), Int64(-3)}), keyBlock(type, {Field(), Field()}), keyBlock(type, {Int64(2)})}, "k", 1000);
+    ASSERT_TRUE(filter.has_value());
+    EXPECT_TRUE(filter->type->equals(DataTypeInt64()));
+    EXPECT_EQ(filter->min, Field(Int64(-3)));
+    EXPECT_EQ(filter->max, Field(Int64(5)));
+    EXPECT_FALSE(filter->bloom_filter.empty());
+
+    const auto found = bloomFilterContains(filter->bloom_filter, keyBlock(type, {Int64(5), Int64(-3), Int64(2)}).getByPosition(0));
+    for (size_t i = 0; i < found->size(); ++i)
+        EXPECT_EQ(found->getUInt(i), 1) << "row " << i;
+
+    /// Only null keys can't match anything, there is no filter to build.
+    EXPECT_FALSE(JoinKeyFilter::build({keyBlock(type, {Field(), Field()})}, "k", 1000).has_value());
+    EXPECT_FALSE(JoinKeyFilter::build({}, "k", 1000).has_value());
+}
+
+TEST(JoinKeyFilter, StringKeys)
+{
+    const auto type = std::make_shared<DataTypeString>();
+    auto filter = JoinKeyFilter::build({keyBlock(type, {String("banana"), String("apple")}), keyBlock(type, {String("cherry")})}, "k", 1000);
+    ASSERT_TRUE(filter.has_value());
+    EXPECT_EQ(filter->min, Field(String("apple")));
+    EXPECT_EQ(filter->max, Field(String("cherry")));
+    /// Only integer keys get a bloom filter
+    EXPECT_TRUE(filter->bloom_filter.empty());
+}
+
+TEST(JoinKeyFilter, DecimalKeys)
+{
+    const auto type = std::make_shared<DataTypeDecimal64>(10, 2);
+    auto filter = JoinKeyFilter::build(
+        {keyBlock(type, {DecimalField<Decimal64>(1234, 2), DecimalField<Decimal64>(-50, 2)}),
+         keyBlock(type, {DecimalField<Decimal64>(99999, 2)})},
+        "k",
+        1000);
+    ASSERT_TRUE(filter.has_value());
+    EXPECT_TRUE(filter->type->equals(*type));
+    EXPECT_EQ(filter->min, Field(DecimalField<Decimal64>(-50, 2)));
+    EXPECT_EQ(filter->max, Field(DecimalField<Decimal64>(99999, 2)));
+    EXPECT_TRUE(filter->bloom_filter.empty());
+}
+
+TEST(JoinKeyFilter, UInt64KeysWrapThroughInt64)
+{
+    /// The bloom filter is built over the keys cast to Int64, UInt64 keys above the Int64 range wrap around. The probe
+    /// side casts its keys the same way, so they must still be found.
+    const auto type = std::make_shared<DataTypeUInt64>();
+    const std::vector<Field> keys{UInt64(1), UInt64(9223372036854775813ULL), std::numeric_limits<UInt64>::max()};
+    auto filter = JoinKeyFilter::build({keyBlock(type, keys)}, "k", 1000);
+    ASSERT_TRUE(filter.has_value());
+    EXPECT_EQ(filter->min, Field(UInt64(1)));
+    EXPECT_EQ(filter->max, Field(std::numeric_limits<UInt64>::max()));
+    ASSERT_FALSE(filter->bloom_filter.empty());
+
+    const auto found = bloomFilterContains(filter->bloom_filter, keyBlock(type, keys).getByPosition(0));
+    for (size_t i = 0; i < found->size(); ++i)
+        EXPECT_EQ(found->getUInt(i), 1) << "row " << i;
+
+    /// Above bloom_filter_max_rows only the range is kept
+    auto range_only = JoinKeyFilter::build({keyBlock(type, keys)}, "k", 2);
+    ASSERT_TRUE(range_only.has_value());
+    EXPECT_TRUE(range_only->bloom_filter.empty());
+}
+
+TEST(RuntimeJoinFilter, PushDownIntoSubstraitFileSource)
+{
+    const auto context = QueryContext::globalContext();
+    const auto type = makeNullable(std::make_shared<DataTypeInt64>());
+    Block probe = keyBlock(type, {Int64(1), Int64(50), Int64(200), Field()});
+
+    QueryPlan plan;
+    auto source_step = std::make_unique<SubstraitFileSourceStep>(context, Pipe(std::make_shared<SourceFromSingleChunk>(probe)), "test");
+    const auto & source = *source_step;
+    plan.addStep(std::move(source_step));
+    checkRuntimeJoinFilterPushedDown(plan, source, "k");
+}
+
+INCBIN(runtime_filter_mergetree_table, SOURCE_DIR "/utils/extern-local-engine/tests/json/mergetree/1_mergetree.json");
+TEST(RuntimeJoinFilter, PushDownIntoReadFromMergeTree)
+{
+    const auto context = QueryContext::globalContext();
+    const auto extension_table
+        = JsonStringToMessage<substrait::ReadRel::ExtensionTable>(EMBEDDED_PLAN(runtime_filter_mergetree_table));
+    MergeTreeTableInstance merge_tree_table(extension_table);
+    const auto storage = merge_tree_table.getStorage(QueryContext::globalMutableContext());
+    auto storage_snapshot = std::make_shared<StorageSnapshot>(*storage, storage->getInMemoryMetadataPtr());
+    NamesAndTypesList names_and_types_list{{"l_orderkey", makeNullable(std::make_shared<DataTypeInt64>())}};
+    auto query_info = buildQueryInfo(names_and_types_list);
+    auto read_step = storage->reader.readFromParts(
+        {}, storage->getMutationsSnapshot({}), names_and_types_list.getNames(), storage_snapshot, *query_info, context, 8192, 1);
+    const auto * source = dynamic_cast<const ReadFromMergeTree *>(read_step.get());
+    ASSERT_TRUE(source);
+
+    QueryPlan plan;
+    plan.addStep(std::move(read_step));
+    checkRuntimeJoinFilterPushedDown(plan, *source, "l_orderkey");
+}
+
+namespace
+{
+/// Replaces the config of the global context until the end of the scope.
+class ScopedConfig
+{
+public:
+    explicit ScopedConfig(const std::map<String, UInt64> & values)
+        : global_context(QueryContext::globalMutableContext())
+        , old_config(const_cast<Poco::Util::AbstractConfiguration *>(&global_context->getConfigRef()), true)
+    {
+        Poco::AutoPtr<Poco::Util::MapConfiguration> config = new Poco::Util::MapConfiguration();
+        for (const auto & [key, value] : values)
+            config->setUInt64(key, value);
+        global_context->setConfig(config);
+    }
+    ~ScopedConfig() { global_context->setConfig(old_config); }
+
+private:
+    ContextMutablePtr global_context;
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> old_config;
+};
+
+/// Builds a broadcast table of (k, v) with k in [0, rows) and v = 'v<k>', as the build side of a join on k.
+std::shared_ptr<StorageJoinFromReadBuffer>
+buildBroadcastTable(const String & key, substrait::JoinRel_JoinType join_type, size_t rows, bool has_mixed_join_condition = false)
+{
+    const auto int64_type = std::make_shared<DataTypeInt64>();
+    const auto string_type = makeNullable(std::make_shared<DataTypeString>());
+    Block header({{int64_type, "k"}, {string_type, "v"}});
+    String data;
+    {
+        WriteBufferFromString out(data);
+        NativeWriter writer(out, header);
+        for (size_t start = 0; start < rows; start += 1000)
+        {
+            auto k = int64_type->createColumn();
+            auto v = string_type->createColumn();
+            for (size_t i = start; i < std::min(rows, start + 1000); ++i)
+            {
+                k->insert(static_cast<Int64>(i));
+                v->insert("v" + std::to_string(i));
+            }
+            writer.write(Block({{std::move(k), int64_type, "k"}, {std::move(v), string_type, "v"}}));
+        }
+        out.finalize();
+    }
+
+    substrait::NamedStruct named_struct;
+    named_struct.add_names("k");
+    named_struct.add_names("v");
+    named_struct.mutable_struct_()->add_types()->mutable_i64()->set_nullability(substrait::Type::NULLABILITY_REQUIRED);
+    named_struct.mutable_struct_()->add_types()->mutable_string()->set_nullability(substrait::Type::NULLABILITY_NULLABLE);
+    ReadBufferFromString in(data);
+    return BroadCastJoinBuilder::buildJoin(
+        key, in, rows, "k", join_type, has_mixed_join_condition, false, named_struct.SerializeAsString(), false, false);
+}
+
+/// Joins the probe keys pk with the broadcast table on pk = k, like one task does, and returns the sorted (pk, v) rows.
+std::vector<String> joinBroadcastTable(
+    const std::shared_ptr<StorageJoinFromReadBuffer> & storage, JoinKind kind, const std::vector<std::optional<Int64>> & probe_keys)
+{
+    const auto context = QueryContext::globalContext();
+    auto settings = context->getSettingsCopy();
+    settings[Setting::join_use_nulls] = true;
+    auto table_join = std::make_shared<TableJoin>(settings, context->getGlobalTemporaryVolume(), context->getTempDataOnDisk());
+    table_join->setKind(kind);
+    table_join->setStrictness(JoinStrictness::All);
+    const auto & right_header = storage->getRightSampleBlock();
+    table_join->setColumnsFromJoinedTable(right_header.getNamesAndTypesList());
+    for (const auto & column : table_join->columnsFromJoinedTable())
+        table_join->addJoinedColumn(column);
+    table_join->addDisjunct();
+    ASTPtr left_key = std::make_shared<ASTIdentifier>("pk");
+    ASTPtr right_key = std::make_shared<ASTIdentifier>(String(BlockUtil::RIHGT_COLUMN_PREFIX) + "k");
+    table_join->addOnKeys(left_key, right_key, false);
+
+    const auto key_type = makeNullable(std::make_shared<DataTypeInt64>());
+    auto key_column = key_type->createColumn();
+    for (const auto & probe_key : probe_keys)
+        key_column->insert(probe_key ? Field(*probe_key) : Field());
+    Block probe{{std::move(key_column), key_type, "pk"}};
+    auto left_plan = std::make_unique<QueryPlan>();
+    left_plan->addStep(std::make_unique<ReadFromPreparedSource>(Pipe(std::make_shared<SourceFromSingleChunk>(probe))));
+    auto right_plan = std::make_unique<QueryPlan>();
+    right_plan->addStep(std::make_unique<ReadFromPreparedSource>(Pipe(std::make_shared<NullSource>(right_header))));
+
+    QueryPlanPtr query_plan;
+    if (storage->isSpilled())
+    {
+        JoinRelParser join_parser(ParserContext::build(context));
+        query_plan = join_parser.buildSpilledBroadcastJoin(table_join, std::move(left_plan), std::move(right_plan), storage);
+    }
+    else
+    {
+        query_plan = std::move(left_plan);
+        query_plan->addStep(
+            std::make_unique<FilledJoinStep>(query_plan->getCurrentHeader(), storage->getJoinLocked(table_join, context), 8192));
+    }
+
+    auto pipeline = query_plan->buildQueryPipeline(QueryPlanOptimizationSettings(), BuildQueryPipelineSettings());
+    auto executable_pipe = QueryPipelineBuilder::getPipeline(std::move(*pipeline));
+    PullingPipelineExecutor executor(executable_pipe);
+    std::vector<String> rows;
+    Block block;
+    auto to_string = [](const Field & field) { return field.isNull() ? String("NULL") : applyVisitor(FieldVisitorToString(), field); };
+    while (executor.pull(block))
+    {
+        const auto & pk = block.getByName("pk").column;
+        const auto & v = block.getByName(String(BlockUtil::RIHGT_COLUMN_PREFIX) + "v").column;
+        for (size_t row = 0; row < block.rows(); ++row)
+            rows.emplace_back(to_string((*pk)[row]) + "|" + to_string((*v)[row]));
+    }
+    std::ranges::sort(rows);
+    return rows;
+}
+}
+
+TEST(BroadcastJoinSpill, TasksJoinSharedBuckets)
+{
+    constexpr size_t build_rows = 20000;
+    ScopedConfig config(
+        {{JoinConfig::BROADCAST_BUILD_MAX_BYTES_IN_MEMORY, 1}, {JoinConfig::BROADCAST_BUILD_SPILL_BUCKETS, 4}});
+
+    /// Matching and missing keys, and null keys which never match.
+    std::mt19937 rng(42);
+    std::vector<std::optional<Int64>> probe_keys;
+    for (size_t i = 0; i < 30000; ++i)
+        probe_keys.emplace_back(rng() % 20 ? std::optional<Int64>(static_cast<Int64>(rng() % 22000) - 1000) : std::nullopt);
+
+    for (auto [join_type, kind] : {std::pair{substrait::JoinRel_JoinType_JOIN_TYPE_INNER, JoinKind::Inner},
+                                   std::pair{substrait::JoinRel_JoinType_JOIN_TYPE_LEFT, JoinKind::Left}})
+    {
+        SCOPED_TRACE(toString(kind));
+        auto storage = buildBroadcastTable("gtest_spilled_broadcast_table", join_type, build_rows);
+        ASSERT_TRUE(storage->isSpilled());
+        EXPECT_EQ(storage->getSpilledBuckets(), 4U);
+
+        std::vector<String> expected;
+        for (const auto & probe_key : probe_keys)
+        {
+            if (probe_key && *probe_key >= 0 && *probe_key < static_cast<Int64>(build_rows))
+                expected.emplace_back(std::to_string(*probe_key) + "|'v" + std::to_string(*probe_key) + "'");
+            else if (kind == JoinKind::Left)
+                expected.emplace_back((probe_key ? std::to_string(*probe_key) : "NULL") + "|NULL");
+        }
+        std::ranges::sort(expected);
+
+        /// Two tasks of the executor join the same buckets.
+        EXPECT_EQ(joinBroadcastTable(storage, kind, probe_keys), expected);
+        EXPECT_EQ(joinBroadcastTable(storage, kind, probe_keys), expected);
+    }
+}
+
+TEST(BroadcastJoinSpill, UnsupportedJoinsStayInMemory)
+{
+    ScopedConfig config({{JoinConfig::BROADCAST_BUILD_MAX_BYTES_IN_MEMORY, 1}});
+    /// A right join emits the unmatched build rows, every task would emit them if the build side were split by bucket.
+    auto right_join = buildBroadcastTable("gtest_right_broadcast_table", substrait::JoinRel_JoinType_JOIN_TYPE_RIGHT, 5000);
+    EXPECT_FALSE(right_join->isSpilled());
+    auto mixed_condition = buildBroadcastTable("gtest_mixed_broadcast_table", substrait::JoinRel_JoinType_JOIN_TYPE_INNER, 5000, true);
+    EXPECT_FALSE(mixed_condition->isSpilled());
+
+    /// Left semi and anti joins are driven by the probe rows like inner and left joins.
+    auto semi_join = buildBroadcastTable("gtest_semi_broadcast_table", substrait::JoinRel_JoinType_JOIN_TYPE_LEFT_SEMI, 5000);
+    EXPECT_TRUE(semi_join->isSpilled());
+}
+
+TEST(BroadcastJoinSpill, ConcurrentReservationsStayWithinLimit)
+{
+    const size_t baseline = BroadCastJoinBuilder::memoryUsage();
+    const size_t limit = baseline + 1000;
+    std::atomic<size_t> reserved = 0;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 8; ++i)
+        threads.emplace_back(
+            [&]
+            {
+                while (BroadCastJoinBuilder::tryReserveMemory(3, limit))
+                    reserved += 3;
+            });
+    for (auto & thread : threads)
+        thread.join();
+    EXPECT_EQ(reserved.load(), 999);
+    EXPECT_EQ(BroadCastJoinBuilder::memoryUsage(), baseline + 999);
+    EXPECT_TRUE(BroadCastJoinBuilder::tryReserveMemory(1, 0));
+    BroadCastJoinBuilder::releaseMemory(reserved + 1);
+    EXPECT_EQ(BroadCastJoinBuilder::memoryUsage(), baseline);
+}
+
+TEST(BroadcastJoinSpill, ExecutorBudgetTriggersSpill)
+{
+    const size_t baseline = BroadCastJoinBuilder::memoryUsage();
+    auto in_memory = buildBroadcastTable("gtest_in_memory_broadcast_table", substrait::JoinRel_JoinType_JOIN_TYPE_INNER, 20000);
+    EXPECT_FALSE(in_memory->isSpilled());
+    const size_t table_bytes = BroadCastJoinBuilder::memoryUsage() - baseline;
+    ASSERT_GT(table_bytes, 0);
+
+    {
+        /// A second table of the same size doesn't fit into the rest of the budget. The bytes it reserved while being
+        /// deserialized are released when it spills.
+        ScopedConfig config({{JoinConfig::BROADCAST_BUILD_MAX_BYTES_PER_EXECUTOR, baseline + table_bytes + table_bytes / 2}});
+        auto spilled = buildBroadcastTable("gtest_over_budget_broadcast_table", substrait::JoinRel_JoinType_JOIN_TYPE_INNER, 20000);
+        EXPECT_TRUE(spilled->isSpilled());
+        EXPECT_EQ(BroadCastJoinBuilder::memoryUsage(), baseline + table_bytes);
+
+        /// A small one still fits, it's accounted by its hash table until it's released.
+        auto small = buildBroadcastTable("gtest_small_broadcast_table", substrait::JoinRel_JoinType_JOIN_TYPE_INNER, 1000);
+        EXPECT_FALSE(small->isSpilled());
+        EXPECT_GT(BroadCastJoinBuilder::memoryUsage(), baseline + table_bytes);
+        small.reset();
+        EXPECT_EQ(BroadCastJoinBuilder::memoryUsage(), baseline + table_bytes);
+    }
+
+    in_memory.reset();
+    EXPECT_EQ(BroadCastJoinBuilder::memoryUsage(), baseline);
+}
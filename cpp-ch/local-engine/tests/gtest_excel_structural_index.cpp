@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <Columns/ColumnString.h>
+#include <Formats/FormatSettings.h>
+#include <IO/ReadBuffer.h>
+#include <Storages/Serializations/ExcelStringReader.h>
+#include <Storages/Serializations/ExcelStructuralIndex.h>
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// Serves data in chunks copied into the same memory, like a file buffer refilled in place.
+class ChunkedReadBuffer : public ReadBuffer
+{
+public:
+    ChunkedReadBuffer(const String & data_, size_t chunk_size_) : ReadBuffer(nullptr, 0), data(data_), memory(chunk_size_) { }
+
+private:
+    bool nextImpl() override
+    {
+        if (data_pos >= data.size())
+            return false;
+        const size_t size = std::min(memory.size(), data.size() - data_pos);
+        memcpy(memory.data(), data.data() + data_pos, size);
+        data_pos += size;
+        internal_buffer = Buffer(memory.data(), memory.data() + size);
+        working_buffer = internal_buffer;
+        return true;
+    }
+
+    const String & data;
+    std::vector<char> memory;
+    size_t data_pos = 0;
+};
+
+struct CSVCase
+{
+    char delimiter;
+    char quote;
+    String escape;
+};
+
+/// Rows of plain and quoted fields of random lengths, so fields, quotes and escapes land on both sides of 64 byte and
+/// buffer edges. Quoted fields hold the delimiter, line ends, the other quote character, doubled quotes and escapes.
+String generateCSV(const CSVCase & csv_case, size_t size, size_t & fields)
+{
+    const char other_quote = csv_case.quote == '"' ? '\'' : '"';
+    std::mt19937 rng(42);
+    String data;
+    fields = 0;
+    while (data.size() < size)
+    {
+        const size_t length = rng() % 150;
+        if (rng() % 2)
+        {
+            data.push_back(csv_case.quote);
+            for (size_t i = 0; i < length; ++i)
+            {
+                switch (rng() % 8)
+                {
+                    case 0:
+                        data.push_back(csv_case.delimiter);
+                        break;
+                    case 1:
+                        data.push_back(rng() % 2 ? '\n' : '\r');
+                        break;
+                    case 2:
+                        data.push_back(other_quote);
+                        break;
+                    case 3:
+                        /// A quote followed by the delimiter would end the field.
+                        data.push_back(csv_case.quote);
+                        data.push_back(csv_case.quote);
+                        data.push_back('q');
+                        break;
+                    case 4:
+                        if (!csv_case.escape.empty())
+                        {
+                            data += csv_case.escape;
+                            data.push_back(rng() % 2 ? csv_case.quote : 'e');
+                        }
+                        break;
+                    default:
+                        data.push_back(static_cast<char>('a' + rng() % 26));
+                }
+            }
+            data.push_back(csv_case.quote);
+        }
+        else
+        {
+            for (size_t i = 0; i < length; ++i)
+                data.push_back(rng() % 8 ? static_cast<char>('a' + rng() % 26) : ' ');
+        }
+        ++fields;
+        data.push_back(rng() % 10 ? csv_case.delimiter : '\n');
+    }
+    return data;
+}
+
+std::vector<String> readFields(
+    const String & data, size_t chunk_size, const FormatSettings::CSV & settings, const String & escape, ExcelStructuralIndex * index)
+{
+    ChunkedReadBuffer buf(data, chunk_size);
+    std::vector<String> fields;
+    while (!buf.eof())
+    {
+        ColumnString::Chars field;
+        readExcelCSVStringInto(field, buf, settings, escape, index);
+        fields.emplace_back(field.begin(), field.end());
+        /// Skip the delimiter or the line end.
+        if (!buf.eof())
+            ++buf.position();
+    }
+    return fields;
+}
+}
+
+TEST(ExcelStructuralIndex, ReadsSameFieldsAsScan)
+{
+    const std::vector<CSVCase> cases{{',', '"', "\\"}, {',', '"', ""}, {'|', '\'', "\\"}, {'\t', '"', "\\"}, {';', '\'', ""}};
+    for (const auto & csv_case : cases)
+    {
+        FormatSettings::CSV settings;
+        settings.delimiter = csv_case.delimiter;
+        settings.allow_double_quotes = csv_case.quote == '"';
+        settings.allow_single_quotes = csv_case.quote == '\'';
+
+        size_t fields = 0;
+        const String data = generateCSV(csv_case, 1024 * 1024, fields);
+        /// One buffer holding everything, and buffers refilled in place whose fields span two buffers.
+        for (size_t chunk_size :
+             {data.size(), ExcelStructuralIndex::MIN_INDEXED_BUFFER_SIZE, ExcelStructuralIndex::MIN_INDEXED_BUFFER_SIZE + 33})
+        {
+            SCOPED_TRACE(
+                fmt::format("delimiter {} quote {} escape {} chunk {}", csv_case.delimiter, csv_case.quote, csv_case.escape, chunk_size));
+            ExcelStructuralIndex index(csv_case.delimiter, csv_case.escape);
+            const auto scanned = readFields(data, chunk_size, settings, csv_case.escape, nullptr);
+            const auto indexed = readFields(data, chunk_size, settings, csv_case.escape, &index);
+            /// An escape at the end of a buffer loses the quote it escapes, so only a single buffer keeps every field.
+            if (chunk_size == data.size())
+                EXPECT_EQ(scanned.size(), fields);
+            EXPECT_EQ(indexed, scanned);
+        }
+    }
+}
+
+TEST(ExcelStructuralIndex, RebuildsForBufferReusingMemory)
+{
+    const size_t size = ExcelStructuralIndex::MIN_INDEXED_BUFFER_SIZE;
+    String data(size * 2, 'a');
+    data[100] = ',';
+    data[size + 200] = ',';
+    data[size + 300] = '"';
+
+    ChunkedReadBuffer buf(data, size);
+    ExcelStructuralIndex index(',', "");
+    ASSERT_FALSE(buf.eof());
+    auto * first = index.prepare(buf);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->findTerminator(buf.position()) - buf.position(), 100);
+    EXPECT_EQ(first->findQuote(buf.position()), buf.buffer().end());
+
+    /// Same memory, same size, only count() tells the buffers apart.
+    const char * old_begin = buf.buffer().begin();
+    buf.position() = buf.buffer().end();
+    ASSERT_FALSE(buf.eof());
+    ASSERT_EQ(buf.buffer().begin(), old_begin);
+    auto * second = index.prepare(buf);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->findTerminator(buf.position()) - buf.position(), 200);
+    EXPECT_EQ(second->findQuote(buf.position()) - buf.position(), 300);
+
+    String small(size - 1, 'a');
+    ChunkedReadBuffer small_buf(small, small.size());
+    ASSERT_FALSE(small_buf.eof());
+    EXPECT_EQ(index.prepare(small_buf), nullptr);
+}
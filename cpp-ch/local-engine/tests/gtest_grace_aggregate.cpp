@@ -0,0 +1,220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <bit>
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Operator/GraceAggregatingTransform.h>
+#include <Operator/StreamingAggregatingStep.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
+#include <Processors/ISource.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <gtest/gtest.h>
+#include <Poco/Util/MapConfiguration.h>
+#include <Common/AggregateUtil.h>
+#include <Common/CurrentThread.h>
+#include <Common/GlutenConfig.h>
+#include <Common/QueryContext.h>
+#include <base/scope_guard.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// Generates rounds * keys rows of (k, v = 1), every key occurs once per round.
+class KeysSource : public ISource
+{
+public:
+    KeysSource(const Block & header, size_t keys_, size_t rounds_, size_t block_rows_)
+        : ISource(header), keys(keys_), total_rows(keys_ * rounds_), block_rows(block_rows_)
+    {
+    }
+    String getName() const override { return "KeysSource"; }
+
+protected:
+    Chunk generate() override
+    {
+        if (generated_rows >= total_rows)
+            return {};
+        const size_t rows = std::min(block_rows, total_rows - generated_rows);
+        auto key_column = ColumnInt64::create(rows);
+        auto value_column = ColumnInt64::create(rows, 1);
+        for (size_t i = 0; i < rows; ++i)
+            key_column->getData()[i] = static_cast<Int64>((generated_rows + i) % keys);
+        generated_rows += rows;
+        Columns columns{std::move(key_column), std::move(value_column)};
+        return Chunk(std::move(columns), rows);
+    }
+
+private:
+    size_t keys;
+    size_t total_rows;
+    size_t block_rows;
+    size_t generated_rows = 0;
+};
+
+struct GraceAggregateTestOptions
+{
+    bool async_spill = false;
+    bool spill_prefetch = false;
+    bool adaptive_buckets = false;
+    size_t max_buckets = 64;
+    /// Throwing on bucket overflow catches buckets being extended while the memory is only held by pending flushes.
+    bool throw_on_overflow_buckets = true;
+    /// Aggregate partially with StreamingAggregatingTransform first, and merge the partial results.
+    bool two_stage = false;
+    bool partial_aggregation_bypass = false;
+};
+
+/// Aggregates sum(v) group by k under a memory limit which forces the transform to spill and extend its buckets, and
+/// returns the sum of every key.
+std::vector<Int64> graceAggregateUnderMemoryLimit(const GraceAggregateTestOptions & options, size_t keys, size_t & buckets_num)
+{
+    constexpr size_t rounds = 4;
+
+    auto global_context = QueryContext::globalMutableContext();
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> old_config(
+        const_cast<Poco::Util::AbstractConfiguration *>(&global_context->getConfigRef()), true);
+    Poco::AutoPtr<Poco::Util::MapConfiguration> config = new Poco::Util::MapConfiguration();
+    config->setBool(GraceMergingAggregateConfig::ENABLE_ASYNC_SPILL, options.async_spill);
+    config->setBool(GraceMergingAggregateConfig::ENABLE_SPILL_PREFETCH, options.spill_prefetch);
+    /// Small enough that a bucket is read ahead in several prefetched blocks.
+    config->setUInt64(GraceMergingAggregateConfig::MAX_SPILL_PREFETCH_BYTES, 1_MiB);
+    config->setBool(GraceMergingAggregateConfig::ENABLE_ADAPTIVE_BUCKETS, options.adaptive_buckets);
+    config->setBool(GraceMergingAggregateConfig::THROW_ON_OVERFLOW_GRACE_AGGREGATE_MERGING_BUCKETS, options.throw_on_overflow_buckets);
+    config->setUInt64(GraceMergingAggregateConfig::MAX_GRACE_AGGREGATE_MERGING_BUCKETS, options.max_buckets);
+    config->setBool(StreamingAggregateConfig::ENABLE_PARTIAL_AGGREGATION_BYPASS, options.partial_aggregation_bypass);
+    config->setUInt64(StreamingAggregateConfig::PARTIAL_AGGREGATION_BYPASS_MIN_ROWS, 8192);
+    config->setDouble(StreamingAggregateConfig::PARTIAL_AGGREGATION_BYPASS_MIN_RATIO, 0.5);
+    global_context->setConfig(config);
+    SCOPE_EXIT({ global_context->setConfig(old_config); });
+
+    auto query_id = QueryContext::instance().initializeQuery("gtest_grace_aggregate");
+    SCOPE_EXIT({ QueryContext::instance().finalizeQuery(query_id); });
+    auto context = QueryContext::instance().currentQueryContext();
+    auto & memory_tracker = CurrentThread::getGroup()->memory_tracker;
+    memory_tracker.setSoftLimit(32_MiB);
+    memory_tracker.setHardLimit(1_GiB);
+
+    const auto int64_type = std::make_shared<DataTypeInt64>();
+    Block header({{int64_type, "k"}, {int64_type, "v"}});
+    AggregateFunctionProperties properties;
+    AggregateDescription sum;
+    sum.function = AggregateFunctionFactory::instance().get("sum", NullsAction::EMPTY, {int64_type}, {}, properties);
+    sum.argument_names = {"v"};
+    sum.column_name = "sum_v";
+
+    QueryPipelineBuilder builder;
+    builder.init(Pipe(std::make_shared<KeysSource>(header, keys, rounds, 8192)));
+    std::shared_ptr<GraceAggregatingTransform> grace_transform;
+    if (options.two_stage)
+    {
+        auto partial_params = AggregatorParamsHelper::buildParams(context, {"k"}, {sum}, AggregatorParamsHelper::Mode::INIT_TO_PARTIAL);
+        auto partial_transform_params = std::make_shared<AggregatingTransformParams>(header, partial_params, false);
+        builder.addTransform(std::make_shared<StreamingAggregatingTransform>(context, header, partial_transform_params));
+        const auto partial_header = builder.getHeader();
+        auto merge_params = AggregatorParamsHelper::buildParams(context, {"k"}, {sum}, AggregatorParamsHelper::Mode::PARTIAL_TO_FINISHED);
+        auto merge_transform_params = std::make_shared<AggregatingTransformParams>(partial_header, merge_params, true);
+        grace_transform = std::make_shared<GraceAggregatingTransform>(partial_header, merge_transform_params, context, false, true);
+    }
+    else
+    {
+        auto params = AggregatorParamsHelper::buildParams(context, {"k"}, {sum}, AggregatorParamsHelper::Mode::INIT_TO_COMPLETED);
+        auto transform_params = std::make_shared<AggregatingTransformParams>(header, params, true);
+        grace_transform = std::make_shared<GraceAggregatingTransform>(header, transform_params, context, true, true);
+    }
+    builder.addTransform(grace_transform);
+    auto pipeline = QueryPipelineBuilder::getPipeline(std::move(builder));
+    PullingPipelineExecutor executor(pipeline);
+
+    std::vector<Int64> sums(keys, 0);
+    size_t rows = 0;
+    Block block;
+    while (executor.pull(block))
+    {
+        const auto & key_data = assert_cast<const ColumnInt64 &>(*block.getByName("k").column).getData();
+        const auto & sum_data = assert_cast<const ColumnInt64 &>(*block.getByName("sum_v").column).getData();
+        for (size_t i = 0; i < block.rows(); ++i)
+            sums[key_data[i]] += sum_data[i];
+        rows += block.rows();
+    }
+    EXPECT_EQ(rows, keys);
+    buckets_num = grace_transform->getBucketsNum();
+    return sums;
+}
+
+void checkGraceAggregateUnderMemoryLimit(const GraceAggregateTestOptions & options)
+{
+    constexpr size_t keys = 1000000;
+    size_t buckets_num = 0;
+    auto sums = graceAggregateUnderMemoryLimit(options, keys, buckets_num);
+    EXPECT_GT(buckets_num, 1);
+    for (size_t k = 0; k < keys; ++k)
+        ASSERT_EQ(sums[k], 4) << "key " << k;
+}
+}
+
+TEST(GraceAggregate, SpillUnderMemoryLimit)
+{
+    checkGraceAggregateUnderMemoryLimit({});
+}
+
+TEST(GraceAggregate, AsyncSpillUnderMemoryLimit)
+{
+    checkGraceAggregateUnderMemoryLimit({.async_spill = true});
+}
+
+TEST(GraceAggregate, SpillPrefetchUnderMemoryLimit)
+{
+    /// The next bucket is read ahead while the current one is merged, every spilled bucket must be merged exactly once.
+    checkGraceAggregateUnderMemoryLimit({.spill_prefetch = true});
+    checkGraceAggregateUnderMemoryLimit({.async_spill = true, .spill_prefetch = true});
+}
+
+TEST(GraceAggregate, AdaptiveBucketsStayPowerOfTwoWithinLimit)
+{
+    /// The estimated buckets number exceeds the limit, the buckets are extended to the largest power of two within it.
+    constexpr size_t keys = 1000000;
+    for (size_t max_buckets : {16, 24, 64})
+    {
+        size_t buckets_num = 0;
+        auto sums = graceAggregateUnderMemoryLimit(
+            {.adaptive_buckets = true, .max_buckets = max_buckets, .throw_on_overflow_buckets = false}, keys, buckets_num);
+        EXPECT_GT(buckets_num, 1) << "max buckets " << max_buckets;
+        EXPECT_LE(buckets_num, max_buckets);
+        EXPECT_TRUE(std::has_single_bit(buckets_num)) << buckets_num;
+        for (size_t k = 0; k < keys; ++k)
+            ASSERT_EQ(sums[k], 4) << "key " << k;
+    }
+}
+
+TEST(GraceAggregate, PartialAggregationBypassMatchesAggregation)
+{
+    /// Every key is distinct in the first rounds, so the partial aggregation is bypassed once it saw 8192 rows, and its
+    /// rows are converted into intermediate states one by one.
+    constexpr size_t keys = 200000;
+    size_t buckets_num = 0;
+    auto aggregated = graceAggregateUnderMemoryLimit({.two_stage = true}, keys, buckets_num);
+    auto bypassed = graceAggregateUnderMemoryLimit({.two_stage = true, .partial_aggregation_bypass = true}, keys, buckets_num);
+    ASSERT_EQ(aggregated.size(), bypassed.size());
+    for (size_t k = 0; k < keys; ++k)
+    {
+        ASSERT_EQ(aggregated[k], 4) << "key " << k;
+        ASSERT_EQ(bypassed[k], aggregated[k]) << "key " << k;
+    }
+}
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <Interpreters/Context.h>
+#include <Storages/Cache/JobScheduler.h>
+#include <base/scope_guard.h>
+#include <gtest/gtest.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Util/MapConfiguration.h>
+#include <Common/GlutenConfig.h>
+#include <Common/QueryContext.h>
+
+using namespace local_engine;
+
+namespace
+{
+/// Runs the test body with a scheduler of a single thread, so that the order of the tasks is deterministic.
+void withSingleThreadScheduler(const std::function<void()> & body)
+{
+    auto global_context = QueryContext::globalMutableContext();
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> old_config(
+        const_cast<Poco::Util::AbstractConfiguration *>(&global_context->getConfigRef()), true);
+    Poco::AutoPtr<Poco::Util::MapConfiguration> config = new Poco::Util::MapConfiguration();
+    config->setUInt64(GlutenJobSchedulerConfig::JOB_SCHEDULER_MAX_THREADS, 1);
+    global_context->setConfig(config);
+    JobScheduler::initialize(global_context);
+    SCOPE_EXIT({
+        global_context->setConfig(old_config);
+        JobScheduler::initialize(global_context);
+    });
+    body();
+}
+
+JobSatus waitJob(const JobId & job_id)
+{
+    auto & scheduler = JobScheduler::instance();
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        auto status = scheduler.getJobSatus(job_id);
+        if (status && status->status != JobSatus::RUNNING)
+            return *status;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    throw std::runtime_error("job " + job_id + " did not finish");
+}
+
+/// A job of one task which holds the only thread until it is released or cancelled.
+struct BlockingJob
+{
+    std::atomic_bool started = false;
+    std::atomic_bool released = false;
+
+    Job create(const JobId & job_id)
+    {
+        Job job(job_id);
+        job.addTask(
+            [this](const TaskContext & task_context)
+            {
+                started = true;
+                while (!released)
+                {
+                    task_context.checkCancelled();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        return job;
+    }
+
+    void waitStarted() const
+    {
+        while (!started)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+};
+}
+
+TEST(JobScheduler, StartsTasksByPriority)
+{
+    withSingleThreadScheduler(
+        []
+        {
+            auto & scheduler = JobScheduler::instance();
+            BlockingJob blocking;
+            scheduler.scheduleJob(blocking.create("priority_blocking"));
+            blocking.waitStarted();
+
+            std::mutex mutex;
+            std::vector<String> order;
+            auto make_job = [&](const JobId & job_id, Int64 priority)
+            {
+                Job job(job_id, JobOptions{.priority = {priority}});
+                for (size_t i = 0; i < 2; ++i)
+                    job.addTask(
+                        [&, job_id](const TaskContext &)
+                        {
+                            std::lock_guard lock(mutex);
+                            order.push_back(job_id);
+                        });
+                return job;
+            };
+            /// Scheduled first but with a worse priority.
+            scheduler.scheduleJob(make_job("priority_low", 2));
+            scheduler.scheduleJob(make_job("priority_high", 1));
+            blocking.released = true;
+
+            EXPECT_EQ(waitJob("priority_blocking").status, JobSatus::FINISHED);
+            EXPECT_EQ(waitJob("priority_low").status, JobSatus::FINISHED);
+            EXPECT_EQ(waitJob("priority_high").status, JobSatus::FINISHED);
+            EXPECT_EQ(order, (std::vector<String>{"priority_high", "priority_high", "priority_low", "priority_low"}));
+
+            for (const auto & job_id : {"priority_blocking", "priority_low", "priority_high"})
+                scheduler.cleanupJob(job_id);
+        });
+}
+
+TEST(JobScheduler, CancelQueuedAndRunningJobs)
+{
+    withSingleThreadScheduler(
+        []
+        {
+            auto & scheduler = JobScheduler::instance();
+            EXPECT_FALSE(scheduler.cancelJob("cancel_unknown"));
+
+            BlockingJob running;
+            scheduler.scheduleJob(running.create("cancel_running"));
+            running.waitStarted();
+
+            std::atomic_size_t queued_runs = 0;
+            Job queued("cancel_queued");
+            for (size_t i = 0; i < 3; ++i)
+                queued.addTask([&](const TaskContext &) { ++queued_runs; });
+            scheduler.scheduleJob(std::move(queued));
+
+            /// None of its tasks started, so the queued job is cancelled at once.
+            EXPECT_TRUE(scheduler.cancelJob("cancel_queued"));
+            auto queued_status = scheduler.getJobSatus("cancel_queued");
+            ASSERT_TRUE(queued_status.has_value());
+            EXPECT_EQ(queued_status->status, JobSatus::CANCELLED);
+            EXPECT_EQ(queued_status->finished_tasks, 0U);
+
+            /// The running task stops once it polls the cancel flag.
+            EXPECT_TRUE(scheduler.cancelJob("cancel_running"));
+            EXPECT_EQ(waitJob("cancel_running").status, JobSatus::CANCELLED);
+            EXPECT_FALSE(running.released);
+
+            /// The thread is free again and the cancelled tasks never ran.
+            std::atomic_bool after_run = false;
+            Job after("cancel_after");
+            after.addTask([&](const TaskContext &) { after_run = true; });
+            scheduler.scheduleJob(std::move(after));
+            EXPECT_EQ(waitJob("cancel_after").status, JobSatus::FINISHED);
+            EXPECT_TRUE(after_run);
+            EXPECT_EQ(queued_runs.load(), 0U);
+
+            for (const auto & job_id : {"cancel_running", "cancel_queued", "cancel_after"})
+                scheduler.cleanupJob(job_id);
+        });
+}
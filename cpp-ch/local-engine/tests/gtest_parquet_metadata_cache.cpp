@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "config.h"
+
+#if USE_PARQUET
+#include <filesystem>
+#include <gluten_test_util.h>
+#include <Storages/Parquet/ParquetMetadataCache.h>
+#include <Storages/SubstraitSource/ParquetFormatFile.h>
+#include <Storages/SubstraitSource/ReadBufferBuilder.h>
+#include <base/scope_guard.h>
+#include <gtest/gtest.h>
+#include <parquet/file_reader.h>
+#include <substrait/plan.pb.h>
+#include <Common/GlutenConfig.h>
+#include <Common/QueryContext.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// Counts the rows of the file through its footer. The footer is looked up in the cache by the given size and
+/// modification time, and read from the file on a miss.
+std::optional<size_t> totalRows(const String & path, size_t file_size, Int64 modification_time)
+{
+    const auto context = QueryContext::globalContext();
+    substrait::ReadRel::LocalFiles::FileOrFiles file_info;
+    file_info.set_uri_file("file://" + path);
+    file_info.set_start(0);
+    file_info.set_length(file_size);
+    file_info.mutable_properties()->set_filesize(file_size);
+    file_info.mutable_properties()->set_modificationtime(modification_time);
+    file_info.mutable_parquet();
+    auto file = std::make_shared<ParquetFormatFile>(
+        context, file_info, ReadBufferBuilderFactory::instance().createBuilder("file", context), true);
+    return file->getTotalRows();
+}
+}
+
+TEST(ParquetMetadataCache, HitMissAndEviction)
+{
+    auto & cache = ParquetMetadataCache::instance();
+    SCOPE_EXIT({
+        cache.initialize(ParquetConfig::loadFromContext(QueryContext::globalContext()).metadata_cache_max_bytes);
+    });
+
+    /// A copy of the file is removed later, then only the cached footers can be found.
+    const String path = std::filesystem::temp_directory_path() / "gtest_parquet_metadata_cache.parquet";
+    std::filesystem::copy_file(test::data_file("sample.parquet"), path, std::filesystem::copy_options::overwrite_existing);
+    SCOPE_EXIT({ std::filesystem::remove(path); });
+    const size_t file_size = std::filesystem::file_size(path);
+    const size_t footer_bytes = parquet::ParquetFileReader::OpenFile(path)->metadata()->size();
+
+    /// Room for two footers.
+    cache.initialize(footer_bytes * 2);
+    const auto rows = totalRows(path, file_size, 1);
+    ASSERT_TRUE(rows.has_value());
+    EXPECT_GT(*rows, 0);
+    EXPECT_EQ(totalRows(path, file_size, 2), rows);
+    /// Touch the first footer, the second one is the least recently used and evicted by the third one.
+    EXPECT_EQ(totalRows(path, file_size, 1), rows);
+    EXPECT_EQ(totalRows(path, file_size, 3), rows);
+
+    std::filesystem::remove(path);
+    /// Hits don't read the file.
+    EXPECT_EQ(totalRows(path, file_size, 1), rows);
+    EXPECT_EQ(totalRows(path, file_size, 3), rows);
+    /// Evicted at metadata_cache_max_bytes.
+    EXPECT_ANY_THROW(totalRows(path, file_size, 2));
+    /// The modification time changed, the file is read again.
+    EXPECT_ANY_THROW(totalRows(path, file_size, 4));
+
+    /// The footers are dropped when the cache is disabled.
+    cache.initialize(0);
+    EXPECT_ANY_THROW(totalRows(path, file_size, 1));
+}
+
+TEST(ParquetMetadataCache, FooterLargerThanCacheIsNotCached)
+{
+    auto & cache = ParquetMetadataCache::instance();
+    SCOPE_EXIT({
+        cache.initialize(ParquetConfig::loadFromContext(QueryContext::globalContext()).metadata_cache_max_bytes);
+    });
+
+    const String path = std::filesystem::temp_directory_path() / "gtest_parquet_metadata_cache_small.parquet";
+    std::filesystem::copy_file(test::data_file("sample.parquet"), path, std::filesystem::copy_options::overwrite_existing);
+    SCOPE_EXIT({ std::filesystem::remove(path); });
+    const size_t file_size = std::filesystem::file_size(path);
+    const size_t footer_bytes = parquet::ParquetFileReader::OpenFile(path)->metadata()->size();
+
+    cache.initialize(footer_bytes - 1);
+    ASSERT_TRUE(totalRows(path, file_size, 1).has_value());
+    std::filesystem::remove(path);
+    EXPECT_ANY_THROW(totalRows(path, file_size, 1));
+}
+#endif
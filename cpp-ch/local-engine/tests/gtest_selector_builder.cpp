@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Shuffle/SelectorBuilder.h>
+#include <gtest/gtest.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// The partition ids computed on IColumn::get64(), as HashSelectorBuilder did for all the hash columns.
+UInt64 partitionIdByGet64(const IColumn & hashes, const NullMap * null_map, size_t row, UInt32 parts_num, bool spark_pmod)
+{
+    if (spark_pmod)
+    {
+        const auto n = static_cast<Int32>(parts_num);
+        auto res = static_cast<Int32>(hashes.get64(row)) % n;
+        if (res < 0)
+            res += n;
+        return static_cast<UInt64>(res);
+    }
+    const bool is_null = null_map && (*null_map)[row];
+    return (is_null ? 0 : static_cast<UInt64>(hashes.get64(row))) % parts_num;
+}
+
+template <typename T>
+void checkHashToPartitionIds()
+{
+    std::mt19937_64 rng(42);
+    auto column = ColumnVector<T>::create();
+    auto & data = column->getData();
+    for (T value : {std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), T(0), T(1), static_cast<T>(-1)})
+        data.push_back(value);
+    for (size_t i = 0; i < 1000; ++i)
+        data.push_back(static_cast<T>(rng()));
+    NullMap nulls(data.size());
+    for (size_t i = 0; i < nulls.size(); ++i)
+        nulls[i] = i % 5 == 0;
+
+    for (UInt32 parts_num : {1u, 7u, 8u, 200u, 256u})
+    {
+        for (bool spark_pmod : {false, true})
+        {
+            for (const NullMap * null_map : {static_cast<const NullMap *>(nullptr), &nulls})
+            {
+                /// sparkMurmurHash3_32 never returns null.
+                if (spark_pmod && null_map)
+                    continue;
+                IColumn::Selector partition_ids;
+                hashToPartitionIds<T>(data, null_map, parts_num, spark_pmod, partition_ids);
+                ASSERT_EQ(partition_ids.size(), data.size());
+                for (size_t i = 0; i < data.size(); ++i)
+                    ASSERT_EQ(partition_ids[i], partitionIdByGet64(*column, null_map, i, parts_num, spark_pmod))
+                        << column->getName() << ", parts " << parts_num << ", pmod " << spark_pmod
+                        << ", nulls " << (null_map != nullptr) << ", hash " << static_cast<Int64>(data[i]);
+            }
+        }
+    }
+}
+
+/// Options of RangeSelectorBuilder with one nullable sorting key, the bounds are sorted by the direction.
+String rangeOptions(const String & spark_type_name, int direction, const std::vector<Int64> & bounds)
+{
+    String options = R"({"ordering":[{"column_ref":0,"column_name":"k","direction":)" + std::to_string(direction)
+        + R"(,"data_type":")" + spark_type_name + R"(","is_nullable":true}],"range_bounds":[)";
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+        if (i)
+            options += ",";
+        options += R"([{"is_null":false,"value":)" + std::to_string(bounds[i]) + "}]";
+    }
+    return options + "]}";
+}
+
+/// Spark's range bounds are distinct, a key equal to a bound goes to the partition of the bound.
+template <typename T>
+std::vector<Int64> randomBounds(size_t bounds_num, std::mt19937_64 & rng)
+{
+    std::uniform_int_distribution<Int64> dist(std::numeric_limits<T>::min() / 2, std::numeric_limits<T>::max() / 2);
+    std::set<Int64> bounds;
+    while (bounds.size() < bounds_num)
+        bounds.insert(dist(rng));
+    return {bounds.begin(), bounds.end()};
+}
+
+template <typename T>
+void checkFlatBounds(const String & spark_type_name)
+{
+    std::mt19937_64 rng(42);
+    /// Up to 64 bounds are counted, more are searched by the branch free binary search.
+    for (size_t bounds_num : {1, 10, 64, 65, 100})
+    {
+        auto bounds = randomBounds<T>(bounds_num, rng);
+        auto keys = ColumnVector<T>::create();
+        for (T value : {std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), T(0), static_cast<T>(-1)})
+            keys->insertValue(value);
+        for (Int64 bound : bounds)
+        {
+            keys->insertValue(static_cast<T>(bound - 1));
+            keys->insertValue(static_cast<T>(bound));
+            keys->insertValue(static_cast<T>(bound + 1));
+        }
+        for (size_t i = 0; i < 1000; ++i)
+            keys->insertValue(static_cast<T>(rng()));
+        auto nulls = ColumnUInt8::create(keys->size());
+        for (size_t i = 0; i < nulls->size(); ++i)
+            nulls->getData()[i] = i % 7 == 0;
+        const auto type = std::make_shared<DataTypeNumber<T>>();
+        const ColumnWithTypeAndName not_null_key(keys->getPtr(), type, "k");
+        const ColumnWithTypeAndName nullable_key(
+            ColumnNullable::create(keys->getPtr(), std::move(nulls)), makeNullable(type), "k");
+
+        /// Ascending and descending, each with nulls first and nulls last.
+        for (int direction : {1, 2, 3, 4})
+        {
+            auto sorted_bounds = bounds;
+            if (direction > 2)
+                std::reverse(sorted_bounds.begin(), sorted_bounds.end());
+            RangeSelectorBuilder builder(rangeOptions(spark_type_name, direction, sorted_bounds), bounds_num + 1);
+            for (const auto & key : {not_null_key, nullable_key})
+            {
+                Block block({key});
+                IColumn::Selector flat_partition_ids;
+                ASSERT_TRUE(builder.computePartitionIdByFlatBounds(block, flat_partition_ids));
+                IColumn::Selector partition_ids;
+                builder.computePartitionIdByBinarySearch(block, partition_ids);
+                ASSERT_EQ(flat_partition_ids.size(), partition_ids.size());
+                for (size_t i = 0; i < partition_ids.size(); ++i)
+                    ASSERT_EQ(flat_partition_ids[i], partition_ids[i])
+                        << key.type->getName() << ", direction " << direction << ", bounds " << bounds_num << ", row " << i;
+            }
+        }
+    }
+}
+}
+
+TEST(SelectorBuilder, HashToPartitionIdsMatchesGet64)
+{
+    checkHashToPartitionIds<Int8>();
+    checkHashToPartitionIds<UInt8>();
+    checkHashToPartitionIds<Int16>();
+    checkHashToPartitionIds<UInt16>();
+    checkHashToPartitionIds<Int32>();
+    checkHashToPartitionIds<UInt32>();
+    checkHashToPartitionIds<Int64>();
+    checkHashToPartitionIds<UInt64>();
+}
+
+TEST(SelectorBuilder, FlatBoundsMatchBinarySearch)
+{
+    checkFlatBounds<Int8>("ByteType");
+    checkFlatBounds<Int16>("ShortType");
+    checkFlatBounds<Int32>("IntegerType");
+    checkFlatBounds<Int64>("LongType");
+}
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <filesystem>
+#include <random>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <Compression/CompressedReadBuffer.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/ReadHelpers.h>
+#include <Shuffle/PartitionWriter.h>
+#include <Shuffle/SelectorBuilder.h>
+#include <Storages/IO/NativeReader.h>
+#include <base/scope_guard.h>
+#include <gtest/gtest.h>
+#include <Poco/Util/MapConfiguration.h>
+#include <Common/CurrentThread.h>
+#include <Common/GlutenConfig.h>
+#include <Common/QueryContext.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// The ids of the rows read back from each partition, in the order they were read.
+using PartitionRows = std::vector<std::vector<Int64>>;
+
+/// Writes rows with random partition ids through the sort based shuffle writer and reads the spilled files back.
+/// Every row is (id, toString(id)), where id is the position of the row in the input.
+/// The ids written into each partition are returned in input_rows.
+PartitionRows writeSortShuffle(size_t evict_threads, size_t partition_num, PartitionRows & input_rows)
+{
+    constexpr size_t blocks = 16;
+    constexpr size_t block_rows = 1000;
+    constexpr size_t blocks_per_spill = 5;
+
+    auto global_context = QueryContext::globalMutableContext();
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> old_config(
+        const_cast<Poco::Util::AbstractConfiguration *>(&global_context->getConfigRef()), true);
+    Poco::AutoPtr<Poco::Util::MapConfiguration> config = new Poco::Util::MapConfiguration();
+    config->setUInt64(SortShuffleConfig::SORT_SHUFFLE_EVICT_THREADS, evict_threads);
+    /// Small enough that several ranges of partitions are serialized at the same time within the window.
+    config->setUInt64(SortShuffleConfig::SORT_SHUFFLE_EVICT_WINDOW_BYTES, 64_KiB);
+    global_context->setConfig(config);
+    SCOPE_EXIT({ global_context->setConfig(old_config); });
+
+    auto query_id = QueryContext::instance().initializeQuery("gtest_sort_shuffle_writer");
+    SCOPE_EXIT({ QueryContext::instance().finalizeQuery(query_id); });
+    CurrentThread::getGroup()->memory_tracker.setSoftLimit(1_GiB);
+
+    const auto spill_dir
+        = std::filesystem::temp_directory_path() / ("gtest_sort_shuffle_writer_" + std::to_string(evict_threads));
+    std::filesystem::remove_all(spill_dir);
+    SCOPE_EXIT({ std::filesystem::remove_all(spill_dir); });
+
+    SplitOptions options;
+    /// Each partition is written in several blocks.
+    options.split_size = 100;
+    options.local_dirs_list = {spill_dir};
+    options.num_sub_dirs = 4;
+    options.shuffle_id = 0;
+    options.map_id = 0;
+    options.partition_num = partition_num;
+    options.compress_method = "lz4";
+    /// Only the explicit evictions below spill.
+    options.spill_threshold = 0;
+    MemorySortLocalPartitionWriter writer(options);
+    SplitResult split_result;
+
+    const Block header({{std::make_shared<DataTypeInt64>(), "id"}, {std::make_shared<DataTypeString>(), "s"}});
+    writer.initialize(&split_result, header);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> partition_dist(0, partition_num - 1);
+    input_rows.assign(partition_num, {});
+    Int64 next_id = 0;
+    for (size_t b = 0; b < blocks; ++b)
+    {
+        auto id_column = ColumnInt64::create();
+        auto s_column = ColumnString::create();
+        PartitionInfo info;
+        info.partition_num = partition_num;
+        for (size_t i = 0; i < block_rows; ++i, ++next_id)
+        {
+            /// Leave some partitions empty to check they are skipped.
+            size_t partition_id = partition_dist(rng);
+            if (partition_id % 7 == 3)
+                partition_id = 0;
+            id_column->insertValue(next_id);
+            const auto s = std::to_string(next_id);
+            s_column->insertData(s.data(), s.size());
+            info.src_partition_num.push_back(partition_id);
+            input_rows[partition_id].push_back(next_id);
+        }
+        Block block({
+            {std::move(id_column), header.getByPosition(0).type, "id"},
+            {std::move(s_column), header.getByPosition(1).type, "s"},
+        });
+        writer.write(info, block);
+        if ((b + 1) % blocks_per_spill == 0)
+            writer.evictPartitions();
+    }
+    writer.evictPartitions();
+    EXPECT_EQ(writer.getSpillInfos().size(), (blocks + blocks_per_spill - 1) / blocks_per_spill);
+
+    PartitionRows result(partition_num);
+    for (const auto & spill_info : writer.getSpillInfos())
+    {
+        String file_data;
+        {
+            ReadBufferFromFile file(spill_info.spilled_file);
+            readStringUntilEOF(file_data, file);
+        }
+        size_t previous_partition_end = 0;
+        for (const auto & [partition_id, offsets] : spill_info.partition_spill_infos)
+        {
+            const auto & [offset, length] = offsets;
+            /// The partitions are written one after another in the order of partition id.
+            EXPECT_EQ(offset, previous_partition_end);
+            previous_partition_end = offset + length;
+
+            ReadBufferFromString partition_in(std::string_view(file_data).substr(offset, length));
+            CompressedReadBuffer compressed_in(partition_in);
+            NativeReader reader(compressed_in);
+            while (true)
+            {
+                auto block = reader.read();
+                if (!block.rows())
+                    break;
+                const auto & ids = assert_cast<const ColumnInt64 &>(*block.getByName("id").column).getData();
+                const auto & s_column = assert_cast<const ColumnString &>(*block.getByName("s").column);
+                for (size_t i = 0; i < block.rows(); ++i)
+                {
+                    EXPECT_EQ(s_column.getDataAt(i).toView(), std::to_string(ids[i]));
+                    result[partition_id].push_back(ids[i]);
+                }
+            }
+        }
+        EXPECT_EQ(previous_partition_end, file_data.size());
+    }
+    return result;
+}
+
+void checkSortShuffle(size_t evict_threads, size_t partition_num)
+{
+    PartitionRows expected_rows;
+    auto result = writeSortShuffle(evict_threads, partition_num, expected_rows);
+    ASSERT_EQ(result.size(), partition_num);
+    /// The counting sort is stable and the spills are in the order of input, so the rows of each partition keep the input
+    /// order.
+    for (size_t partition_id = 0; partition_id < partition_num; ++partition_id)
+        ASSERT_EQ(result[partition_id], expected_rows[partition_id])
+            << "evict threads " << evict_threads << ", partition " << partition_id;
+}
+}
+
+TEST(SortShuffleWriter, SerializePartitionsInWriterThread)
+{
+    checkSortShuffle(1, 50);
+}
+
+TEST(SortShuffleWriter, SerializePartitionRangesInParallel)
+{
+    checkSortShuffle(4, 50);
+    /// More threads than partitions.
+    checkSortShuffle(8, 3);
+}
+
+TEST(SortShuffleWriter, SinglePartition)
+{
+    checkSortShuffle(1, 1);
+    checkSortShuffle(4, 1);
+}
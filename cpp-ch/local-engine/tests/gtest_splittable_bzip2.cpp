@@ -0,0 +1,157 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "config.h"
+
+#if USE_BZIP2
+#include <filesystem>
+#include <random>
+#include <string_view>
+#include <IO/CompressionMethod.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/ReadHelpers.h>
+#include <IO/SplittableBzip2ReadBuffer.h>
+#include <IO/WriteBufferFromFile.h>
+#include <IO/WriteHelpers.h>
+#include <Interpreters/Context.h>
+#include <Storages/SubstraitSource/ReadBufferBuilder.h>
+#include <base/scope_guard.h>
+#include <gtest/gtest.h>
+#include <substrait/plan.pb.h>
+#include <Poco/AutoPtr.h>
+#include <Poco/Util/MapConfiguration.h>
+#include <Common/GlutenConfig.h>
+#include <Common/QueryContext.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// Level 1 cuts the input into blocks of 100k bytes, so a few hundred KB give several blocks and a partial last one.
+String writeBzip2File(const String & name, const String & data)
+{
+    String path = (std::filesystem::temp_directory_path() / name).string();
+    auto out = wrapWriteBufferWithCompressionMethod(std::make_unique<WriteBufferFromFile>(path), CompressionMethod::Bzip2, 1);
+    writeString(data, *out);
+    out->finalize();
+    return path;
+}
+
+/// Decodes [start, start + length) of the file the way SubstraitFileSource does for a text split.
+String readSplit(const String & path, size_t start, size_t length, size_t max_decompression_threads)
+{
+    auto global_context = QueryContext::globalMutableContext();
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> old_config(
+        const_cast<Poco::Util::AbstractConfiguration *>(&global_context->getConfigRef()), true);
+    Poco::AutoPtr<Poco::Util::MapConfiguration> config = new Poco::Util::MapConfiguration();
+    config->setUInt64(ExecutorConfig::BZIP2_MAX_DECOMPRESSION_THREADS, max_decompression_threads);
+    global_context->setConfig(config);
+    SCOPE_EXIT({ global_context->setConfig(old_config); });
+
+    substrait::ReadRel::LocalFiles::FileOrFiles file_info;
+    file_info.set_uri_file("file://" + path);
+    file_info.set_start(start);
+    file_info.set_length(length);
+    file_info.mutable_text();
+
+    auto builder = ReadBufferBuilderFactory::instance().createBuilder("file", global_context);
+    auto in = builder->buildWithCompressionWrapper(file_info);
+    String result;
+    readStringUntilEOF(result, *in);
+    return result;
+}
+
+String readSplits(const String & path, const std::vector<size_t> & split_starts, size_t max_decompression_threads)
+{
+    const size_t file_size = std::filesystem::file_size(path);
+    String result;
+    for (size_t i = 0; i < split_starts.size(); ++i)
+    {
+        size_t end = i + 1 < split_starts.size() ? split_starts[i + 1] : file_size;
+        result += readSplit(path, split_starts[i], end - split_starts[i], max_decompression_threads);
+    }
+    return result;
+}
+
+size_t countDelimiters(const String & compressed)
+{
+    size_t count = 0;
+    UInt64 window = 0;
+    const UInt64 mask = (1ULL << SplittableBzip2ReadBuffer::DELIMITER_BIT_LENGTH) - 1;
+    for (size_t bit = 0; bit < compressed.size() * 8; ++bit)
+    {
+        window = ((window << 1) | ((static_cast<UInt8>(compressed[bit / 8]) >> (7 - bit % 8)) & 1)) & mask;
+        if (bit + 1 >= SplittableBzip2ReadBuffer::DELIMITER_BIT_LENGTH
+            && window == static_cast<UInt64>(SplittableBzip2ReadBuffer::BLOCK_DELIMITER))
+            ++count;
+    }
+    return count;
+}
+}
+
+TEST(SplittableBzip2ReadBuffer, ParallelMatchesSerialAcrossSplits)
+{
+    String data;
+    std::mt19937 rng(42);
+    for (size_t i = 0; data.size() < 600000; ++i)
+        data += "line " + std::to_string(i) + " " + std::to_string(rng()) + " " + std::to_string(rng()) + "\n";
+
+    const String path = writeBzip2File("gtest_splittable_bzip2_splits.bz2", data);
+    SCOPE_EXIT({ std::filesystem::remove(path); });
+    const size_t file_size = std::filesystem::file_size(path);
+
+    /// Split offsets in compressed bytes fall in the middle of blocks, the last block is partial.
+    const std::vector<size_t> split_starts{0, file_size / 3, file_size * 2 / 3};
+    const String serial = readSplits(path, split_starts, 0);
+    const String parallel = readSplits(path, split_starts, 4);
+    EXPECT_EQ(serial, data);
+    EXPECT_EQ(parallel, serial);
+}
+
+TEST(SplittableBzip2ReadBuffer, ParallelSkipsFalseDelimiters)
+{
+    /// The symbol map of a block using these bytes ends with 0x3141 0x5926 0x5359, which spells the block delimiter
+    /// inside the header of every block. No byte repeats, so the run-length stage keeps all of them.
+    static constexpr std::string_view alphabet = "BCGIOQSTWZ]^acfgiklo";
+    String data;
+    std::mt19937 rng(42);
+    while (data.size() < 250000)
+    {
+        char c = alphabet[rng() % alphabet.size()];
+        if (data.empty() || data.back() != c)
+            data.push_back(c);
+    }
+    data.push_back('\n');
+
+    const String path = writeBzip2File("gtest_splittable_bzip2_false_delimiter.bz2", data);
+    SCOPE_EXIT({ std::filesystem::remove(path); });
+
+    String compressed;
+    {
+        ReadBufferFromFile in(path);
+        readStringUntilEOF(compressed, in);
+    }
+    /// Three blocks, each with its real delimiter and the false one.
+    ASSERT_GE(countDelimiters(compressed), 6U);
+
+    const String serial = readSplits(path, {0}, 0);
+    const String parallel = readSplits(path, {0}, 4);
+    EXPECT_EQ(serial, data);
+    EXPECT_EQ(parallel, serial);
+}
+#endif
@@ -18,6 +18,9 @@
 #include <gluten_test_util.h>
 #include <incbin.h>
 #include <testConfig.h>
+#include <Columns/ColumnConst.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
 #include <Core/Settings.h>
 #include <Disks/ObjectStorages/HDFS/HDFSObjectStorage.h>
 #include <Interpreters/Context.h>
@@ -34,6 +37,9 @@
 #include <gtest/gtest.h>
 #include <substrait/plan.pb.h>
 #include <Poco/StringTokenizer.h>
+#include <Poco/Util/MapConfiguration.h>
+#include <base/scope_guard.h>
+#include <Common/GlutenConfig.h>
 #include <Common/DebugUtils.h>
 #include <Common/QueryContext.h>
 
@@ -232,4 +238,114 @@ TEST(WritePipeline, ComputePartitionedExpression)
     EXPECT_EQ("s_nationkey=1/name=one", partition_by_result_column->getDataAt(0));
     EXPECT_EQ("s_nationkey=2/name=two", partition_by_result_column->getDataAt(1));
     EXPECT_EQ("s_nationkey=3/name=three", partition_by_result_column->getDataAt(2));
-}
\ No newline at end of file
+}
+
+namespace
+{
+/// Collects the names written to each partition and counts the writers opened per partition.
+class CollectingPartitionedSink final : public SparkPartitionedBaseSink
+{
+    class CollectingSink final : public SinkToStorage
+    {
+        std::vector<String> & names_;
+
+    public:
+        CollectingSink(const Block & header, std::vector<String> & names) : SinkToStorage(header), names_(names) { }
+        String getName() const override { return "CollectingSink"; }
+        void consume(Chunk & chunk) override
+        {
+            const auto & column = *chunk.getColumns()[0];
+            for (size_t i = 0; i < chunk.getNumRows(); ++i)
+                names_.push_back(column.getDataAt(i).toString());
+        }
+    };
+
+public:
+    std::map<String, std::vector<String>> names;
+    std::map<String, size_t> writers;
+
+    CollectingPartitionedSink(const ContextPtr & context, const Block & input_header)
+        : SparkPartitionedBaseSink(context, {"value"}, input_header, nullptr)
+    {
+    }
+
+    SinkPtr createSinkForPartition(const String & partition_id, const String & /* bucket */) override
+    {
+        ++writers[partition_id];
+        return std::make_shared<CollectingSink>(getHeader(), names[partition_id]);
+    }
+};
+
+/// Writes rows i = 0..n-1 as (name = toString(i), value = i % partitions) with max_partition_writers = 2 and checks
+/// every partition is written by one writer with all its rows in the input order. If const_names is true, the names of
+/// every other chunk are a const column of the chunk number instead.
+void checkPartitionedWriteWithWriterLimit(size_t max_pending_bytes, bool const_names = false)
+{
+    constexpr size_t partitions = 10;
+    constexpr size_t chunks = 20;
+    constexpr size_t chunk_rows = 1000;
+
+    auto global_context = QueryContext::globalMutableContext();
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> old_config(
+        const_cast<Poco::Util::AbstractConfiguration *>(&global_context->getConfigRef()), true);
+    Poco::AutoPtr<Poco::Util::MapConfiguration> config = new Poco::Util::MapConfiguration();
+    config->setUInt64(ExecutorConfig::MAX_PARTITION_WRITERS, 2);
+    config->setUInt64(ExecutorConfig::MAX_PARTITION_WRITER_PENDING_BYTES, max_pending_bytes);
+    global_context->setConfig(config);
+    SCOPE_EXIT({ global_context->setConfig(old_config); });
+
+    auto query_id = QueryContext::instance().initializeQuery("gtest_write_pipeline");
+    SCOPE_EXIT({ QueryContext::instance().finalizeQuery(query_id); });
+    const auto context = QueryContext::instance().currentQueryContext();
+
+    Block header{{STRING(), "name"}, {UINT(), "value"}};
+    CollectingPartitionedSink sink(context, header);
+    std::map<String, std::vector<String>> expected;
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        const bool const_name = const_names && c % 2 == 1;
+        auto name_column = ColumnString::create();
+        auto value_column = ColumnUInt32::create();
+        for (size_t i = c * chunk_rows; i < (c + 1) * chunk_rows; ++i)
+        {
+            const String name = const_name ? fmt::format("chunk{}", c) : std::to_string(i);
+            if (!const_name || name_column->empty())
+                name_column->insertData(name.data(), name.size());
+            value_column->insertValue(static_cast<UInt32>(i % partitions));
+            expected[fmt::format("value={}", i % partitions)].push_back(name);
+        }
+        ColumnPtr names = std::move(name_column);
+        if (const_name)
+            names = ColumnConst::create(names, chunk_rows);
+        Columns columns;
+        columns.emplace_back(std::move(names));
+        columns.emplace_back(std::move(value_column));
+        Chunk chunk(std::move(columns), chunk_rows);
+        sink.consume(chunk);
+    }
+    sink.onFinish();
+
+    ASSERT_EQ(sink.writers.size(), partitions);
+    for (const auto & [partition_id, count] : sink.writers)
+        EXPECT_EQ(count, 1) << partition_id;
+    EXPECT_EQ(sink.names, expected);
+}
+}
+
+TEST(WritePipeline, PartitionedSinkGroupsPartitionsOverWriterLimit)
+{
+    checkPartitionedWriteWithWriterLimit(0);
+}
+
+TEST(WritePipeline, PartitionedSinkSpillsGroupedPartitions)
+{
+    /// Spills the grouped rows after every chunk, so each grouped partition is merged from many runs
+    checkPartitionedWriteWithWriterLimit(1);
+}
+
+TEST(WritePipeline, PartitionedSinkGroupsConstColumns)
+{
+    /// The const columns are appended to the grouped rows of the earlier chunks, in memory and spilled.
+    checkPartitionedWriteWithWriterLimit(0, true);
+    checkPartitionedWriteWithWriterLimit(1, true);
+}
@@ -17,6 +17,7 @@
 
 #include "Runtime.h"
 #include "utils/Registry.h"
+#include "utils/TraceRecorder.h"
 
 namespace gluten {
 namespace {
@@ -46,11 +47,28 @@ Runtime* Runtime::create(
 }
 
 void Runtime::release(Runtime* runtime) {
+  if (runtime->traceFile_.has_value()) {
+    try {
+      TraceRecorder::instance().dump(*runtime->traceFile_, runtime->taskInfo_.taskId);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to dump the trace of task " << runtime->taskInfo_ << ": " << e.what();
+    }
+    TraceRecorder::setCurrentTask(TraceRecorder::kNoTask);
+    TraceRecorder::instance().disable();
+  }
   const std::string kind = runtime->kind();
   auto& releaser = runtimeReleasers().get(kind);
   releaser(runtime);
 }
 
+void Runtime::traceTo(const std::string& traceFile) {
+  if (!traceFile_.has_value()) {
+    TraceRecorder::instance().enable();
+  }
+  traceFile_ = traceFile;
+  TraceRecorder::setCurrentTask(taskInfo_.taskId);
+}
+
 std::optional<std::string>* Runtime::localWriteFilesTempPath() {
   // This is thread-local to conform to Java side ColumnarWriteFilesExec's design.
   // FIXME: Pass the path through relevant member functions.
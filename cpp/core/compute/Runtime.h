@@ -31,6 +31,7 @@
 #include "shuffle/ShuffleReader.h"
 #include "shuffle/ShuffleWriter.h"
 #include "substrait/plan.pb.h"
+#include "utils/MetricsRegistry.h"
 #include "utils/ObjectStore.h"
 
 namespace gluten {
@@ -163,18 +164,28 @@ class Runtime : public std::enable_shared_from_this<Runtime> {
     taskInfo_ = taskInfo;
   }
 
+  /// Starts tracing the spans of the task, they are written to the file when the runtime is released.
+  void traceTo(const std::string& traceFile);
+
   ObjectHandle saveObject(std::shared_ptr<void> obj) {
     return objStore_->save(obj);
   }
 
+  /// Named counters and histograms of the components created by this runtime.
+  MetricsRegistry* metricsRegistry() {
+    return metricsRegistry_.get();
+  }
+
  protected:
   std::string kind_;
   MemoryManager* memoryManager_;
   std::unique_ptr<ObjectStore> objStore_ = ObjectStore::create();
+  std::unique_ptr<MetricsRegistry> metricsRegistry_ = std::make_unique<MetricsRegistry>();
   std::unordered_map<std::string, std::string> confMap_; // Session conf map
 
   ::substrait::Plan substraitPlan_;
   std::vector<::substrait::ReadRel_LocalFiles> localFiles_;
   SparkTaskInfo taskInfo_;
+  std::optional<std::string> traceFile_;
 };
 } // namespace gluten
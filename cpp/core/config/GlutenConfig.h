@@ -76,6 +76,9 @@ const std::string kSparkRedactionString = "*********(redacted)";
 const std::string kSparkLegacyTimeParserPolicy = "spark.sql.legacy.timeParserPolicy";
 const std::string kShuffleFileBufferSize = "spark.shuffle.file.buffer";
 
+// The directory to write a Chrome trace of the native spans of every task to, tracing is disabled if not set.
+const std::string kTraceDir = "spark.gluten.sql.columnar.backend.traceDir";
+
 std::unordered_map<std::string, std::string>
 parseConfMap(JNIEnv* env, const uint8_t* planData, const int32_t planDataLength);
 
@@ -32,6 +32,7 @@
 #include "utils/Exception.h"
 #include "utils/ObjectStore.h"
 #include "utils/ResourceMap.h"
+#include "utils/TraceRecorder.h"
 
 static jint jniVersion = JNI_VERSION_1_8;
 
@@ -397,6 +398,7 @@ class SparkAllocationListener final : public gluten::AllocationListener {
     }
     JNIEnv* env;
     attachCurrentThreadAsDaemonOrThrow(vm_, &env);
+    GLUTEN_TRACE_SPAN("SparkAllocationListener::allocationChanged");
     if (size < 0) {
       env->CallLongMethod(jListenerGlobalRef_, jUnreserveMethod_, -size);
       checkException(env);
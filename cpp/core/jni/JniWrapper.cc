@@ -38,6 +38,7 @@
 #include "shuffle/rss/RssPartitionWriter.h"
 #include "utils/ArrowStatus.h"
 #include "utils/StringUtil.h"
+#include "utils/TraceRecorder.h"
 
 using namespace gluten;
 
@@ -298,6 +299,19 @@ JNIEXPORT void JNICALL Java_org_apache_gluten_runtime_RuntimeJniWrapper_releaseR
   JNI_METHOD_END()
 }
 
+JNIEXPORT jbyteArray JNICALL Java_org_apache_gluten_runtime_RuntimeJniWrapper_fetchRegistryMetrics( // NOLINT
+    JNIEnv* env,
+    jclass,
+    jlong ctxHandle) {
+  JNI_METHOD_START
+  auto runtime = jniCastOrThrow<Runtime>(ctxHandle);
+  auto buffer = runtime->metricsRegistry()->serialize();
+  auto bytes = env->NewByteArray(buffer.size());
+  env->SetByteArrayRegion(bytes, 0, buffer.size(), reinterpret_cast<const jbyte*>(buffer.data()));
+  return bytes;
+  JNI_METHOD_END(nullptr)
+}
+
 namespace {
 const std::string kBacktraceAllocation = "spark.gluten.memory.backtrace.allocation";
 }
@@ -426,6 +440,9 @@ Java_org_apache_gluten_vectorized_PlanEvaluatorJniWrapper_nativeCreateKernelWith
   auto& conf = ctx->getConfMap();
 
   ctx->setSparkTaskInfo({stageId, partitionId, taskId});
+  if (auto it = conf.find(kTraceDir); it != conf.end() && !it->second.empty()) {
+    ctx->traceTo(it->second + "/trace_" + std::to_string(stageId) + "_" + std::to_string(taskId) + ".json");
+  }
 
   std::string saveDir{};
   std::string fileIdentifier = "_" + std::to_string(stageId) + "_" + std::to_string(partitionId);
@@ -500,6 +517,7 @@ JNIEXPORT jboolean JNICALL Java_org_apache_gluten_vectorized_ColumnarBatchOutIte
         "When hasNext() is called on a closed iterator, an exception is thrown. To prevent this, consider using the protectInvocationFlow() method when creating the iterator in scala side. This will allow the hasNext() method to be called multiple times without issue.";
     throw GlutenException(errorMessage);
   }
+  GLUTEN_TRACE_SPAN("ColumnarBatchOutIterator::hasNext");
   return iter->hasNext();
   JNI_METHOD_END(false)
 }
@@ -516,6 +534,7 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ColumnarBatchOutIterat
     return kInvalidObjectHandle;
   }
 
+  GLUTEN_TRACE_SPAN("ColumnarBatchOutIterator::next");
   std::shared_ptr<ColumnarBatch> batch = iter->next();
   auto batchHandle = ctx->saveObject(batch);
 
@@ -625,7 +644,9 @@ Java_org_apache_gluten_vectorized_NativeColumnarToRowJniWrapper_nativeColumnarTo
   GLUTEN_CHECK(!(it == conf.end()), "Required key not found in runtime config: " + kColumnarToRowMemoryThreshold);
   column2RowMemThreshold = std::stoll(it->second);
   // Convert the native batch to Spark unsafe row.
-  return ctx->saveObject(ctx->createColumnar2RowConverter(column2RowMemThreshold));
+  auto columnarToRowConverter = ctx->createColumnar2RowConverter(column2RowMemThreshold);
+  columnarToRowConverter->setMetricsRegistry(ctx->metricsRegistry());
+  return ctx->saveObject(columnarToRowConverter);
   JNI_METHOD_END(kInvalidObjectHandle)
 }
 
@@ -640,7 +661,11 @@ Java_org_apache_gluten_vectorized_NativeColumnarToRowJniWrapper_nativeColumnarTo
   auto columnarToRowConverter = ObjectStore::retrieve<ColumnarToRowConverter>(c2rHandle);
   auto cb = ObjectStore::retrieve<ColumnarBatch>(batchHandle);
 
-  columnarToRowConverter->convert(cb, startRow);
+  {
+    GLUTEN_TRACE_SPAN("ColumnarToRow::convert");
+    ScopedHistogramTimer timer(columnarToRowConverter->convertNanosHistogram());
+    columnarToRowConverter->convert(cb, startRow);
+  }
 
   const auto& offsets = columnarToRowConverter->getOffsets();
   const auto& lengths = columnarToRowConverter->getLengths();
@@ -699,6 +724,7 @@ Java_org_apache_gluten_vectorized_NativeRowToColumnarJniWrapper_nativeConvertRow
   uint8_t* address = reinterpret_cast<uint8_t*>(memoryAddress);
 
   auto converter = ObjectStore::retrieve<RowToColumnarConverter>(r2cHandle);
+  GLUTEN_TRACE_SPAN("RowToColumnar::convert");
   auto cb = converter->convert(numRows, safeArray.elems(), address);
   return ctx->saveObject(cb);
   JNI_METHOD_END(kInvalidObjectHandle)
@@ -959,9 +985,11 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
   } else {
     throw GlutenException("Unrecognizable partition writer type: " + partitionWriterType);
   }
+  partitionWriter->setMetricsRegistry(ctx->metricsRegistry());
 
-  return ctx->saveObject(
-      ctx->createShuffleWriter(numPartitions, std::move(partitionWriter), std::move(shuffleWriterOptions)));
+  auto shuffleWriter = ctx->createShuffleWriter(numPartitions, std::move(partitionWriter), std::move(shuffleWriterOptions));
+  shuffleWriter->setMetricsRegistry(ctx->metricsRegistry());
+  return ctx->saveObject(shuffleWriter);
   JNI_METHOD_END(kInvalidObjectHandle)
 }
 
@@ -978,6 +1006,7 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
     throw GlutenException(errorMessage);
   }
   int64_t evictedSize;
+  GLUTEN_TRACE_SPAN("ShuffleWriter::reclaimFixedSize");
   arrowAssertOkOrThrow(shuffleWriter->reclaimFixedSize(size, &evictedSize), "(shuffle) nativeEvict: evict failed");
   return (jlong)evictedSize;
   JNI_METHOD_END(kInvalidObjectHandle)
@@ -1000,7 +1029,11 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
   // The column batch maybe VeloxColumnBatch or ArrowCStructColumnarBatch(FallbackRangeShuffleWriter)
   auto batch = ObjectStore::retrieve<ColumnarBatch>(batchHandle);
   auto numBytes = batch->numBytes();
-  arrowAssertOkOrThrow(shuffleWriter->write(batch, memLimit), "Native write: shuffle writer failed");
+  {
+    GLUTEN_TRACE_SPAN("ShuffleWriter::write");
+    ScopedHistogramTimer timer(shuffleWriter->writeBatchNanosHistogram());
+    arrowAssertOkOrThrow(shuffleWriter->write(batch, memLimit), "Native write: shuffle writer failed");
+  }
   return numBytes;
   JNI_METHOD_END(kInvalidObjectHandle)
 }
@@ -1016,7 +1049,10 @@ JNIEXPORT jobject JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrap
     throw GlutenException(errorMessage);
   }
 
-  arrowAssertOkOrThrow(shuffleWriter->stop(), "Native shuffle write: ShuffleWriter stop failed");
+  {
+    GLUTEN_TRACE_SPAN("ShuffleWriter::stop");
+    arrowAssertOkOrThrow(shuffleWriter->stop(), "Native shuffle write: ShuffleWriter stop failed");
+  }
 
   const auto& partitionLengths = shuffleWriter->partitionLengths();
   auto partitionLengthArr = env->NewLongArray(partitionLengths.size());
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include "memory/ColumnarBatch.h"
+#include "utils/MetricsRegistry.h"
 
 namespace gluten {
 
@@ -49,12 +50,22 @@ class ColumnarToRowConverter {
     return lengths_;
   }
 
+  /// Registers the latency distribution of convert(). Optional, nothing is recorded without it.
+  void setMetricsRegistry(MetricsRegistry* registry) {
+    convertNanosHistogram_ = registry->histogram("c2r.convert_nanos");
+  }
+
+  Histogram* convertNanosHistogram() const {
+    return convertNanosHistogram_;
+  }
+
  protected:
   int32_t numCols_;
   int32_t numRows_;
   uint8_t* bufferAddress_;
   std::vector<int32_t> offsets_;
   std::vector<int32_t> lengths_;
+  Histogram* convertNanosHistogram_{nullptr};
 };
 
 } // namespace gluten
@@ -25,6 +25,7 @@
 #include "shuffle/Payload.h"
 #include "shuffle/Spill.h"
 #include "shuffle/Utils.h"
+#include "utils/TraceRecorder.h"
 
 namespace gluten {
 
@@ -416,6 +417,7 @@ void LocalPartitionWriter::init() {
 }
 
 arrow::Status LocalPartitionWriter::mergeSpills(uint32_t partitionId) {
+  GLUTEN_TRACE_SPAN("LocalPartitionWriter::mergeSpills");
   auto spillId = 0;
   auto spillIter = spills_.begin();
   while (spillIter != spills_.end()) {
@@ -437,6 +439,7 @@ arrow::Status LocalPartitionWriter::mergeSpills(uint32_t partitionId) {
 }
 
 arrow::Status LocalPartitionWriter::stop(ShuffleWriterMetrics* metrics) {
+  GLUTEN_TRACE_SPAN("LocalPartitionWriter::stop");
   if (stopped_) {
     return arrow::Status::OK();
   }
@@ -598,6 +601,7 @@ arrow::Status LocalPartitionWriter::sortEvict(
       auto payload,
       inMemoryPayload->toBlockPayload(
           payloadType, payloadPool_.get(), codec_ ? codec_.get() : nullptr, std::move(compressed)));
+  recordPayload(*payload);
   if (!isFinal) {
     RETURN_NOT_OK(spiller_->spill(partitionId, std::move(payload)));
   } else {
@@ -617,6 +621,7 @@ arrow::Status LocalPartitionWriter::sortEvict(
 // FIXME: Remove this code path for local partition writer.
 arrow::Status LocalPartitionWriter::evict(uint32_t partitionId, std::unique_ptr<BlockPayload> blockPayload, bool stop) {
   rawPartitionLengths_[partitionId] += blockPayload->rawSize();
+  recordPayload(*blockPayload);
 
   if (lastEvictPid_ != -1 && partitionId < lastEvictPid_) {
     RETURN_NOT_OK(finishSpill(true));
@@ -641,6 +646,8 @@ arrow::Status LocalPartitionWriter::evict(uint32_t partitionId, std::unique_ptr<
 }
 
 arrow::Status LocalPartitionWriter::reclaimFixedSize(int64_t size, int64_t* actual) {
+  GLUTEN_TRACE_SPAN("LocalPartitionWriter::reclaimFixedSize");
+  ScopedHistogramTimer spillTimer(spillNanosHistogram_);
   // Finish last spiller.
   RETURN_NOT_OK(finishSpill(true));
 
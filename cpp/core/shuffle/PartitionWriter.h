@@ -22,6 +22,7 @@
 #include "shuffle/Options.h"
 #include "shuffle/Payload.h"
 #include "shuffle/Spill.h"
+#include "utils/MetricsRegistry.h"
 
 namespace gluten {
 
@@ -72,6 +73,13 @@ class PartitionWriter : public Reclaimable {
     return options_;
   }
 
+  /// Registers the distributions of payload sizes, compression and spill. Optional, nothing is recorded without it.
+  void setMetricsRegistry(MetricsRegistry* registry) {
+    payloadBytesHistogram_ = registry->histogram("shuffle.payload.bytes");
+    payloadCompressNanosHistogram_ = registry->histogram("shuffle.payload.compress_nanos");
+    spillNanosHistogram_ = registry->histogram("shuffle.spill.nanos");
+  }
+
  protected:
   uint32_t numPartitions_;
   PartitionWriterOptions options_;
@@ -86,5 +94,16 @@ class PartitionWriter : public Reclaimable {
   int64_t compressTime_{0};
   int64_t spillTime_{0};
   int64_t writeTime_{0};
+
+  Histogram* payloadBytesHistogram_{nullptr};
+  Histogram* payloadCompressNanosHistogram_{nullptr};
+  Histogram* spillNanosHistogram_{nullptr};
+
+  void recordPayload(BlockPayload& payload) {
+    if (payloadBytesHistogram_) {
+      payloadBytesHistogram_->record(payload.rawSize());
+      payloadCompressNanosHistogram_->record(payload.getCompressTime());
+    }
+  }
 };
 } // namespace gluten
@@ -29,6 +29,7 @@
 #include "shuffle/Partitioning.h"
 #include "shuffle/ShuffleMemoryPool.h"
 #include "utils/Compression.h"
+#include "utils/MetricsRegistry.h"
 
 namespace gluten {
 
@@ -70,6 +71,15 @@ class ShuffleWriter : public Reclaimable {
 
   const std::vector<int64_t>& rawPartitionLengths() const;
 
+  /// Registers the latency distribution of write(). Optional, nothing is recorded without it.
+  void setMetricsRegistry(MetricsRegistry* registry) {
+    writeBatchNanosHistogram_ = registry->histogram("shuffle.write.batch_nanos");
+  }
+
+  Histogram* writeBatchNanosHistogram() const {
+    return writeBatchNanosHistogram_;
+  }
+
  protected:
   ShuffleWriter(int32_t numPartitions, ShuffleWriterOptions options, arrow::MemoryPool* pool);
 
@@ -82,6 +92,8 @@ class ShuffleWriter : public Reclaimable {
   arrow::MemoryPool* pool_;
 
   ShuffleWriterMetrics metrics_{};
+
+  Histogram* writeBatchNanosHistogram_{nullptr};
 };
 
 } // namespace gluten
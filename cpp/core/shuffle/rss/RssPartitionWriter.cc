@@ -68,7 +68,9 @@ arrow::Status RssPartitionWriter::sortEvict(
 
 arrow::Status RssPartitionWriter::evict(uint32_t partitionId, std::unique_ptr<BlockPayload> blockPayload, bool) {
   rawPartitionLengths_[partitionId] += blockPayload->rawSize();
+  recordPayload(*blockPayload);
   ScopedTimer timer(&spillTime_);
+  ScopedHistogramTimer pushTimer(spillNanosHistogram_);
   ARROW_ASSIGN_OR_RAISE(auto buffer, blockPayload->readBufferAt(0));
   bytesEvicted_[partitionId] += rssClient_->pushPartitionData(partitionId, buffer->data_as<char>(), buffer->size());
   return arrow::Status::OK();
@@ -87,10 +89,12 @@ arrow::Status RssPartitionWriter::doEvict(
   // Copy payload to arrow buffered os.
   ARROW_ASSIGN_OR_RAISE(auto rssBufferOs, arrow::io::BufferOutputStream::Create(options_.pushBufferMaxSize));
   RETURN_NOT_OK(payload->serialize(rssBufferOs.get()));
+  recordPayload(*payload);
   payload = nullptr; // Invalidate payload immediately.
 
   // Push.
   ScopedTimer timer(&spillTime_);
+  ScopedHistogramTimer pushTimer(spillNanosHistogram_);
   ARROW_ASSIGN_OR_RAISE(auto buffer, rssBufferOs->Finish());
   bytesEvicted_[partitionId] += rssClient_->pushPartitionData(
       partitionId, reinterpret_cast<char*>(const_cast<uint8_t*>(buffer->data())), buffer->size());
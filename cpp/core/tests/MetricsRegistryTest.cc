@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/MetricsRegistry.h"
+#include <gtest/gtest.h>
+
+using namespace gluten;
+
+TEST(MetricsRegistry, bucketBounds) {
+  for (int64_t value : {0L, 1L, 7L, 8L, 15L, 16L, 17L, 1000L, 123456789L, INT64_MAX}) {
+    auto bucket = Histogram::bucketOf(value);
+    ASSERT_LT(bucket, Histogram::kNumBuckets);
+    auto lowerBound = Histogram::bucketLowerBound(bucket);
+    ASSERT_LE(lowerBound, value);
+    // The relative error is bounded by the number of sub buckets.
+    ASSERT_LE(value - lowerBound, value / Histogram::kSubBuckets);
+  }
+}
+
+TEST(MetricsRegistry, histogramPercentile) {
+  Histogram histogram;
+  for (int64_t i = 1; i <= 1000; ++i) {
+    histogram.record(i);
+  }
+  ASSERT_EQ(histogram.count(), 1000);
+  ASSERT_EQ(histogram.sum(), 500500);
+  ASSERT_EQ(histogram.min(), 1);
+  ASSERT_EQ(histogram.max(), 1000);
+
+  auto p50 = histogram.percentile(50);
+  ASSERT_LE(p50, 500);
+  ASSERT_GE(p50, 500 - 500 / Histogram::kSubBuckets);
+  auto p99 = histogram.percentile(99);
+  ASSERT_LE(p99, 990);
+  ASSERT_GE(p99, 990 - 990 / Histogram::kSubBuckets);
+  ASSERT_EQ(histogram.percentile(0), 1);
+}
+
+TEST(MetricsRegistry, serializeRoundTrip) {
+  MetricsRegistry registry;
+  registry.counter("shuffle.write.batches")->add(3);
+  ASSERT_EQ(registry.counter("shuffle.write.batches"), registry.counter("shuffle.write.batches"));
+  auto* histogram = registry.histogram("shuffle.payload.bytes");
+  histogram->record(10);
+  histogram->record(10);
+  histogram->record(4096);
+  registry.histogram("c2r.convert_nanos");
+
+  auto snapshot = MetricsRegistry::deserialize(registry.serialize());
+  ASSERT_EQ(snapshot.counters.size(), 1);
+  ASSERT_EQ(snapshot.counters["shuffle.write.batches"], 3);
+  ASSERT_EQ(snapshot.histograms.size(), 2);
+  ASSERT_EQ(snapshot.histograms["c2r.convert_nanos"].count, 0);
+
+  const auto& bytes = snapshot.histograms["shuffle.payload.bytes"];
+  ASSERT_EQ(bytes.count, 3);
+  ASSERT_EQ(bytes.sum, 4116);
+  ASSERT_EQ(bytes.min, 10);
+  ASSERT_EQ(bytes.max, 4096);
+  ASSERT_EQ(bytes.buckets.size(), 2);
+  ASSERT_EQ(bytes.buckets.at(Histogram::bucketOf(10)), 2);
+  ASSERT_EQ(bytes.buckets.at(Histogram::bucketOf(4096)), 1);
+}
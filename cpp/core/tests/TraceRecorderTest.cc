@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/TraceRecorder.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace gluten;
+
+namespace {
+constexpr const char* kSpanA = "spanA";
+constexpr const char* kSpanB = "spanB";
+} // namespace
+
+TEST(TraceRecorder, enableAndDisable) {
+  auto& recorder = TraceRecorder::instance();
+  ASSERT_FALSE(recorder.enabled());
+  recorder.enable();
+  recorder.enable();
+  ASSERT_TRUE(recorder.enabled());
+  recorder.disable();
+  ASSERT_TRUE(recorder.enabled());
+  recorder.disable();
+  ASSERT_FALSE(recorder.enabled());
+}
+
+TEST(TraceRecorder, collectTaskSpans) {
+  auto& recorder = TraceRecorder::instance();
+  TraceRecorder::setCurrentTask(1);
+  recorder.record(kSpanA, 10, 1);
+  TraceRecorder::setCurrentTask(2);
+  recorder.record(kSpanB, 20, 2);
+  TraceRecorder::setCurrentTask(TraceRecorder::kNoTask);
+  recorder.record(kSpanB, 30, 3);
+
+  size_t taskSpans = 0;
+  size_t noTaskSpans = 0;
+  for (const auto& event : recorder.collect(1)) {
+    ASSERT_NE(event.taskId, 2);
+    taskSpans += event.taskId == 1 && event.startNanos == 10;
+    noTaskSpans += event.taskId == TraceRecorder::kNoTask && event.startNanos == 30;
+  }
+  ASSERT_EQ(taskSpans, 1);
+  ASSERT_EQ(noTaskSpans, 1);
+}
+
+// The writers wrap their ring buffers many times while being collected. Every collected span must be one which was
+// written as a whole.
+TEST(TraceRecorder, concurrentRecordAndCollect) {
+  auto& recorder = TraceRecorder::instance();
+  constexpr int kWriters = 4;
+  constexpr int64_t kSpansPerWriter = TraceRecorder::kEventsPerThread * 16;
+  std::atomic<bool> done{false};
+  std::atomic<int> finishedWriters{0};
+  // The writers stay alive until the final collect, a collect drops the buffers of exited threads.
+  std::atomic<bool> exitWriters{false};
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; ++w) {
+    writers.emplace_back([&, w]() {
+      TraceRecorder::setCurrentTask(w % 2 == 0 ? TraceRecorder::kNoTask : 7);
+      const char* name = w % 2 == 0 ? kSpanA : kSpanB;
+      for (int64_t i = 0; i < kSpansPerWriter; ++i) {
+        recorder.record(name, i, i * 3);
+      }
+      ++finishedWriters;
+      while (!exitWriters.load()) {
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  std::thread reader([&]() {
+    while (!done.load()) {
+      for (const auto& event : recorder.collect(7)) {
+        ASSERT_TRUE(event.name == kSpanA || event.name == kSpanB);
+        ASSERT_EQ(event.durationNanos, event.startNanos * 3);
+        ASSERT_TRUE(event.taskId == 7 || event.taskId == TraceRecorder::kNoTask);
+        ASSERT_EQ(event.name == kSpanA, event.taskId == TraceRecorder::kNoTask);
+      }
+    }
+  });
+
+  while (finishedWriters.load() < kWriters) {
+    std::this_thread::yield();
+  }
+  done = true;
+  reader.join();
+
+  // All the writers are idle, their last spans are complete.
+  size_t lastSpans = 0;
+  for (const auto& event : recorder.collect(7)) {
+    lastSpans += event.startNanos == kSpansPerWriter - 1;
+  }
+  exitWriters = true;
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  ASSERT_EQ(lastSpans, kWriters);
+}
@@ -0,0 +1,216 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/MetricsRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "utils/Exception.h"
+
+namespace gluten {
+
+namespace {
+template <typename T>
+void append(std::string& buffer, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  buffer.append(bytes, sizeof(T));
+}
+
+void appendName(std::string& buffer, const std::string& name) {
+  append<int16_t>(buffer, static_cast<int16_t>(name.size()));
+  buffer.append(name);
+}
+
+class BufferReader {
+ public:
+  explicit BufferReader(const std::string& buffer) : buffer_(buffer) {}
+
+  template <typename T>
+  T read() {
+    GLUTEN_CHECK(offset_ + sizeof(T) <= buffer_.size(), "Corrupted metrics buffer");
+    T value;
+    std::memcpy(&value, buffer_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  std::string readName() {
+    auto length = read<int16_t>();
+    GLUTEN_CHECK(length >= 0 && offset_ + length <= buffer_.size(), "Corrupted metrics buffer");
+    std::string name = buffer_.substr(offset_, length);
+    offset_ += length;
+    return name;
+  }
+
+ private:
+  const std::string& buffer_;
+  size_t offset_{0};
+};
+
+int64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+int32_t Histogram::bucketOf(int64_t value) {
+  if (value < kSubBuckets) {
+    return value < 0 ? 0 : static_cast<int32_t>(value);
+  }
+  auto msb = 63 - __builtin_clzll(static_cast<uint64_t>(value));
+  auto shift = msb - kSubBucketBits;
+  auto subBucket = static_cast<int32_t>((value >> shift) & (kSubBuckets - 1));
+  return (shift + 1) * kSubBuckets + subBucket;
+}
+
+int64_t Histogram::bucketLowerBound(int32_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  auto shift = bucket / kSubBuckets - 1;
+  auto subBucket = bucket % kSubBuckets;
+  return static_cast<int64_t>(kSubBuckets + subBucket) << shift;
+}
+
+void Histogram::record(int64_t value) {
+  if (value < 0) {
+    value = 0;
+  }
+  buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+
+  auto min = min_.load(std::memory_order_relaxed);
+  while (value < min && !min_.compare_exchange_weak(min, value, std::memory_order_relaxed)) {
+  }
+  auto max = max_.load(std::memory_order_relaxed);
+  while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+int64_t Histogram::min() const {
+  return count() == 0 ? 0 : min_.load(std::memory_order_relaxed);
+}
+
+int64_t Histogram::percentile(double percentile) const {
+  auto total = count();
+  if (total == 0) {
+    return 0;
+  }
+  // The rank of the value at the percentile, 1 based.
+  auto rank = std::max<int64_t>(1, static_cast<int64_t>(percentile / 100 * total + 0.5));
+  int64_t seen = 0;
+  for (int32_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    seen += bucketCount(bucket);
+    if (seen >= rank) {
+      return std::max(bucketLowerBound(bucket), min());
+    }
+  }
+  return max();
+}
+
+Counter* MetricsRegistry::counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& counter = counters_[name];
+  if (!counter) {
+    counter = std::make_unique<Counter>();
+  }
+  return counter.get();
+}
+
+Histogram* MetricsRegistry::histogram(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& histogram = histograms_[name];
+  if (!histogram) {
+    histogram = std::make_unique<Histogram>();
+  }
+  return histogram.get();
+}
+
+std::string MetricsRegistry::serialize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string buffer;
+
+  append<int32_t>(buffer, static_cast<int32_t>(counters_.size()));
+  for (const auto& [name, counter] : counters_) {
+    appendName(buffer, name);
+    append<int64_t>(buffer, counter->value());
+  }
+
+  append<int32_t>(buffer, static_cast<int32_t>(histograms_.size()));
+  for (const auto& [name, histogram] : histograms_) {
+    appendName(buffer, name);
+    append<int64_t>(buffer, histogram->count());
+    append<int64_t>(buffer, histogram->sum());
+    append<int64_t>(buffer, histogram->min());
+    append<int64_t>(buffer, histogram->max());
+
+    auto numBucketsOffset = buffer.size();
+    int16_t numNonEmptyBuckets = 0;
+    append<int16_t>(buffer, numNonEmptyBuckets);
+    for (int32_t bucket = 0; bucket < Histogram::kNumBuckets; ++bucket) {
+      if (auto count = histogram->bucketCount(bucket)) {
+        append<int16_t>(buffer, static_cast<int16_t>(bucket));
+        append<int64_t>(buffer, count);
+        ++numNonEmptyBuckets;
+      }
+    }
+    std::memcpy(buffer.data() + numBucketsOffset, &numNonEmptyBuckets, sizeof(int16_t));
+  }
+  return buffer;
+}
+
+MetricsRegistry::Snapshot MetricsRegistry::deserialize(const std::string& buffer) {
+  Snapshot snapshot;
+  BufferReader reader(buffer);
+
+  auto numCounters = reader.read<int32_t>();
+  for (int32_t i = 0; i < numCounters; ++i) {
+    auto name = reader.readName();
+    snapshot.counters[name] = reader.read<int64_t>();
+  }
+
+  auto numHistograms = reader.read<int32_t>();
+  for (int32_t i = 0; i < numHistograms; ++i) {
+    auto name = reader.readName();
+    auto& histogram = snapshot.histograms[name];
+    histogram.count = reader.read<int64_t>();
+    histogram.sum = reader.read<int64_t>();
+    histogram.min = reader.read<int64_t>();
+    histogram.max = reader.read<int64_t>();
+    auto numNonEmptyBuckets = reader.read<int16_t>();
+    for (int16_t j = 0; j < numNonEmptyBuckets; ++j) {
+      auto bucket = reader.read<int16_t>();
+      histogram.buckets[bucket] = reader.read<int64_t>();
+    }
+  }
+  return snapshot;
+}
+
+ScopedHistogramTimer::ScopedHistogramTimer(Histogram* histogram)
+    : histogram_(histogram), startNanos_(histogram ? nowNanos() : 0) {}
+
+ScopedHistogramTimer::~ScopedHistogramTimer() {
+  if (histogram_) {
+    histogram_->record(nowNanos() - startNanos_);
+  }
+}
+
+} // namespace gluten
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace gluten {
+
+/// A monotonic counter, safe to update from multiple threads.
+class Counter {
+ public:
+  void add(int64_t delta) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  int64_t value() const {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<int64_t> value_{0};
+};
+
+/// A log-linear histogram of non-negative values in the HDR style. Every power of two range is split into
+/// kSubBuckets linear buckets, so a value is reported with a relative error below 1 / kSubBuckets while the
+/// histogram keeps a fixed size. Safe to record from multiple threads.
+class Histogram {
+ public:
+  static constexpr int32_t kSubBucketBits = 3;
+  static constexpr int32_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int32_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  void record(int64_t value);
+
+  int64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  int64_t sum() const {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  int64_t min() const;
+
+  int64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /// The lower bound of the bucket holding the value at the percentile, 0 <= percentile <= 100.
+  int64_t percentile(double percentile) const;
+
+  int64_t bucketCount(int32_t bucket) const {
+    return buckets_[bucket].load(std::memory_order_relaxed);
+  }
+
+  static int32_t bucketOf(int64_t value);
+
+  static int64_t bucketLowerBound(int32_t bucket);
+
+ private:
+  std::array<std::atomic<int64_t>, kNumBuckets> buckets_{};
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> sum_{0};
+  std::atomic<int64_t> min_{INT64_MAX};
+  std::atomic<int64_t> max_{0};
+};
+
+/// Named counters and histograms registered by the native components of a task, e.g. the shuffle writer, the
+/// partition writers, spill and columnar to row. Names are dot separated paths such as "shuffle.spill.nanos" so
+/// that consumers can group them. Unlike the fixed per plan node Metrics, a component adds a metric by using a new
+/// name, and distributions are kept besides totals.
+///
+/// The registry is exported as one compact little-endian buffer:
+///   int32 numCounters, then per counter: int16 nameLength, name, int64 value
+///   int32 numHistograms, then per histogram: int16 nameLength, name, int64 count, int64 sum, int64 min, int64 max,
+///     int16 numNonEmptyBuckets, then per non-empty bucket: int16 bucket, int64 count
+/// The value range of a bucket is given by Histogram::bucketLowerBound.
+class MetricsRegistry {
+ public:
+  /// Returns the counter of the name, registering it on first use. The pointer is valid as long as the registry.
+  Counter* counter(const std::string& name);
+
+  /// Returns the histogram of the name, registering it on first use. The pointer is valid as long as the registry.
+  Histogram* histogram(const std::string& name);
+
+  std::string serialize() const;
+
+  struct HistogramSnapshot {
+    int64_t count;
+    int64_t sum;
+    int64_t min;
+    int64_t max;
+    std::map<int32_t, int64_t> buckets;
+  };
+
+  struct Snapshot {
+    std::map<std::string, int64_t> counters;
+    std::map<std::string, HistogramSnapshot> histograms;
+  };
+
+  static Snapshot deserialize(const std::string& buffer);
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Counter>> counters_;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+};
+
+/// Records the elapsed nanoseconds into a histogram on destruction. Nothing is recorded if the histogram is null.
+class ScopedHistogramTimer {
+ public:
+  explicit ScopedHistogramTimer(Histogram* histogram);
+
+  ~ScopedHistogramTimer();
+
+ private:
+  Histogram* histogram_;
+  int64_t startNanos_;
+};
+
+} // namespace gluten
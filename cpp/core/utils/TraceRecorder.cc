@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/TraceRecorder.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+#include "utils/Exception.h"
+
+namespace gluten {
+
+namespace {
+thread_local int64_t currentTaskId = TraceRecorder::kNoTask;
+} // namespace
+
+TraceRecorder& TraceRecorder::instance() {
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+int64_t TraceRecorder::nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void TraceRecorder::setCurrentTask(int64_t taskId) {
+  currentTaskId = taskId;
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::threadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    buffer = std::make_shared<ThreadBuffer>();
+    buffer->threadId = static_cast<int64_t>(::syscall(SYS_gettid));
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(buffer);
+  }
+  return buffer.get();
+}
+
+void TraceRecorder::record(const char* name, int64_t startNanos, int64_t durationNanos) {
+  auto* buffer = threadBuffer();
+  auto size = buffer->size.load(std::memory_order_relaxed);
+  auto& slot = buffer->slots[size % kEventsPerThread];
+  auto sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.index.store(size, std::memory_order_relaxed);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.startNanos.store(startNanos, std::memory_order_relaxed);
+  slot.durationNanos.store(durationNanos, std::memory_order_relaxed);
+  slot.taskId.store(currentTaskId, std::memory_order_relaxed);
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  buffer->size.store(size + 1, std::memory_order_release);
+}
+
+std::vector<TraceRecorder::ThreadEvent> TraceRecorder::collectWithThreads(int64_t taskId) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers = buffers_;
+    // Drop the buffers of the exited threads, they are collected for the last time. Such a buffer is only referenced
+    // by buffers_ and the copy above.
+    buffers_.erase(
+        std::remove_if(buffers_.begin(), buffers_.end(), [](const auto& buffer) { return buffer.use_count() == 2; }),
+        buffers_.end());
+  }
+
+  std::vector<ThreadEvent> events;
+  for (const auto& buffer : buffers) {
+    auto size = buffer->size.load(std::memory_order_acquire);
+    auto begin = size > kEventsPerThread ? size - kEventsPerThread : 0;
+    for (auto i = begin; i < size; ++i) {
+      const auto& slot = buffer->slots[i % kEventsPerThread];
+      auto sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence & 1) {
+        continue;
+      }
+      auto index = slot.index.load(std::memory_order_relaxed);
+      Event event{
+          slot.name.load(std::memory_order_relaxed),
+          slot.startNanos.load(std::memory_order_relaxed),
+          slot.durationNanos.load(std::memory_order_relaxed),
+          slot.taskId.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // Skip the slot if it was rewritten while being read or already holds a later span.
+      if (slot.sequence.load(std::memory_order_relaxed) != sequence || index != i) {
+        continue;
+      }
+      if (event.taskId != taskId && event.taskId != kNoTask) {
+        continue;
+      }
+      events.push_back({buffer->threadId, event});
+    }
+  }
+  return events;
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::collect(int64_t taskId) {
+  std::vector<Event> events;
+  for (const auto& threadEvent : collectWithThreads(taskId)) {
+    events.push_back(threadEvent.event);
+  }
+  return events;
+}
+
+void TraceRecorder::dump(const std::string& path, int64_t taskId) {
+  auto events = collectWithThreads(taskId);
+  std::ofstream out(path);
+  GLUTEN_CHECK(out.is_open(), "Failed to open trace file " + path);
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  auto pid = static_cast<int64_t>(::getpid());
+  for (const auto& [threadId, event] : events) {
+    out << (first ? "" : ",") << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << pid
+        << ",\"tid\":" << threadId << ",\"ts\":" << event.startNanos / 1000.0
+        << ",\"dur\":" << event.durationNanos / 1000.0 << "}";
+    first = false;
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+} // namespace gluten
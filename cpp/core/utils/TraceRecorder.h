@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils/Macros.h"
+
+namespace gluten {
+
+/// A process wide, low overhead recorder of native spans, dumped as a Chrome trace (chrome://tracing, Perfetto) per
+/// task. Each thread records into its own fixed size ring buffer without locking; when a buffer is full the oldest
+/// spans are overwritten. Each slot is guarded by a sequence lock, a dump skips the slots being written at the same
+/// time. Recording is a single relaxed load when tracing is disabled.
+///
+/// Spans are attributed to the task whose kernel was created last on the recording thread, which is how Spark runs
+/// a task on one thread. Spans recorded on other threads, e.g. background spilling, carry no task and are dumped
+/// with every task.
+class TraceRecorder {
+ public:
+  static constexpr int64_t kNoTask = -1;
+  static constexpr size_t kEventsPerThread = 8192;
+
+  struct Event {
+    // Must be a string literal, it's stored by pointer.
+    const char* name;
+    int64_t startNanos;
+    int64_t durationNanos;
+    int64_t taskId;
+  };
+
+  static TraceRecorder& instance();
+
+  /// Tracing stays enabled until each enable() is paired with a disable(), i.e. while any task is traced.
+  void enable() {
+    tracers_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void disable() {
+    tracers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool enabled() const {
+    return tracers_.load(std::memory_order_relaxed) > 0;
+  }
+
+  void record(const char* name, int64_t startNanos, int64_t durationNanos);
+
+  /// Returns the recorded spans of the task and the spans without a task. Spans being written concurrently are
+  /// skipped.
+  std::vector<Event> collect(int64_t taskId);
+
+  /// Writes the spans returned by collect(taskId) to a Chrome trace JSON file.
+  void dump(const std::string& path, int64_t taskId);
+
+  static void setCurrentTask(int64_t taskId);
+
+  static int64_t nowNanos();
+
+ private:
+  // Only written by the owning thread. sequence is odd while the slot is written, index is the position of the span
+  // in the thread's history so a dump could tell a span from one which overwrote it.
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> index{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> startNanos{0};
+    std::atomic<int64_t> durationNanos{0};
+    std::atomic<int64_t> taskId{kNoTask};
+  };
+
+  struct ThreadBuffer {
+    int64_t threadId;
+    std::array<Slot, kEventsPerThread> slots;
+    std::atomic<uint64_t> size{0};
+  };
+
+  struct ThreadEvent {
+    int64_t threadId;
+    Event event;
+  };
+
+  ThreadBuffer* threadBuffer();
+
+  std::vector<ThreadEvent> collectWithThreads(int64_t taskId);
+
+  std::atomic<int32_t> tracers_{0};
+  std::mutex mutex_;
+  // Buffers of exited threads are kept until the next dump.
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+/// Records the enclosing scope as a span of the name when tracing is enabled.
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char* name)
+      : name_(name), startNanos_(TraceRecorder::instance().enabled() ? TraceRecorder::nowNanos() : -1) {}
+
+  ~TraceSpan() {
+    if (startNanos_ >= 0) {
+      TraceRecorder::instance().record(name_, startNanos_, TraceRecorder::nowNanos() - startNanos_);
+    }
+  }
+
+ private:
+  const char* name_;
+  int64_t startNanos_;
+};
+
+#define GLUTEN_TRACE_SPAN_NAME(line) GLUTEN_CONCAT(traceSpan, line)
+#define GLUTEN_TRACE_SPAN_AT(name, line) ::gluten::TraceSpan GLUTEN_TRACE_SPAN_NAME(line)(name)
+#define GLUTEN_TRACE_SPAN(name) GLUTEN_TRACE_SPAN_AT(name, __LINE__)
+
+} // namespace gluten
@@ -76,9 +76,27 @@ DEFINE_string(
     "stream",
     "Scan mode for reading parquet data."
     "'stream' mode: Input file scan happens inside of the pipeline."
-    "'buffered' mode: First read all data into memory and feed the pipeline with it.");
+    "'buffered' mode: First read all data into memory and feed the pipeline with it."
+    "'velox' mode: Same as 'stream' but use Velox's native parquet reader on the task memory pool.");
+DEFINE_string(scan_columns, "", "Comma-separated column names to read in 'velox' scan mode. Empty means all columns.");
+DEFINE_int32(scan_parallelism, 1, "Number of row group ranges decoded concurrently in 'velox' scan mode.");
+DEFINE_int64(scan_load_quantum, 256 << 20, "Load quantum of the reader in 'velox' scan mode.");
+DEFINE_int64(scan_max_coalesced_bytes, 64 << 20, "Max coalesced bytes of the reader in 'velox' scan mode.");
+DEFINE_int32(scan_max_coalesced_distance, 512 << 10, "Max coalesced distance of the reader in 'velox' scan mode.");
 DEFINE_bool(debug_mode, false, "Whether to enable debug mode. Same as setting `spark.gluten.sql.debug`");
 
+FileReaderOptions getFileReaderOptions() {
+  FileReaderOptions options;
+  if (!FLAGS_scan_columns.empty()) {
+    options.columns = gluten::splitByDelim(FLAGS_scan_columns, ',');
+  }
+  options.parallelism = FLAGS_scan_parallelism;
+  options.loadQuantum = FLAGS_scan_load_quantum;
+  options.maxCoalescedBytes = FLAGS_scan_max_coalesced_bytes;
+  options.maxCoalescedDistance = FLAGS_scan_max_coalesced_distance;
+  return options;
+}
+
 struct WriterMetrics {
   int64_t splitTime{0};
   int64_t evictTime{0};
@@ -326,7 +344,7 @@ void updateBenchmarkMetrics(
         readerMetrics.deserializeTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
 
     auto splitTime = writerMetrics.splitTime;
-    if (FLAGS_scan_mode == "stream") {
+    if (FLAGS_scan_mode == "stream" || FLAGS_scan_mode == "velox") {
       splitTime -= readInputTime;
     }
     state.counters["shuffle_split_time"] =
@@ -388,7 +406,11 @@ auto BM_Generic = [](::benchmark::State& state,
       if (!dataFiles.empty()) {
         for (const auto& input : dataFiles) {
           inputIters.push_back(FileReaderIterator::getInputIteratorFromFileReader(
-              readerType, input, FLAGS_batch_size, runtime->memoryManager()->getLeafMemoryPool().get()));
+              readerType,
+              input,
+              FLAGS_batch_size,
+              runtime->memoryManager()->getLeafMemoryPool().get(),
+              getFileReaderOptions()));
         }
         std::transform(
             inputIters.begin(),
@@ -490,7 +512,11 @@ auto BM_ShuffleWriteRead = [](::benchmark::State& state,
     ScopedTimer timer(&elapsedTime);
     for (auto _ : state) {
       auto resultIter = FileReaderIterator::getInputIteratorFromFileReader(
-          readerType, inputFile, FLAGS_batch_size, runtime->memoryManager()->getLeafMemoryPool().get());
+          readerType,
+          inputFile,
+          FLAGS_batch_size,
+          runtime->memoryManager()->getLeafMemoryPool().get(),
+          getFileReaderOptions());
       runShuffle(
           runtime,
           listenerPtr,
@@ -699,6 +725,9 @@ int main(int argc, char** argv) {
     if (FLAGS_scan_mode == "buffered") {
       readerType = FileReaderType::kBuffered;
       LOG(WARNING) << "Using buffered mode for reading parquet data.";
+    } else if (FLAGS_scan_mode == "velox") {
+      readerType = FileReaderType::kVelox;
+      LOG(WARNING) << "Using velox native reader for reading parquet data.";
     } else {
       readerType = FileReaderType::kStream;
       LOG(WARNING) << "Using stream mode for reading parquet data.";
@@ -35,6 +35,8 @@
 
 #include "benchmarks/common/BenchmarkUtils.h"
 #include "compute/VeloxRuntime.h"
+#include "config/GlutenConfig.h"
+#include "config/VeloxConfig.h"
 #include "memory/ArrowMemoryPool.h"
 #include "memory/ColumnarBatch.h"
 #include "memory/VeloxMemoryManager.h"
@@ -211,13 +213,20 @@ class GoogleBenchmarkArrowParquetWriteCacheScanBenchmark : public GoogleBenchmar
 
 class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmarkParquetWrite {
  public:
-  GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark(std::string fileName, std::string outputPath)
-      : GoogleBenchmarkParquetWrite(fileName, outputPath) {}
+  GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark(
+      std::string fileName,
+      std::string outputPath,
+      std::unordered_map<std::string, std::string> writeConfs = {},
+      bool pinCpu = true)
+      : GoogleBenchmarkParquetWrite(fileName, outputPath), writeConfs_(std::move(writeConfs)), pinCpu_(pinCpu) {}
   void operator()(benchmark::State& state) {
-    if (state.range(0) == 0xffffffff) {
-      setCpu(state.thread_index());
-    } else {
-      setCpu(state.range(0));
+    // The parquet write threads are started from this thread and would inherit its affinity.
+    if (pinCpu_) {
+      if (state.range(0) == 0xffffffff) {
+        setCpu(state.thread_index());
+      } else {
+        setCpu(state.range(0));
+      }
     }
 
     std::shared_ptr<arrow::RecordBatch> recordBatch;
@@ -260,6 +269,10 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
     auto memoryManager = getDefaultMemoryManager();
     auto runtime = Runtime::create(kVeloxBackendKind, memoryManager.get());
     auto veloxPool = memoryManager->getAggregateMemoryPool();
+    auto writeConfs = runtime->getConfMap();
+    for (const auto& [key, value] : writeConfs_) {
+      writeConfs[key] = value;
+    }
 
     for (auto _ : state) {
       // Init VeloxParquetDataSource
@@ -269,14 +282,15 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
           veloxPool->addLeafChild("sink_pool"),
           localSchema);
 
-      veloxParquetDataSource->init(runtime->getConfMap());
+      veloxParquetDataSource->init(writeConfs);
       auto start = std::chrono::steady_clock::now();
       for (const auto& vector : vectors) {
         veloxParquetDataSource->write(vector);
       }
+      // Writes may still be in flight on the parquet write executor, they finish in close.
+      veloxParquetDataSource->close();
       auto end = std::chrono::steady_clock::now();
       writeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-      veloxParquetDataSource->close();
     }
 
     state.counters["rowgroups"] =
@@ -298,21 +312,28 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
         benchmark::Counter(writeTime, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
     Runtime::release(runtime);
   }
+
+ private:
+  std::unordered_map<std::string, std::string> writeConfs_;
+  bool pinCpu_;
 };
 
 } // namespace gluten
 
 // GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark usage
 // ./parquet_write_benchmark --threads=1 --file /mnt/DP_disk1/int.parquet --output file:/tmp/parquet-write
+// Encode the row groups on 8 background threads, compare CacheScanZstd with and without --write-threads
+// ./parquet_write_benchmark --threads=1 --file /mnt/DP_disk1/wide.parquet --output file:/tmp/parquet-write \
+//     --write-threads 8
 // GoogleBenchmarkArrowParquetWriteCacheScanBenchmark usage
 // ./parquet_write_benchmark --threads=1 --file /mnt/DP_disk1/int.parquet --output /tmp/parquet-write
 int main(int argc, char** argv) {
-  gluten::initVeloxBackend();
   uint32_t iterations = 1;
   uint32_t threads = 1;
   std::string datafile;
   uint32_t cpu = 0xffffffff;
   std::string output;
+  uint32_t writeThreads = 0;
 
   for (int i = 0; i < argc; i++) {
     if (strcmp(argv[i], "--iterations") == 0) {
@@ -325,6 +346,8 @@ int main(int argc, char** argv) {
       cpu = atol(argv[i + 1]);
     } else if (strcmp(argv[i], "--output") == 0) {
       output = (argv[i + 1]);
+    } else if (strcmp(argv[i], "--write-threads") == 0) {
+      writeThreads = atol(argv[i + 1]);
     }
   }
   LOG(INFO) << "iterations = " << iterations;
@@ -332,8 +355,15 @@ int main(int argc, char** argv) {
   LOG(INFO) << "datafile = " << datafile;
   LOG(INFO) << "cpu = " << cpu;
   LOG(INFO) << "output = " << output;
+  LOG(INFO) << "write threads = " << writeThreads;
+
+  auto backendConf = gluten::defaultConf();
+  backendConf[gluten::kVeloxParquetWriteThreads] = std::to_string(writeThreads);
+  gluten::initVeloxBackend(backendConf);
 
   gluten::GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark bck(datafile, output);
+  gluten::GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark zstdBck(
+      datafile, output, {{gluten::kParquetCompressionCodec, "zstd"}}, false);
 
   benchmark::RegisterBenchmark("GoogleBenchmarkParquetWrite::CacheScan", bck)
       ->Args({
@@ -345,6 +375,16 @@ int main(int argc, char** argv) {
       ->MeasureProcessCPUTime()
       ->Unit(benchmark::kSecond);
 
+  benchmark::RegisterBenchmark("GoogleBenchmarkParquetWrite::CacheScanZstd", zstdBck)
+      ->Args({
+          cpu,
+      })
+      ->Iterations(iterations)
+      ->Threads(threads)
+      ->ReportAggregatesOnly(false)
+      ->UseRealTime()
+      ->Unit(benchmark::kSecond);
+
   benchmark::Initialize(&argc, argv);
   benchmark::RunSpecifiedBenchmarks();
   benchmark::Shutdown();
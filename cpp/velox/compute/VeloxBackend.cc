@@ -19,6 +19,7 @@
 #include "VeloxBackend.h"
 
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 
 #include "operators/functions/RegistrationAllFunctions.h"
 #include "operators/plannodes/RowVectorStream.h"
@@ -173,6 +174,15 @@ void VeloxBackend::init(const std::unordered_map<std::string, std::string>& conf
 
   initUdf();
 
+  if (auto capacity = backendConf_->get<uint32_t>(kVeloxPlanCacheCapacity, kVeloxPlanCacheCapacityDefault)) {
+    planCache_ = std::make_unique<VeloxPlanCache>(capacity);
+  }
+
+  if (auto threads = backendConf_->get<uint32_t>(kVeloxParquetWriteThreads, kVeloxParquetWriteThreadsDefault)) {
+    parquetWriteExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        threads, std::make_shared<folly::NamedThreadFactory>("ParquetWrite"));
+  }
+
   // Initialize the global memory manager for current process.
   auto sparkOverhead = backendConf_->get<int64_t>(kSparkOverheadMemory);
   int64_t memoryManagerCapacity;
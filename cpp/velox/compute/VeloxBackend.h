@@ -21,9 +21,11 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <filesystem>
 
+#include "compute/VeloxPlanCache.h"
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/config/Config.h"
 #include "velox/common/memory/MemoryPool.h"
@@ -59,11 +61,29 @@ class VeloxBackend {
     return backendConf_;
   }
 
+  /// Null if the plan cache is disabled.
+  VeloxPlanCache* getPlanCache() const {
+    return planCache_.get();
+  }
+
+  /// Null if the Velox background IO threads are disabled.
+  folly::IOThreadPoolExecutor* getIOExecutor() const {
+    return ioExecutor_.get();
+  }
+
+  /// Null if the parquet writes run on the task threads.
+  folly::CPUThreadPoolExecutor* getParquetWriteExecutor() const {
+    return parquetWriteExecutor_.get();
+  }
+
   void tearDown() {
     // Destruct IOThreadPoolExecutor will join all threads.
     // On threads exit, thread local variables can be constructed with referencing global variables.
     // So, we need to destruct IOThreadPoolExecutor and stop the threads before global variables get destructed.
     ioExecutor_.reset();
+    parquetWriteExecutor_.reset();
+    // The cached plans hold constants allocated from the memory manager.
+    planCache_.reset();
   }
 
  private:
@@ -89,8 +109,11 @@ class VeloxBackend {
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ssdCacheExecutor_;
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> parquetWriteExecutor_;
   std::shared_ptr<facebook::velox::memory::MmapAllocator> cacheAllocator_;
 
+  std::unique_ptr<VeloxPlanCache> planCache_;
+
   std::string cachePathPrefix_;
   std::string cacheFilePrefix_;
 
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VeloxPlanCache.h"
+
+#include <algorithm>
+
+#include "compute/VeloxPlanConverter.h"
+#include "operators/plannodes/RowVectorStream.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+std::string VeloxPlanCache::makeKey(
+    const std::string& planBytes,
+    const std::unordered_map<std::string, std::string>& conf) {
+  std::vector<std::pair<std::string, std::string>> sortedConf(conf.begin(), conf.end());
+  std::sort(sortedConf.begin(), sortedConf.end());
+
+  std::string key = planBytes;
+  for (const auto& [k, v] : sortedConf) {
+    key.append(1, '\0').append(k).append(1, '=').append(v);
+  }
+  return key;
+}
+
+std::shared_ptr<const velox::core::PlanNode> VeloxPlanCache::get(
+    const std::string& key,
+    const std::vector<::substrait::ReadRel_LocalFiles>& localFiles,
+    std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap) {
+  std::shared_ptr<const Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = plans_.find(key);
+    if (it == plans_.end() || it->second->numLocalFiles != localFiles.size()) {
+      ++misses_;
+      return nullptr;
+    }
+    entry = it->second;
+    ++hits_;
+    VLOG(2) << "Velox plan cache hit, hits: " << hits_ << ", misses: " << misses_;
+  }
+
+  auto splitInfos = VeloxPlanConverter::parseLocalFiles(localFiles);
+  for (const auto& [nodeId, index] : entry->scanNodes) {
+    splitInfoMap[nodeId] = splitInfos[index];
+  }
+  return entry->plan;
+}
+
+void VeloxPlanCache::put(
+    const std::string& key,
+    const std::shared_ptr<const velox::core::PlanNode>& plan,
+    const std::vector<std::shared_ptr<SplitInfo>>& localSplitInfos,
+    const std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap) {
+  if (!cacheable(*plan, localSplitInfos, splitInfoMap)) {
+    return;
+  }
+
+  auto entry = std::make_shared<Entry>();
+  entry->plan = plan;
+  entry->numLocalFiles = localSplitInfos.size();
+  for (const auto& [nodeId, splitInfo] : splitInfoMap) {
+    auto it = std::find(localSplitInfos.begin(), localSplitInfos.end(), splitInfo);
+    entry->scanNodes.emplace_back(nodeId, it - localSplitInfos.begin());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  plans_.set(key, std::move(entry));
+}
+
+bool VeloxPlanCache::cacheable(
+    const velox::core::PlanNode& plan,
+    const std::vector<std::shared_ptr<SplitInfo>>& localSplitInfos,
+    const std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap) {
+  if (!shareable(plan)) {
+    return false;
+  }
+  // A split not from the local files can't be rebound.
+  return std::all_of(splitInfoMap.begin(), splitInfoMap.end(), [&](const auto& entry) {
+    return std::find(localSplitInfos.begin(), localSplitInfos.end(), entry.second) != localSplitInfos.end();
+  });
+}
+
+bool VeloxPlanCache::shareable(const velox::core::PlanNode& plan) {
+  if (dynamic_cast<const ValueStreamNode*>(&plan) != nullptr ||
+      dynamic_cast<const velox::core::TableWriteNode*>(&plan) != nullptr) {
+    return false;
+  }
+  for (const auto& source : plan.sources()) {
+    if (!shareable(*source)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace gluten
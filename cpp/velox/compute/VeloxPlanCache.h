@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/EvictingCacheMap.h>
+#include <mutex>
+
+#include "substrait/SubstraitToVeloxPlan.h"
+#include "substrait/plan.pb.h"
+#include "velox/core/PlanNode.h"
+
+namespace gluten {
+
+/// An executor level cache of the Velox plans converted from Substrait plans. The tasks of a stage receive the same
+/// Substrait plan and differ only in their splits, so the converted plan tree, which is immutable, is shared by them
+/// and every task only binds its own splits to the scan nodes.
+/// Plans reading from input iterators or writing files hold task level state and are never cached.
+class VeloxPlanCache {
+ public:
+  explicit VeloxPlanCache(size_t capacity) : plans_(capacity) {}
+
+  /// The fingerprint of a plan, made of the serialized Substrait plan and the session configs used to convert it.
+  static std::string makeKey(const std::string& planBytes, const std::unordered_map<std::string, std::string>& conf);
+
+  /// Returns the cached plan of the key and fills splitInfoMap with the splits parsed from localFiles, or nullptr if
+  /// the plan is not cached.
+  std::shared_ptr<const facebook::velox::core::PlanNode> get(
+      const std::string& key,
+      const std::vector<::substrait::ReadRel_LocalFiles>& localFiles,
+      std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap);
+
+  /// Whether put would cache the plan: it doesn't read from the task's input iterators or write files, and all of its
+  /// splits come from the local files of the task, so they can be rebound to the local files of another task.
+  static bool cacheable(
+      const facebook::velox::core::PlanNode& plan,
+      const std::vector<std::shared_ptr<SplitInfo>>& localSplitInfos,
+      const std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap);
+
+  /// Caches the plan if it is cacheable. localSplitInfos are the splits parsed from the local files of the task, in
+  /// order, and splitInfoMap is how they were bound to the scan nodes by the conversion.
+  void put(
+      const std::string& key,
+      const std::shared_ptr<const facebook::velox::core::PlanNode>& plan,
+      const std::vector<std::shared_ptr<SplitInfo>>& localSplitInfos,
+      const std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap);
+
+ private:
+  struct Entry {
+    std::shared_ptr<const facebook::velox::core::PlanNode> plan;
+    /// The scan node ids with the index of the local files bound to each of them.
+    std::vector<std::pair<facebook::velox::core::PlanNodeId, size_t>> scanNodes;
+    size_t numLocalFiles;
+  };
+
+  static bool shareable(const facebook::velox::core::PlanNode& plan);
+
+  std::mutex mutex_;
+  folly::EvictingCacheMap<std::string, std::shared_ptr<const Entry>> plans_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace gluten
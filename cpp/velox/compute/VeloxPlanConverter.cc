@@ -100,10 +100,10 @@ std::shared_ptr<SplitInfo> parseScanSplitInfo(
   }
   return splitInfo;
 }
+} // namespace
 
-void parseLocalFileNodes(
-    SubstraitToVeloxPlanConverter* planConverter,
-    std::vector<::substrait::ReadRel_LocalFiles>& localFiles) {
+std::vector<std::shared_ptr<SplitInfo>> VeloxPlanConverter::parseLocalFiles(
+    const std::vector<::substrait::ReadRel_LocalFiles>& localFiles) {
   std::vector<std::shared_ptr<SplitInfo>> splitInfos;
   splitInfos.reserve(localFiles.size());
   for (int32_t i = 0; i < localFiles.size(); i++) {
@@ -112,16 +112,15 @@ void parseLocalFileNodes(
 
     splitInfos.push_back(parseScanSplitInfo(fileList));
   }
-
-  planConverter->setSplitInfos(std::move(splitInfos));
+  return splitInfos;
 }
-} // namespace
 
 std::shared_ptr<const facebook::velox::core::PlanNode> VeloxPlanConverter::toVeloxPlan(
     const ::substrait::Plan& substraitPlan,
     std::vector<::substrait::ReadRel_LocalFiles> localFiles) {
   if (!validationMode_) {
-    parseLocalFileNodes(&substraitVeloxPlanConverter_, localFiles);
+    localSplitInfos_ = parseLocalFiles(localFiles);
+    substraitVeloxPlanConverter_.setSplitInfos(localSplitInfos_);
   }
 
   auto veloxPlan = substraitVeloxPlanConverter_.toVeloxPlan(substraitPlan);
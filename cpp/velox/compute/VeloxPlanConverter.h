@@ -44,6 +44,14 @@ class VeloxPlanConverter {
     return substraitVeloxPlanConverter_.splitInfos();
   }
 
+  /// The splits parsed from the local files passed to toVeloxPlan, in the same order.
+  const std::vector<std::shared_ptr<SplitInfo>>& localSplitInfos() const {
+    return localSplitInfos_;
+  }
+
+  static std::vector<std::shared_ptr<SplitInfo>> parseLocalFiles(
+      const std::vector<::substrait::ReadRel_LocalFiles>& localFiles);
+
  private:
   std::string nextPlanNodeId();
 
@@ -51,6 +59,8 @@ class VeloxPlanConverter {
 
   bool validationMode_;
 
+  std::vector<std::shared_ptr<SplitInfo>> localSplitInfos_;
+
   SubstraitToVeloxPlanConverter substraitVeloxPlanConverter_;
 };
 
@@ -79,6 +79,9 @@ void VeloxRuntime::parsePlan(const uint8_t* data, int32_t size, std::optional<st
   }
 
   GLUTEN_CHECK(parseProtobuf(data, size, &substraitPlan_) == true, "Parse substrait plan failed");
+  if (VeloxBackend::get()->getPlanCache() != nullptr) {
+    planBytes_.assign(reinterpret_cast<const char*>(data), size);
+  }
 }
 
 void VeloxRuntime::parseSplitInfo(const uint8_t* data, int32_t size, std::optional<std::string> dumpFile) {
@@ -138,9 +141,34 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
     const std::unordered_map<std::string, std::string>& sessionConf) {
   LOG_IF(INFO, debugModeEnabled_) << "VeloxRuntime session config:" << printConfig(confMap_);
 
-  VeloxPlanConverter veloxPlanConverter(
-      inputs, memoryManager()->getLeafMemoryPool().get(), sessionConf, *localWriteFilesTempPath());
-  veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_, std::move(localFiles_));
+  // Plans reading from input iterators are bound to this task, don't look them up in the plan cache.
+  auto* planCache = inputs.empty() && !planBytes_.empty() ? VeloxBackend::get()->getPlanCache() : nullptr;
+  std::string planKey;
+  std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfoMap;
+  veloxPlan_ = nullptr;
+  if (planCache != nullptr) {
+    planKey = VeloxPlanCache::makeKey(planBytes_, sessionConf);
+    veloxPlan_ = planCache->get(planKey, localFiles_, splitInfoMap);
+  }
+
+  if (veloxPlan_ != nullptr) {
+    localFiles_.clear();
+  } else {
+    auto veloxPool = memoryManager()->getLeafMemoryPool();
+    VeloxPlanConverter veloxPlanConverter(inputs, veloxPool.get(), sessionConf, *localWriteFilesTempPath());
+    veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_, localFiles_);
+    splitInfoMap = veloxPlanConverter.splitInfos();
+    if (planCache != nullptr &&
+        VeloxPlanCache::cacheable(*veloxPlan_, veloxPlanConverter.localSplitInfos(), splitInfoMap)) {
+      // A cached plan outlives this task, so its constants must not be allocated from the task's memory pool. It's
+      // converted again into the process wide pool, once per cache miss.
+      auto cachePool = defaultLeafVeloxMemoryPool();
+      VeloxPlanConverter cachePlanConverter(inputs, cachePool.get(), sessionConf, *localWriteFilesTempPath());
+      veloxPlan_ = cachePlanConverter.toVeloxPlan(substraitPlan_, std::move(localFiles_));
+      splitInfoMap = cachePlanConverter.splitInfos();
+      planCache->put(planKey, veloxPlan_, cachePlanConverter.localSplitInfos(), splitInfoMap);
+    }
+  }
 
   // Scan node can be required.
   std::vector<std::shared_ptr<SplitInfo>> scanInfos;
@@ -148,7 +176,7 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
   std::vector<velox::core::PlanNodeId> streamIds;
 
   // Separate the scan ids and stream ids, and get the scan infos.
-  getInfoAndIds(veloxPlanConverter.splitInfos(), veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
+  getInfoAndIds(splitInfoMap, veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
 
   auto wholestageIter = std::make_unique<WholeStageResultIterator>(
       memoryManager(), veloxPlan_, scanIds, scanInfos, streamIds, spillDir, sessionConf, taskInfo_);
@@ -97,6 +97,8 @@ class VeloxRuntime final : public Runtime {
 
  private:
   std::shared_ptr<const facebook::velox::core::PlanNode> veloxPlan_;
+  // The serialized Substrait plan, kept only when the plan cache is enabled.
+  std::string planBytes_;
   std::shared_ptr<facebook::velox::config::ConfigBase> veloxCfg_;
   bool debugModeEnabled_{false};
 
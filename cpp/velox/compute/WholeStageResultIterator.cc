@@ -18,6 +18,7 @@
 #include "VeloxBackend.h"
 #include "VeloxRuntime.h"
 #include "config/VeloxConfig.h"
+#include "utils/TraceRecorder.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -189,6 +190,7 @@ std::shared_ptr<velox::core::QueryCtx> WholeStageResultIterator::createNewVeloxQ
 }
 
 std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
+  GLUTEN_TRACE_SPAN("WholeStageResultIterator::next");
   tryAddSplitsToTask();
   if (task_->isFinished()) {
     return nullptr;
@@ -207,6 +209,7 @@ std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
     VLOG(2) << "Velox task " << task_->taskId()
             << " is busy when ::next() is called. Will wait and try again. Task state: "
             << taskStateString(task_->state());
+    GLUTEN_TRACE_SPAN("WholeStageResultIterator::wait");
     future.wait();
   }
   if (vector == nullptr) {
@@ -224,6 +227,7 @@ std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
 }
 
 int64_t WholeStageResultIterator::spillFixedSize(int64_t size) {
+  GLUTEN_TRACE_SPAN("WholeStageResultIterator::spillFixedSize");
   auto pool = memoryManager_->getAggregateMemoryPool();
   std::string poolName{pool->root()->name() + "/" + pool->name()};
   std::string logPrefix{"Spill[" + poolName + "]: "};
@@ -508,6 +512,11 @@ std::unordered_map<std::string, std::string> WholeStageResultIterator::getQueryC
         std::to_string(veloxCfg_->get<bool>(kJoinSpillEnabled, true));
     configs[velox::core::QueryConfig::kOrderBySpillEnabled] =
         std::to_string(veloxCfg_->get<bool>(kOrderBySpillEnabled, true));
+    // Lets the memory arbitrator flush the writers of the partitions already written by a sorted partitioned write.
+    // Otherwise Velox's own default applies.
+    if (veloxCfg_->get<bool>(kSortedPartitionedWrite, kSortedPartitionedWriteDefault)) {
+      configs[velox::core::QueryConfig::kWriterSpillEnabled] = "true";
+    }
     configs[velox::core::QueryConfig::kMaxSpillLevel] = std::to_string(veloxCfg_->get<int32_t>(kMaxSpillLevel, 4));
     configs[velox::core::QueryConfig::kMaxSpillFileSize] =
         std::to_string(veloxCfg_->get<uint64_t>(kMaxSpillFileSize, 1L * 1024 * 1024 * 1024));
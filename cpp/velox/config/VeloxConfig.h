@@ -63,6 +63,9 @@ const std::string kBloomFilterExpectedNumItems = "spark.gluten.sql.columnar.back
 const std::string kBloomFilterNumBits = "spark.gluten.sql.columnar.backend.velox.bloomFilter.numBits";
 const std::string kBloomFilterMaxNumBits = "spark.gluten.sql.columnar.backend.velox.bloomFilter.maxNumBits";
 const std::string kVeloxSplitPreloadPerDriver = "spark.gluten.sql.columnar.backend.velox.SplitPreloadPerDriver";
+// Max number of converted plans cached per executor, 0 disables the cache.
+const std::string kVeloxPlanCacheCapacity = "spark.gluten.sql.columnar.backend.velox.planCacheCapacity";
+const uint32_t kVeloxPlanCacheCapacityDefault = 0;
 
 const std::string kShowTaskMetricsWhenFinished = "spark.gluten.sql.columnar.backend.velox.showTaskMetricsWhenFinished";
 const bool kShowTaskMetricsWhenFinishedDefault = false;
@@ -108,6 +111,10 @@ const uint32_t kVeloxIOThreadsDefault = 0;
 const std::string kVeloxAsyncTimeoutOnTaskStopping =
     "spark.gluten.sql.columnar.backend.velox.asyncTimeoutOnTaskStopping";
 const int32_t kVeloxAsyncTimeoutOnTaskStoppingDefault = 30000; // 30s
+// Threads shared by all parquet writers of the executor to encode row groups and write them to the file sink in the
+// background of the task thread, 0 keeps the writes on the task thread.
+const std::string kVeloxParquetWriteThreads = "spark.gluten.sql.columnar.backend.velox.parquetWriteThreads";
+const uint32_t kVeloxParquetWriteThreadsDefault = 0;
 
 // udf
 const std::string kVeloxUdfLibraryPaths = "spark.gluten.sql.columnar.backend.velox.internal.udfLibraryPaths";
@@ -129,6 +136,11 @@ const std::string kCachePrefetchMinPct = "spark.gluten.sql.columnar.backend.velo
 
 // write fies
 const std::string kMaxPartitions = "spark.gluten.sql.columnar.backend.velox.maxPartitionsPerWritersSession";
+// Sort the input of a dynamic partitioned write by the partition columns, so the rows of a partition reach its writer
+// together. The sort spills under the task memory pool and the buffered data of the writers can be flushed when the
+// memory is reclaimed.
+const std::string kSortedPartitionedWrite = "spark.gluten.sql.columnar.backend.velox.sortedPartitionedWrite";
+const bool kSortedPartitionedWriteDefault = false;
 
 const std::string kGlogVerboseLevel = "spark.gluten.sql.columnar.backend.velox.glogVerboseLevel";
 const uint32_t kGlogVerboseLevelDefault = 0;
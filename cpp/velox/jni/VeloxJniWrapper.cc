@@ -35,6 +35,7 @@
 #include "utils/VeloxBatchResizer.h"
 #include "velox/common/base/BloomFilter.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/vector/DecodedVector.h"
 
 #include <iostream>
 
@@ -44,6 +45,47 @@ using namespace facebook;
 namespace {
 jclass blockStripesClass;
 jmethodID blockStripesConstructor;
+
+template <typename T, typename Fn>
+void forEachLong(const velox::DecodedVector& decoded, velox::vector_size_t size, Fn&& fn) {
+  for (velox::vector_size_t row = 0; row < size; ++row) {
+    if (!decoded.isNullAt(row)) {
+      fn(row, static_cast<int64_t>(decoded.valueAt<T>(row)));
+    }
+  }
+}
+
+// Calls fn(row, value) for the non-null rows of an integral column of the batch, the values are widened to int64 like
+// the items of Spark's bloom filters.
+template <typename Fn>
+void forEachLong(const velox::RowVectorPtr& rowVector, jint columnIndex, Fn&& fn) {
+  GLUTEN_CHECK(
+      columnIndex >= 0 && columnIndex < rowVector->childrenSize(),
+      "Invalid column index " + std::to_string(columnIndex) + " for bloom-filter");
+  const auto& column = rowVector->childAt(columnIndex);
+  velox::DecodedVector decoded(*column);
+  switch (column->typeKind()) {
+    case velox::TypeKind::BIGINT:
+      forEachLong<int64_t>(decoded, column->size(), fn);
+      break;
+    case velox::TypeKind::INTEGER:
+      forEachLong<int32_t>(decoded, column->size(), fn);
+      break;
+    case velox::TypeKind::SMALLINT:
+      forEachLong<int16_t>(decoded, column->size(), fn);
+      break;
+    case velox::TypeKind::TINYINT:
+      forEachLong<int8_t>(decoded, column->size(), fn);
+      break;
+    default:
+      throw GlutenException("Bloom-filter doesn't support column type " + column->type()->toString());
+  }
+}
+
+velox::RowVectorPtr retrieveRowVector(Runtime* ctx, jlong batchHandle) {
+  auto pool = dynamic_cast<VeloxMemoryManager*>(ctx->memoryManager())->getLeafMemoryPool();
+  return VeloxColumnarBatch::from(pool.get(), ObjectStore::retrieve<ColumnarBatch>(batchHandle))->getRowVector();
+}
 } // namespace
 
 #ifdef __cplusplus
@@ -295,6 +337,81 @@ JNIEXPORT jbyteArray JNICALL Java_org_apache_gluten_utils_VeloxBloomFilterJniWra
   JNI_METHOD_END(nullptr)
 }
 
+JNIEXPORT void JNICALL Java_org_apache_gluten_utils_VeloxBloomFilterJniWrapper_insertLongs( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong handle,
+    jlongArray items) {
+  JNI_METHOD_START
+  auto filter = ObjectStore::retrieve<velox::BloomFilter<std::allocator<uint64_t>>>(handle);
+  GLUTEN_CHECK(filter->isSet(), "Bloom-filter is not initialized");
+  auto safeArray = getLongArrayElementsSafe(env, items);
+  for (jsize i = 0; i < safeArray.length(); ++i) {
+    filter->insert(folly::hasher<int64_t>()(safeArray.elems()[i]));
+  }
+  JNI_METHOD_END()
+}
+
+JNIEXPORT void JNICALL Java_org_apache_gluten_utils_VeloxBloomFilterJniWrapper_insertColumn( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong handle,
+    jlong batchHandle,
+    jint columnIndex) {
+  JNI_METHOD_START
+  auto ctx = getRuntime(env, wrapper);
+  auto filter = ObjectStore::retrieve<velox::BloomFilter<std::allocator<uint64_t>>>(handle);
+  GLUTEN_CHECK(filter->isSet(), "Bloom-filter is not initialized");
+  forEachLong(retrieveRowVector(ctx, batchHandle), columnIndex, [&](velox::vector_size_t /* row */, int64_t value) {
+    filter->insert(folly::hasher<int64_t>()(value));
+  });
+  JNI_METHOD_END()
+}
+
+JNIEXPORT jlongArray JNICALL Java_org_apache_gluten_utils_VeloxBloomFilterJniWrapper_mightContainColumn( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong handle,
+    jlong batchHandle,
+    jint columnIndex) {
+  JNI_METHOD_START
+  auto ctx = getRuntime(env, wrapper);
+  auto filter = ObjectStore::retrieve<velox::BloomFilter<std::allocator<uint64_t>>>(handle);
+  GLUTEN_CHECK(filter->isSet(), "Bloom-filter is not initialized");
+  auto rowVector = retrieveRowVector(ctx, batchHandle);
+  // One bit per row, set if the row might be contained. Null rows are never contained.
+  std::vector<uint64_t> selection(velox::bits::nwords(rowVector->size()), 0);
+  forEachLong(rowVector, columnIndex, [&](velox::vector_size_t row, int64_t value) {
+    if (filter->mayContain(folly::hasher<int64_t>()(value))) {
+      velox::bits::setBit(selection.data(), row);
+    }
+  });
+  jlongArray out = env->NewLongArray(selection.size());
+  env->SetLongArrayRegion(out, 0, selection.size(), reinterpret_cast<const jlong*>(selection.data()));
+  return out;
+  JNI_METHOD_END(nullptr)
+}
+
+JNIEXPORT void JNICALL Java_org_apache_gluten_utils_VeloxBloomFilterJniWrapper_mergeAllSerialized( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong handle,
+    jobjectArray serializedFilters) {
+  JNI_METHOD_START
+  auto to = ObjectStore::retrieve<velox::BloomFilter<std::allocator<uint64_t>>>(handle);
+  GLUTEN_CHECK(to->isSet(), "Bloom-filter is not initialized");
+  const jsize numFilters = env->GetArrayLength(serializedFilters);
+  for (jsize i = 0; i < numFilters; ++i) {
+    auto data = static_cast<jbyteArray>(env->GetObjectArrayElement(serializedFilters, i));
+    {
+      auto safeArray = getByteArrayElementsSafe(env, data);
+      to->merge(reinterpret_cast<const char*>(safeArray.elems()));
+    }
+    env->DeleteLocalRef(data);
+  }
+  JNI_METHOD_END()
+}
+
 JNIEXPORT jlong JNICALL Java_org_apache_gluten_utils_VeloxBatchResizerJniWrapper_create( // NOLINT
     JNIEnv* env,
     jobject wrapper,
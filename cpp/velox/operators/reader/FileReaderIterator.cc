@@ -18,6 +18,7 @@
 #include "operators/reader/FileReaderIterator.h"
 #include <filesystem>
 #include "operators/reader/ParquetReaderIterator.h"
+#include "operators/reader/VeloxParquetReaderIterator.h"
 
 namespace gluten {
 namespace {
@@ -34,7 +35,8 @@ std::shared_ptr<gluten::ResultIterator> FileReaderIterator::getInputIteratorFrom
     FileReaderType readerType,
     const std::string& path,
     int64_t batchSize,
-    facebook::velox::memory::MemoryPool* pool) {
+    facebook::velox::memory::MemoryPool* pool,
+    const FileReaderOptions& options) {
   std::filesystem::path input{path};
   auto suffix = input.extension().string();
   if (suffix == kParquetSuffix) {
@@ -46,6 +48,10 @@ std::shared_ptr<gluten::ResultIterator> FileReaderIterator::getInputIteratorFrom
       return std::make_shared<gluten::ResultIterator>(
           std::make_unique<ParquetBufferedReaderIterator>(path, batchSize, pool));
     }
+    if (readerType == FileReaderType::kVelox) {
+      return std::make_shared<gluten::ResultIterator>(
+          std::make_unique<VeloxParquetReaderIterator>(path, batchSize, pool, options));
+    }
   }
   throw new GlutenException("Unreachable.");
 }
@@ -17,13 +17,32 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+
 #include "compute/ResultIterator.h"
 #include "memory/ColumnarBatchIterator.h"
 #include "velox/common/memory/MemoryPool.h"
 
 namespace gluten {
 
-enum FileReaderType { kBuffered, kStream, kNone };
+enum FileReaderType { kBuffered, kStream, kVelox, kNone };
+
+// Options only honored by the Velox native reader (FileReaderType::kVelox). Defaults match the Hive connector
+// defaults set in VeloxBackend.
+struct FileReaderOptions {
+  // Names of the columns to read. Empty means all columns.
+  std::vector<std::string> columns{};
+  // Number of byte ranges (row group sets) decoded concurrently.
+  int32_t parallelism{1};
+  // Number of decoded batches buffered ahead per range.
+  int32_t prefetchBatches{2};
+  int64_t loadQuantum{256 << 20};
+  int64_t maxCoalescedBytes{64 << 20};
+  int32_t maxCoalescedDistance{512 << 10};
+  // CPU executor decoding the ranges. Null means the iterator owns a pool of `parallelism` threads. Decoding is CPU
+  // bound, don't pass an IO executor: the decoding tasks would hold the threads which prefetch the splits.
+  folly::Executor* decodeExecutor{nullptr};
+};
 
 class FileReaderIterator : public ColumnarBatchIterator {
  public:
@@ -31,7 +50,8 @@ class FileReaderIterator : public ColumnarBatchIterator {
       FileReaderType readerType,
       const std::string& path,
       int64_t batchSize,
-      facebook::velox::memory::MemoryPool* pool);
+      facebook::velox::memory::MemoryPool* pool,
+      const FileReaderOptions& options = {});
 
   explicit FileReaderIterator(const std::string& path);
 
@@ -0,0 +1,211 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operators/reader/VeloxParquetReaderIterator.h"
+
+#include <arrow/c/bridge.h>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "utils/Exception.h"
+#include "utils/VeloxArrowUtils.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/ReaderFactory.h"
+#include "velox/dwio/common/ScanSpec.h"
+
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+
+using namespace facebook;
+
+namespace gluten {
+
+VeloxParquetReaderIterator::VeloxParquetReaderIterator(
+    const std::string& path,
+    int64_t batchSize,
+    velox::memory::MemoryPool* pool,
+    const FileReaderOptions& options)
+    : FileReaderIterator(path), batchSize_(batchSize), pool_(pool), options_(options) {
+  GLUTEN_CHECK(options_.parallelism > 0, "Parallelism of VeloxParquetReaderIterator must be positive.");
+  GLUTEN_CHECK(options_.prefetchBatches > 0, "Prefetch batches of VeloxParquetReaderIterator must be positive.");
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  // Local, hdfs or s3, the same way the Hive connector resolves file systems.
+  auto fs = velox::filesystems::getFileSystem(path_, nullptr);
+  std::shared_ptr<velox::ReadFile> readFile{fs->openFileForRead(path_)};
+
+  auto firstReader = createReader(readFile);
+  fileType_ = firstReader->rowType();
+  if (options_.columns.empty()) {
+    outputType_ = fileType_;
+  } else {
+    std::vector<velox::TypePtr> types;
+    types.reserve(options_.columns.size());
+    for (const auto& name : options_.columns) {
+      types.push_back(fileType_->findChild(name));
+    }
+    outputType_ = velox::ROW(std::vector<std::string>(options_.columns), std::move(types));
+  }
+
+  // Split the file into byte ranges. The parquet row reader keeps the row groups whose first byte falls into its
+  // range, so each row group is decoded by exactly one range.
+  const uint64_t fileSize = readFile->size();
+  const uint64_t numRanges = std::max<uint64_t>(1, std::min<uint64_t>(options_.parallelism, fileSize));
+  const uint64_t rangeSize = (fileSize + numRanges - 1) / numRanges;
+  for (uint64_t i = 0; i < numRanges; ++i) {
+    auto range = std::make_unique<RangeState>();
+    range->reader = i == 0 ? std::move(firstReader) : createReader(readFile);
+
+    // The row reader updates its scan spec while reading (filter statistics and order), so ranges can't share one.
+    auto scanSpec = std::make_shared<velox::common::ScanSpec>("");
+    scanSpec->addAllChildFields(*outputType_);
+    velox::dwio::common::RowReaderOptions rowReaderOptions;
+    rowReaderOptions.setScanSpec(scanSpec);
+    rowReaderOptions.select(std::make_shared<velox::dwio::common::ColumnSelector>(fileType_, outputType_->names()));
+    rowReaderOptions.range(i * rangeSize, rangeSize);
+    range->rowReader = range->reader->createRowReader(rowReaderOptions);
+    ranges_.push_back(std::move(range));
+  }
+
+  collectBatchTime_ +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+  executor_ = options_.decodeExecutor;
+  if (executor_ == nullptr) {
+    ownedExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        std::min<size_t>(options_.parallelism, ranges_.size()),
+        std::make_shared<folly::NamedThreadFactory>("VeloxParquetReader"));
+    executor_ = ownedExecutor_.get();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& range : ranges_) {
+      maybeScheduleRange(range.get());
+    }
+  }
+  DLOG(INFO) << "VeloxParquetReaderIterator open file: " << path << ", ranges: " << ranges_.size();
+}
+
+VeloxParquetReaderIterator::~VeloxParquetReaderIterator() {
+  // A running task stops before decoding its next batch, wait for them since they use the readers.
+  std::unique_lock<std::mutex> lock(mutex_);
+  closed_ = true;
+  cv_.wait(lock, [&]() { return runningTasks_ == 0; });
+}
+
+std::unique_ptr<velox::dwio::common::Reader> VeloxParquetReaderIterator::createReader(
+    const std::shared_ptr<velox::ReadFile>& readFile) const {
+  velox::dwio::common::ReaderOptions readerOptions(pool_);
+  readerOptions.setFileFormat(velox::dwio::common::FileFormat::PARQUET);
+  readerOptions.setLoadQuantum(options_.loadQuantum);
+  readerOptions.setMaxCoalesceBytes(options_.maxCoalescedBytes);
+  readerOptions.setMaxCoalesceDistance(options_.maxCoalescedDistance);
+  return velox::dwio::common::getReaderFactory(readerOptions.fileFormat())
+      ->createReader(
+          std::make_unique<velox::dwio::common::BufferedInput>(
+              std::make_shared<velox::dwio::common::ReadFileInputStream>(readFile), *pool_),
+          readerOptions);
+}
+
+void VeloxParquetReaderIterator::maybeScheduleRange(RangeState* range) {
+  if (closed_ || range->scheduled || range->finished ||
+      range->batches.size() >= static_cast<size_t>(options_.prefetchBatches)) {
+    return;
+  }
+  range->scheduled = true;
+  ++runningTasks_;
+  executor_->add([this, range]() { decodeRange(range); });
+}
+
+void VeloxParquetReaderIterator::finishTask(RangeState* range) {
+  range->scheduled = false;
+  --runningTasks_;
+  // Notify with the lock held, the destructor may return right after the lock is released.
+  cv_.notify_all();
+}
+
+void VeloxParquetReaderIterator::decodeRange(RangeState* range) {
+  try {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || range->batches.size() >= static_cast<size_t>(options_.prefetchBatches)) {
+          finishTask(range);
+          return;
+        }
+      }
+      velox::VectorPtr result = velox::BaseVector::create(outputType_, 0, pool_);
+      if (range->rowReader->next(batchSize_, result) == 0) {
+        break;
+      }
+      if (result->size() == 0) {
+        continue;
+      }
+      // Load lazy children on the decoder thread so the decoding cost is not deferred to the consumer.
+      auto rowVector = std::dynamic_pointer_cast<velox::RowVector>(result);
+      for (auto& child : rowVector->children()) {
+        child = velox::BaseVector::loadedVectorShared(child);
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        range->batches.push_back(std::move(rowVector));
+      }
+      cv_.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    range->error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  range->finished = true;
+  finishTask(range);
+}
+
+std::shared_ptr<arrow::Schema> VeloxParquetReaderIterator::getSchema() {
+  return toArrowSchema(outputType_, pool_);
+}
+
+std::shared_ptr<gluten::ColumnarBatch> VeloxParquetReaderIterator::next() {
+  auto startTime = std::chrono::steady_clock::now();
+  velox::RowVectorPtr batch;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (currentRange_ < ranges_.size()) {
+      auto* range = ranges_[currentRange_].get();
+      cv_.wait(lock, [&]() { return !range->batches.empty() || range->finished; });
+      if (!range->batches.empty()) {
+        batch = std::move(range->batches.front());
+        range->batches.pop_front();
+        maybeScheduleRange(range);
+        break;
+      }
+      if (range->error) {
+        std::rethrow_exception(range->error);
+      }
+      ++currentRange_;
+    }
+  }
+  collectBatchTime_ +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+  if (batch == nullptr) {
+    return nullptr;
+  }
+  DLOG(INFO) << "VeloxParquetReaderIterator get a batch, num rows: " << batch->size();
+  return std::make_shared<VeloxColumnarBatch>(std::move(batch));
+}
+
+} // namespace gluten
@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "operators/reader/FileReaderIterator.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include "velox/dwio/common/Reader.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace gluten {
+
+/// Reads a parquet file through Velox's DWIO parquet reader, i.e. the same reader used by table scans in the
+/// pipeline. The file is split into `FileReaderOptions::parallelism` byte ranges; each range selects the row groups
+/// starting in it and is decoded by a task on `FileReaderOptions::decodeExecutor` into a bounded queue. A task stops when
+/// its queue is full and is rescheduled once the consumer takes a batch from it. Batches are returned in file order.
+class VeloxParquetReaderIterator final : public FileReaderIterator {
+ public:
+  VeloxParquetReaderIterator(
+      const std::string& path,
+      int64_t batchSize,
+      facebook::velox::memory::MemoryPool* pool,
+      const FileReaderOptions& options);
+
+  ~VeloxParquetReaderIterator() override;
+
+  std::shared_ptr<arrow::Schema> getSchema() override;
+
+  std::shared_ptr<gluten::ColumnarBatch> next() override;
+
+ private:
+  struct RangeState {
+    std::unique_ptr<facebook::velox::dwio::common::Reader> reader;
+    std::unique_ptr<facebook::velox::dwio::common::RowReader> rowReader;
+    std::deque<facebook::velox::RowVectorPtr> batches;
+    // A decoding task of the range is scheduled or running.
+    bool scheduled{false};
+    bool finished{false};
+    std::exception_ptr error;
+  };
+
+  std::unique_ptr<facebook::velox::dwio::common::Reader> createReader(
+      const std::shared_ptr<facebook::velox::ReadFile>& readFile) const;
+
+  // Must be called with mutex_ held.
+  void maybeScheduleRange(RangeState* range);
+
+  void decodeRange(RangeState* range);
+
+  // Must be called with mutex_ held. The task must not touch this iterator afterwards.
+  void finishTask(RangeState* range);
+
+  int64_t batchSize_;
+  facebook::velox::memory::MemoryPool* pool_;
+  FileReaderOptions options_;
+
+  facebook::velox::RowTypePtr fileType_;
+  facebook::velox::RowTypePtr outputType_;
+
+  std::unique_ptr<folly::CPUThreadPoolExecutor> ownedExecutor_;
+  folly::Executor* executor_;
+
+  std::vector<std::unique_ptr<RangeState>> ranges_;
+  size_t currentRange_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool closed_{false};
+  size_t runningTasks_{0};
+};
+
+} // namespace gluten
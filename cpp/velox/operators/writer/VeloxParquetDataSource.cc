@@ -19,9 +19,11 @@
 
 #include <arrow/buffer.h>
 #include <cstring>
+#include <mutex>
 #include <string>
 
 #include "arrow/c/bridge.h"
+#include "compute/VeloxBackend.h"
 #include "compute/VeloxRuntime.h"
 #include "config/GlutenConfig.h"
 
@@ -40,6 +42,80 @@ using namespace facebook::velox::filesystems;
 namespace gluten {
 namespace {
 const int32_t kGzipWindowBits4k = 12;
+
+// Batches and flushed row groups in flight per writer, bounds the memory held by the background writes.
+const size_t kMaxPendingWrites = 2;
+} // namespace
+
+// Hands the buffers of a flushed row group over to the executor, so writing row group N to the file overlaps with
+// encoding row group N + 1. write() is called by the encode tasks on the same executor and never blocks, the task
+// thread applies the backpressure through waitPendingWrites. An encode task waiting for a file write queued behind it
+// would deadlock a pool with a single thread.
+class AsyncFileSink : public dwio::common::FileSink {
+ public:
+  AsyncFileSink(std::unique_ptr<dwio::common::FileSink> sink, folly::Executor* executor)
+      : FileSink(sink->getName()),
+        sink_(std::move(sink)),
+        executor_(folly::SerialExecutor::create(folly::getKeepAliveToken(executor))) {}
+
+  ~AsyncFileSink() override {
+    try {
+      waitPendingWrites(0);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to write " << getName() << ": " << e.what();
+    }
+  }
+
+  bool isBuffered() const override {
+    return sink_->isBuffered();
+  }
+
+  void write(std::vector<DataBuffer<char>>& buffers) override {
+    auto owned = std::make_shared<std::vector<DataBuffer<char>>>(std::move(buffers));
+    buffers.clear();
+    for (const auto& buffer : *owned) {
+      size_ += buffer.size();
+    }
+    auto write = folly::via(executor_, [this, owned]() { sink_->write(*owned); });
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingWrites_.push_back(std::move(write));
+  }
+
+  void waitPendingWrites(size_t maxPending) {
+    while (true) {
+      folly::Future<folly::Unit> write;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pendingWrites_.size() <= maxPending) {
+          return;
+        }
+        write = std::move(pendingWrites_.front());
+        pendingWrites_.pop_front();
+      }
+      std::move(write).get();
+    }
+  }
+
+ protected:
+  void doClose() override {
+    waitPendingWrites(0);
+    sink_->close();
+  }
+
+ private:
+  std::unique_ptr<dwio::common::FileSink> sink_;
+  folly::Executor::KeepAlive<folly::SerialExecutor> executor_;
+  std::mutex mutex_;
+  std::deque<folly::Future<folly::Unit>> pendingWrites_;
+};
+
+VeloxParquetDataSource::~VeloxParquetDataSource() {
+  // The pending writes reference this data source.
+  try {
+    waitPendingWrites(0);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to write " << filePath_ << ": " << e.what();
+  }
 }
 
 void VeloxParquetDataSource::initSink(const std::unordered_map<std::string, std::string>& /* sparkConfs */) {
@@ -52,6 +128,12 @@ void VeloxParquetDataSource::initSink(const std::unordered_map<std::string, std:
 
 void VeloxParquetDataSource::init(const std::unordered_map<std::string, std::string>& sparkConfs) {
   initSink(sparkConfs);
+  if (auto* executor = VeloxBackend::get()->getParquetWriteExecutor()) {
+    writeExecutor_ = folly::SerialExecutor::create(folly::getKeepAliveToken(executor));
+    auto asyncSink = std::make_unique<AsyncFileSink>(std::move(sink_), executor);
+    asyncSink_ = asyncSink.get();
+    sink_ = std::move(asyncSink);
+  }
 
   if (sparkConfs.find(kParquetBlockSize) != sparkConfs.end()) {
     maxRowGroupBytes_ = static_cast<int64_t>(stoi(sparkConfs.find(kParquetBlockSize)->second));
@@ -121,6 +203,7 @@ void VeloxParquetDataSource::inspectSchema(struct ArrowSchema* out) {
 }
 
 void VeloxParquetDataSource::close() {
+  waitPendingWrites(0);
   if (parquetWriter_) {
     parquetWriter_->close();
   }
@@ -129,7 +212,24 @@ void VeloxParquetDataSource::close() {
 void VeloxParquetDataSource::write(const std::shared_ptr<ColumnarBatch>& cb) {
   auto veloxBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
   VELOX_DCHECK(veloxBatch != nullptr, "Write batch should be VeloxColumnarBatch");
-  parquetWriter_->write(veloxBatch->getFlattenedRowVector());
+  auto rowVector = veloxBatch->getFlattenedRowVector();
+  if (!writeExecutor_) {
+    parquetWriter_->write(rowVector);
+    return;
+  }
+  pendingWrites_.push_back(folly::via(writeExecutor_, [this, rowVector]() { parquetWriter_->write(rowVector); }));
+  waitPendingWrites(kMaxPendingWrites);
+}
+
+void VeloxParquetDataSource::waitPendingWrites(size_t maxPending) {
+  while (pendingWrites_.size() > maxPending) {
+    auto write = std::move(pendingWrites_.front());
+    pendingWrites_.pop_front();
+    std::move(write).get();
+  }
+  if (asyncSink_) {
+    asyncSink_->waitPendingWrites(maxPending);
+  }
 }
 
 } // namespace gluten
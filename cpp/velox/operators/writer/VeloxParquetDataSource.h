@@ -25,6 +25,8 @@
 #include <arrow/util/type_fwd.h>
 #include <boost/algorithm/string.hpp>
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/SerialExecutor.h>
+#include <folly/futures/Future.h>
 #include <parquet/properties.h>
 
 #include "memory/ColumnarBatch.h"
@@ -52,6 +54,8 @@
 #include "velox/dwio/parquet/writer/Writer.h"
 #include "velox/vector/ComplexVector.h"
 
+#include <deque>
+
 namespace gluten {
 
 inline bool isSupportedS3SdkPath(const std::string& filePath) {
@@ -79,6 +83,8 @@ inline bool isSupportedABFSPath(const std::string& filePath) {
   return strncmp(filePath.c_str(), "abfs:", 5) == 0 || strncmp(filePath.c_str(), "abfss:", 6) == 0;
 }
 
+class AsyncFileSink;
+
 class VeloxParquetDataSource : public VeloxDataSource {
  public:
   VeloxParquetDataSource(
@@ -88,6 +94,8 @@ class VeloxParquetDataSource : public VeloxDataSource {
       std::shared_ptr<arrow::Schema> schema)
       : VeloxDataSource(filePath, schema), filePath_(filePath), schema_(schema), pool_(std::move(veloxPool)) {}
 
+  ~VeloxParquetDataSource() override;
+
   void init(const std::unordered_map<std::string, std::string>& sparkConfs) override;
   virtual void initSink(const std::unordered_map<std::string, std::string>& sparkConfs);
   void inspectSchema(struct ArrowSchema* out) override;
@@ -109,6 +117,15 @@ class VeloxParquetDataSource : public VeloxDataSource {
   std::shared_ptr<arrow::Schema> schema_;
   std::shared_ptr<facebook::velox::parquet::Writer> parquetWriter_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
+
+  void waitPendingWrites(size_t maxPending);
+
+  // Set when VeloxBackend has a parquet write executor: the batches are encoded there in order while the task thread
+  // produces the next ones.
+  folly::Executor::KeepAlive<folly::SerialExecutor> writeExecutor_;
+  std::deque<folly::Future<folly::Unit>> pendingWrites_;
+  // Owned by parquetWriter_, set together with writeExecutor_.
+  AsyncFileSink* asyncSink_{nullptr};
 };
 
 } // namespace gluten
@@ -27,6 +27,7 @@
 #include "utils/ConfigExtractor.h"
 
 #include "config/GlutenConfig.h"
+#include "config/VeloxConfig.h"
 #include "operators/plannodes/RowVectorStream.h"
 
 namespace gluten {
@@ -641,6 +642,24 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   // Currently only support parquet format.
   dwio::common::FileFormat fileFormat = dwio::common::FileFormat::PARQUET;
 
+  // Group the rows by partition before the writer, the input columns are named differently but are in the order of the
+  // table columns.
+  auto veloxCfg =
+      std::make_unique<facebook::velox::config::ConfigBase>(std::unordered_map<std::string, std::string>(confMap_));
+  if (!partitionedKey.empty() && veloxCfg->get<bool>(kSortedPartitionedWrite, kSortedPartitionedWriteDefault)) {
+    std::vector<core::FieldAccessTypedExprPtr> sortingKeys;
+    std::vector<core::SortOrder> sortingOrders;
+    for (int i = 0; i < tableSchema.names_size(); i++) {
+      if (columnTypes[i] == ColumnType::kPartitionKey) {
+        sortingKeys.emplace_back(
+            std::make_shared<core::FieldAccessTypedExpr>(inputType->childAt(i), inputType->nameOf(i)));
+        sortingOrders.emplace_back(core::kAscNullsFirst);
+      }
+    }
+    childNode = std::make_shared<core::OrderByNode>(
+        nextPlanNodeId(), sortingKeys, sortingOrders, false /*isPartial*/, childNode);
+  }
+
   return std::make_shared<core::TableWriteNode>(
       nextPlanNodeId(),
       inputType,
@@ -18,7 +18,9 @@
 #include "JsonToProtoConverter.h"
 
 #include <filesystem>
+#include "compute/VeloxPlanCache.h"
 #include "compute/VeloxPlanConverter.h"
+#include "config/VeloxConfig.h"
 #include "substrait/SubstraitToVeloxPlan.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
@@ -277,4 +279,79 @@ TEST_F(Substrait2VeloxPlanConversionTest, filterUpper) {
       planNode->toString(true, true));
 }
 
+// A partitioned write gets an OrderBy on the partition columns in front of the TableWriteNode only if
+// sortedPartitionedWrite is enabled.
+TEST_F(Substrait2VeloxPlanConversionTest, sortedPartitionedWrite) {
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(FilePathGenerator::getDataFilePath("substrait_virtualTable.json"), substraitPlan);
+  const auto& root = substraitPlan.relations(0).root();
+  ::substrait::WriteRel writeRel;
+  *writeRel.mutable_input() = root.input();
+  auto* tableSchema = writeRel.mutable_table_schema();
+  for (const auto& name : root.names()) {
+    tableSchema->add_names(name);
+    tableSchema->add_column_types(
+        name == "c3" ? ::substrait::NamedStruct::PARTITION_COL : ::substrait::NamedStruct::NORMAL_COL);
+  }
+
+  auto toWritePlan = [&](const std::string& sorted) {
+    SubstraitToVeloxPlanConverter converter(pool(), {{kSortedPartitionedWrite, sorted}}, tmpDir_->getPath());
+    auto plan = converter.toVeloxPlan(writeRel);
+    EXPECT_NE(std::dynamic_pointer_cast<const core::TableWriteNode>(plan), nullptr);
+    return plan;
+  };
+
+  auto sortedPlan = toWritePlan("true");
+  auto orderBy = std::dynamic_pointer_cast<const core::OrderByNode>(sortedPlan->sources()[0]);
+  ASSERT_NE(orderBy, nullptr);
+  ASSERT_FALSE(orderBy->isPartial());
+  ASSERT_EQ(orderBy->sortingKeys().size(), 1);
+  ASSERT_EQ(orderBy->sortingKeys()[0]->name(), orderBy->sources()[0]->outputType()->nameOf(3));
+  ASSERT_TRUE(orderBy->sortingOrders()[0].isAscending());
+
+  auto unsortedPlan = toWritePlan("false");
+  ASSERT_EQ(std::dynamic_pointer_cast<const core::OrderByNode>(unsortedPlan->sources()[0]), nullptr);
+}
+
+// A cached plan is found by the plan and the session configs it was converted with, and its scan is rebound to the
+// local files of the task looking it up.
+TEST_F(Substrait2VeloxPlanConversionTest, planCache) {
+  ::substrait::Plan substraitPlan;
+  JsonToProtoConverter::readFromFile(FilePathGenerator::getDataFilePath("filter_upper.json"), substraitPlan);
+  ::substrait::ReadRel_LocalFiles split;
+  JsonToProtoConverter::readFromFile(FilePathGenerator::getDataFilePath("filter_upper_split.json"), split);
+  const std::vector<::substrait::ReadRel_LocalFiles> localFiles{split};
+  const auto planBytes = substraitPlan.SerializeAsString();
+
+  VeloxPlanCache cache(4);
+  const auto key = VeloxPlanCache::makeKey(planBytes, {{"a", "1"}, {"b", "2"}});
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfoMap;
+  ASSERT_EQ(cache.get(key, localFiles, splitInfoMap), nullptr);
+
+  VeloxPlanConverter converter({}, pool(), {{"a", "1"}, {"b", "2"}});
+  auto plan = converter.toVeloxPlan(substraitPlan, localFiles);
+  ASSERT_TRUE(VeloxPlanCache::cacheable(*plan, converter.localSplitInfos(), converter.splitInfos()));
+  cache.put(key, plan, converter.localSplitInfos(), converter.splitInfos());
+
+  // The order of the session configs doesn't matter.
+  ASSERT_EQ(key, VeloxPlanCache::makeKey(planBytes, {{"b", "2"}, {"a", "1"}}));
+  ASSERT_EQ(cache.get(key, localFiles, splitInfoMap), plan);
+  ASSERT_EQ(splitInfoMap.size(), 1);
+  const auto& [nodeId, splitInfo] = *splitInfoMap.begin();
+  ASSERT_EQ(nodeId, *plan->leafPlanNodeIds().begin());
+  ASSERT_NE(splitInfo, converter.splitInfos().at(nodeId));
+  ASSERT_EQ(splitInfo->paths, converter.splitInfos().at(nodeId)->paths);
+
+  // Another session config or another plan is another entry.
+  splitInfoMap.clear();
+  const auto otherConfKey = VeloxPlanCache::makeKey(planBytes, {{"a", "1"}, {"b", "3"}});
+  ASSERT_EQ(cache.get(otherConfKey, localFiles, splitInfoMap), nullptr);
+  ASSERT_EQ(cache.get(VeloxPlanCache::makeKey(planBytes, {{"a", "1"}}), localFiles, splitInfoMap), nullptr);
+  const auto otherPlanKey = VeloxPlanCache::makeKey(planBytes + " ", {{"a", "1"}, {"b", "2"}});
+  ASSERT_EQ(cache.get(otherPlanKey, localFiles, splitInfoMap), nullptr);
+  // The local files must match the scans of the cached plan.
+  ASSERT_EQ(cache.get(key, {}, splitInfoMap), nullptr);
+  ASSERT_TRUE(splitInfoMap.empty());
+}
+
 } // namespace gluten
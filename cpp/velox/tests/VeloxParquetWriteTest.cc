@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operators/writer/VeloxParquetDataSource.h"
+#include "compute/VeloxBackend.h"
+#include "config/GlutenConfig.h"
+#include "config/VeloxConfig.h"
+#include "memory/VeloxColumnarBatch.h"
+#include "velox/common/file/File.h"
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+class VeloxParquetWriteTest : public ::testing::Test, public test::VectorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    // A single thread runs both the encode tasks and the file writes they flush.
+    VeloxBackend::create({{kVeloxParquetWriteThreads, "1"}});
+    memory::MemoryManager::testingSetInstance({});
+  }
+
+  RowVectorPtr readAll(const std::string& path, const RowTypePtr& rowType) {
+    dwio::common::ReaderOptions readerOptions(pool());
+    readerOptions.setFileFormat(dwio::common::FileFormat::PARQUET);
+    auto input = std::make_unique<dwio::common::BufferedInput>(std::make_shared<LocalReadFile>(path), *pool());
+    auto reader = dwio::common::getReaderFactory(dwio::common::FileFormat::PARQUET)
+                      ->createReader(std::move(input), readerOptions);
+    auto scanSpec = std::make_shared<common::ScanSpec>("");
+    scanSpec->addAllChildFields(*rowType);
+    dwio::common::RowReaderOptions rowReaderOptions;
+    rowReaderOptions.setScanSpec(scanSpec);
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+
+    auto result = BaseVector::create<RowVector>(rowType, 0, pool());
+    VectorPtr batch = BaseVector::create(rowType, 0, pool());
+    while (rowReader->next(1000, batch)) {
+      result->append(batch.get());
+    }
+    return result;
+  }
+
+  std::shared_ptr<memory::MemoryPool> veloxPool_ = defaultLeafVeloxMemoryPool();
+};
+
+TEST_F(VeloxParquetWriteTest, writeRowGroupsOnSingleThreadExecutor) {
+  ASSERT_NE(VeloxBackend::get()->getParquetWriteExecutor(), nullptr);
+  auto tempDir = exec::test::TempDirectoryPath::create();
+  const auto path = tempDir->getPath() + "/data.parquet";
+  auto schema = arrow::schema({arrow::field("id", arrow::int64()), arrow::field("name", arrow::utf8())});
+
+  auto dataSource = std::make_shared<VeloxParquetDataSource>("file:" + path, veloxPool_, veloxPool_, schema);
+  // 100 rows per row group, each batch flushes several row groups into the sink while the next batches are queued.
+  dataSource->init({{kParquetBlockRows, "100"}});
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 10; ++i) {
+    auto ids = makeFlatVector<int64_t>(250, [i](auto row) { return i * 250 + row; });
+    auto names =
+        makeFlatVector<StringView>(250, [i](auto row) { return StringView::makeInline(std::to_string(i * 250 + row)); });
+    batches.push_back(makeRowVector({"id", "name"}, {ids, names}));
+    dataSource->write(std::make_shared<VeloxColumnarBatch>(batches.back()));
+  }
+  dataSource->close();
+
+  auto expected = BaseVector::create<RowVector>(batches[0]->type(), 0, pool());
+  for (const auto& batch : batches) {
+    expected->append(batch.get());
+  }
+  auto actual = readAll(path, asRowType(batches[0]->type()));
+  ASSERT_EQ(actual->size(), 2500);
+  test::assertEqualVectors(expected, actual);
+}
+
+} // namespace gluten
@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.gluten.metrics;
+
+import org.apache.gluten.runtime.Runtime;
+import org.apache.gluten.runtime.RuntimeJniWrapper;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.TreeMap;
+
+/**
+ * The named counters and histograms registered by the native components of a runtime, decoded from
+ * the buffer laid out by MetricsRegistry::serialize in cpp/core/utils/MetricsRegistry.h.
+ */
+public class RegistryMetrics {
+  private static final int SUB_BUCKET_BITS = 3;
+  private static final int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+  /** A snapshot of a native log-linear histogram, only its non-empty buckets are kept. */
+  public static class Histogram {
+    private final long count;
+    private final long sum;
+    private final long min;
+    private final long max;
+    private final TreeMap<Integer, Long> buckets;
+
+    Histogram(long count, long sum, long min, long max, TreeMap<Integer, Long> buckets) {
+      this.count = count;
+      this.sum = sum;
+      this.min = min;
+      this.max = max;
+      this.buckets = buckets;
+    }
+
+    public long count() {
+      return count;
+    }
+
+    public long sum() {
+      return sum;
+    }
+
+    public long min() {
+      return min;
+    }
+
+    public long max() {
+      return max;
+    }
+
+    /** The lower bound of the bucket holding the value at the percentile, 0 to 100. */
+    public long percentile(double percentile) {
+      if (count == 0) {
+        return 0;
+      }
+      long rank = Math.max(1, (long) (percentile / 100 * count + 0.5));
+      long seen = 0;
+      for (Map.Entry<Integer, Long> bucket : buckets.entrySet()) {
+        seen += bucket.getValue();
+        if (seen >= rank) {
+          return Math.max(bucketLowerBound(bucket.getKey()), min);
+        }
+      }
+      return max;
+    }
+
+    static long bucketLowerBound(int bucket) {
+      if (bucket < SUB_BUCKETS) {
+        return bucket;
+      }
+      int shift = bucket / SUB_BUCKETS - 1;
+      int subBucket = bucket % SUB_BUCKETS;
+      return ((long) (SUB_BUCKETS + subBucket)) << shift;
+    }
+  }
+
+  private final Map<String, Long> counters;
+  private final Map<String, Histogram> histograms;
+
+  private RegistryMetrics(Map<String, Long> counters, Map<String, Histogram> histograms) {
+    this.counters = counters;
+    this.histograms = histograms;
+  }
+
+  /** Fetches the metrics recorded by the native components created through the runtime. */
+  public static RegistryMetrics fetch(Runtime runtime) {
+    return decode(RuntimeJniWrapper.fetchRegistryMetrics(runtime.getHandle()));
+  }
+
+  public static RegistryMetrics decode(byte[] bytes) {
+    ByteBuffer buffer = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN);
+    Map<String, Long> counters = new HashMap<>();
+    int numCounters = buffer.getInt();
+    for (int i = 0; i < numCounters; i++) {
+      String name = readName(buffer);
+      counters.put(name, buffer.getLong());
+    }
+    Map<String, Histogram> histograms = new HashMap<>();
+    int numHistograms = buffer.getInt();
+    for (int i = 0; i < numHistograms; i++) {
+      String name = readName(buffer);
+      long count = buffer.getLong();
+      long sum = buffer.getLong();
+      long min = buffer.getLong();
+      long max = buffer.getLong();
+      TreeMap<Integer, Long> buckets = new TreeMap<>();
+      int numNonEmptyBuckets = buffer.getShort();
+      for (int j = 0; j < numNonEmptyBuckets; j++) {
+        int bucket = buffer.getShort();
+        buckets.put(bucket, buffer.getLong());
+      }
+      histograms.put(name, new Histogram(count, sum, min, max, buckets));
+    }
+    return new RegistryMetrics(
+        Collections.unmodifiableMap(counters), Collections.unmodifiableMap(histograms));
+  }
+
+  private static String readName(ByteBuffer buffer) {
+    byte[] name = new byte[buffer.getShort()];
+    buffer.get(name);
+    return new String(name, StandardCharsets.UTF_8);
+  }
+
+  /** The counter of the name, or null if no native component registered it. */
+  public Long counter(String name) {
+    return counters.get(name);
+  }
+
+  /** The histogram of the name, or null if no native component registered it. */
+  public Histogram histogram(String name) {
+    return histograms.get(name);
+  }
+}
@@ -23,4 +23,10 @@ public class RuntimeJniWrapper {
   public static native long createRuntime(String backendType, long nmm, byte[] sessionConf);
 
   public static native void releaseRuntime(long handle);
+
+  /**
+   * Fetches the named counters and histograms registered by the native components of the runtime,
+   * serialized in the compact layout documented in cpp/core/utils/MetricsRegistry.h.
+   */
+  public static native byte[] fetchRegistryMetrics(long handle);
 }